@@ -95,7 +95,7 @@ class NameConf : public o2::conf::ConfigurableParamHelper<NameConf>
   static constexpr std::string_view CTFTREENAME = "ctf"; // hardcoded
 
   // CTF Filename
-  static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf");
+  static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf", const std::string_view ext = ROOT_EXT_STRING);
 
   // CTF Dictionary
   static std::string getCTFDictFileName();
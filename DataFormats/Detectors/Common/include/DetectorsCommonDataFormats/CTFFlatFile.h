@@ -0,0 +1,129 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.h
+/// \brief Indexed flat file container of CTFs which can be memory-mapped and read w/o deserialization
+
+#ifndef _ALICEO2_CTFFLATFILE_H
+#define _ALICEO2_CTFFLATFILE_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+/// The file starts with the CTFFlatFileHeader, followed by the EncodedBlocks images of the detectors, each one
+/// starting at the offset aligned to o2::ctf::Alignment, and is closed by the index of the CTFs it contains.
+/// Since the EncodedBlocks images are flat, the detector payload can be used directly from the mapped file.
+/// Note that sending it with DPL still copies it once to the shared memory when the shmem transport is used.
+struct CTFFlatFileHeader {
+  static constexpr std::array<char, 8> Magic{'O', '2', 'C', 'T', 'F', 'F', 'L', 'T'};
+  static constexpr uint32_t Version = 1;
+  std::array<char, 8> magic = Magic;
+  uint32_t version = Version;
+  uint32_t nCTFs = 0;       // number of CTFs in the file
+  uint64_t indexOffset = 0; // offset of the index, 0 if the file was not closed properly
+  uint64_t reserved = 0;
+};
+
+/// index record of a single CTF
+struct CTFFlatFileEntry {
+  uint64_t run = 0;
+  uint64_t creationTime = 0;
+  uint32_t firstTForbit = 0;
+  uint32_t tfCounter = 0;
+  uint64_t detectors = 0; // mask of the stored detectors
+  std::array<uint64_t, o2::detectors::DetID::nDetectors> offset{};
+  std::array<uint64_t, o2::detectors::DetID::nDetectors> size{};
+
+  CTFHeader getCTFHeader() const;
+};
+
+class CTFFlatFileWriter
+{
+ public:
+  using DetID = o2::detectors::DetID;
+  static constexpr std::string_view FileExtension = "ctf";
+
+  CTFFlatFileWriter() = default;
+  CTFFlatFileWriter(const CTFFlatFileWriter&) = delete;
+  CTFFlatFileWriter& operator=(const CTFFlatFileWriter&) = delete;
+  ~CTFFlatFileWriter();
+
+  void open(const std::string& fileName);
+  void close();
+  bool isOpen() const { return mFD != -1; }
+  const std::string& getFileName() const { return mFileName; }
+  size_t getNCTFs() const { return mIndex.size(); }
+  size_t getSize() const { return mOffset; }
+
+  /// write detector payload (EncodedBlocks image) of the current CTF, returns number of bytes written
+  size_t addDetector(DetID det, const void* data, size_t size);
+  /// register the CTF with all detectors added since the previous call, returns number of bytes written
+  size_t addCTF(const CTFHeader& header);
+
+ private:
+  void writeAt(const void* data, size_t size, uint64_t offset);
+  size_t pad();
+
+  int mFD = -1;
+  uint64_t mOffset = 0;
+  CTFFlatFileEntry mCurrent{};
+  std::vector<CTFFlatFileEntry> mIndex{};
+  std::string mFileName{};
+};
+
+class CTFFlatFileReader
+{
+ public:
+  using DetID = o2::detectors::DetID;
+
+  CTFFlatFileReader() = default;
+  CTFFlatFileReader(const std::string& fileName) { open(fileName); }
+
+  void open(const std::string& fileName);
+  void close();
+  bool isOpen() const { return mMapping != nullptr; }
+  const std::string& getFileName() const { return mFileName; }
+  size_t getNCTFs() const { return mNCTFs; }
+  CTFHeader getCTFHeader(size_t ctf) const { return getEntry(ctf).getCTFHeader(); }
+  bool hasDetector(size_t ctf, DetID det) const { return getEntry(ctf).size[det] != 0; }
+  /// pointer on the detector payload of the CTF in the mapped file and its size
+  const char* getDetectorData(size_t ctf, DetID det, size_t& size) const;
+  /// ask kernel to read ahead the payload of the CTF
+  void prefetch(size_t ctf) const;
+  /// shared ownership of the mapping, to keep it valid as long as the data is used by someone else
+  std::shared_ptr<const char> getMapping() const { return mMapping; }
+
+  static bool isFlatFile(const std::string& fileName);
+
+ private:
+  const CTFFlatFileEntry& getEntry(size_t ctf) const;
+
+  std::shared_ptr<const char> mMapping{};
+  const CTFFlatFileEntry* mIndex = nullptr;
+  size_t mNCTFs = 0;
+  size_t mSize = 0;
+  std::string mFileName{};
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
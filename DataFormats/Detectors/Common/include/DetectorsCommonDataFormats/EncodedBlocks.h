@@ -20,6 +20,8 @@
 #include <cassert>
 #include <type_traits>
 #include <cstddef>
+#include <functional>
+#include <memory>
 #include <Rtypes.h>
 #include "rANS/rans.h"
 #include "rANS/utils.h"
@@ -91,8 +93,33 @@ inline size_t calculatePaddedSize(size_t nElems) noexcept
   return (sizeOfDestT / sizeOfSourceT) * calculateNDestTElements<source_T, dest_T>(nElems);
 };
 
+/// execute independent jobs on up to nThreads threads of the shared (OpenMP) pool, sequentially if threading is not available
+void runConcurrently(const std::vector<std::function<void()>>& jobs, int nThreads);
+
 ///>>======================== Auxiliary classes =======================>>
 
+/// minor ANS version from which on blocks may be encoded with more than 2 interleaved rANS states (see Metadata::nStreams)
+constexpr uint8_t ANSMinorVersionInterleaved = 2;
+/// minor ANS version from which on blocks may be split to independently decodable chunks (see Metadata::chunkSize)
+constexpr uint8_t ANSMinorVersionChunked = 3;
+
+/// range [first, last) of symbols of the message stored in a block
+struct MessageRange {
+  size_t first = 0;
+  size_t last = 0;
+  size_t size() const { return last - first; }
+};
+
+/// external encoder of a block or, without one, optionally the symbol statistics of the message already collected by the
+/// caller (e.g. to choose the encoder), from which the block dictionary is then built without histogramming the message again
+struct ExternalEncoder {
+  ExternalEncoder() = default;
+  ExternalEncoder(const void* enc) : encoder(enc) {}
+  ExternalEncoder(std::shared_ptr<const rans::FrequencyTable> freq) : frequencyTable(std::move(freq)) {}
+  const void* encoder = nullptr;
+  std::shared_ptr<const rans::FrequencyTable> frequencyTable{};
+};
+
 struct ANSHeader {
   uint8_t majorVersion;
   uint8_t minorVersion;
@@ -120,6 +147,12 @@ struct Metadata {
   int nDictWords = 0;
   int nDataWords = 0;
   int nLiteralWords = 0;
+  uint8_t nStreams = 0; // number of interleaved rANS states, 0 for the default 2-states coder
+  uint32_t chunkSize = 0; // number of symbols per independently decodable chunk, 0 if the message is a single rANS stream
+
+  /// number of independently decodable rANS streams of the block. For chunked blocks the data ends with the chunk index:
+  /// nChunks offsets of the ends of the chunks streams wrt the data start, followed by nChunks cumulative literals counts
+  size_t getNChunks() const { return chunkSize ? (messageLength + chunkSize - 1) / chunkSize : 1; }
 
   void clear()
   {
@@ -133,8 +166,10 @@ struct Metadata {
     nDictWords = 0;
     nDataWords = 0;
     nLiteralWords = 0;
+    nStreams = 0;
+    chunkSize = 0;
   }
-  ClassDefNV(Metadata, 2);
+  ClassDefNV(Metadata, 4);
 };
 
 /// registry struct for the buffer start and offsets of writable space
@@ -329,6 +364,18 @@ struct Block {
   ClassDefNV(Block, 1);
 }; // namespace ctf
 
+/// standalone storage of a single encoded slot, filled independently of the flat container (see EncodedBlocks::encodeBatch)
+template <typename W = uint32_t>
+struct SlotBuffer {
+  Metadata md;
+  std::vector<W> dict;
+  std::vector<W> data;
+  std::vector<W> literals;
+
+  /// size in bytes this slot will occupy in the flat container
+  size_t estimateSize() const { return Block<W>::estimateSize(dict.size() + data.size() + literals.size()); }
+};
+
 ///<<======================== Auxiliary classes =======================<<
 
 template <typename H, int N, typename W = uint32_t>
@@ -432,14 +479,49 @@ class EncodedBlocks
 
   /// encode vector src to bloc at provided slot
   template <typename VE, typename buffer_T>
-  inline void encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f)
+  inline void encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, ExternalEncoder encoderExt = {}, float memfc = 1.f, int nStreams = 0, size_t chunkSize = 0)
   {
-    encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc);
+    encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc, nStreams, chunkSize);
   }
 
-  /// encode vector src to bloc at provided slot
+  /// encode vector src to bloc at provided slot, nStreams > 2 requests the interleaved rANS coder with this number of states,
+  /// chunkSize > 0 splits the message to independently decodable chunks of this number of symbols
   template <typename input_IT, typename buffer_T>
-  void encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const void* encoderExt = nullptr, float memfc = 1.f);
+  void encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, ExternalEncoder encoderExt = {}, float memfc = 1.f, int nStreams = 0, size_t chunkSize = 0);
+
+  /// encode source message to standalone slot storage, does not require the flat container and may run concurrently for different slots
+  template <typename input_IT>
+  static void encodeSlot(const input_IT srcBegin, const input_IT srcEnd, SlotBuffer<W>& dest, uint8_t symbolTablePrecision, Metadata::OptStore opt, ExternalEncoder encoderExt = {}, float memfc = 1.f, int nStreams = 0, size_t chunkSize = 0);
+
+  /// set of per-slot encoding requests to be processed concurrently by encodeBatch
+  class EncodeBatch
+  {
+   public:
+    template <typename VE>
+    void add(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, ExternalEncoder encoderExt = {}, float memfc = 1.f, int nStreams = 0, size_t chunkSize = 0)
+    {
+      add(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, encoderExt, memfc, nStreams, chunkSize);
+    }
+
+    template <typename input_IT>
+    void add(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, ExternalEncoder encoderExt = {}, float memfc = 1.f, int nStreams = 0, size_t chunkSize = 0)
+    {
+      assert(slot < N);
+      mJobs[slot] = [=](SlotBuffer<W>& dest) { encodeSlot(srcBegin, srcEnd, dest, symbolTablePrecision, opt, encoderExt, memfc, nStreams, chunkSize); };
+    }
+
+   private:
+    std::array<std::function<void(SlotBuffer<W>&)>, N> mJobs; // slots w/o job are stored as empty
+    friend class EncodedBlocks;
+  };
+
+  /// encode all slots of the batch concurrently on nThreads and store them compactly in the flat container created in the buffer (vector)
+  template <typename buffer_T>
+  static void encodeBatch(buffer_T& buffer, const EncodeBatch& batch, int nThreads = 1);
+
+  /// store standalone encoded slot in the next free block, expanding the buffer (vector) if needed
+  template <typename buffer_T>
+  static void storeSlot(buffer_T& buffer, int slot, const SlotBuffer<W>& src);
 
   /// decode block at provided slot to destination vector (will be resized as needed)
   template <class container_T, class container_IT = typename container_T::iterator>
@@ -449,6 +531,50 @@ class EncodedBlocks
   template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
   void decode(D_IT dest, int slot, const void* decoderExt = nullptr) const;
 
+  /// decode the range of symbols of the block at provided slot to destination vector (will be resized to the range size),
+  /// for chunked blocks only the chunks overlapping with the range are decoded
+  template <class container_T, class container_IT = typename container_T::iterator>
+  void decode(container_T& dest, int slot, MessageRange range, const void* decoderExt = nullptr) const;
+
+  /// decode the range of symbols of the block at provided slot to destination pointer, the needed space assumed to be available
+  template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
+  void decode(D_IT dest, int slot, MessageRange range, const void* decoderExt = nullptr) const;
+
+  /// set of per-slot decoding requests to be processed concurrently by decodeBatch
+  class DecodeBatch
+  {
+   public:
+    /// decode to destination vector (will be resized as needed)
+    template <class container_T>
+    void add(container_T& dest, int slot, const void* decoderExt = nullptr)
+    {
+      mJobs.emplace_back([&dest, slot, decoderExt](const EncodedBlocks& eb) { eb.decode(dest, slot, decoderExt); });
+    }
+
+    /// decode to destination pointer, the needed space assumed to be available
+    template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
+    void add(D_IT dest, int slot, const void* decoderExt = nullptr)
+    {
+      mJobs.emplace_back([dest, slot, decoderExt](const EncodedBlocks& eb) { eb.decode(dest, slot, decoderExt); });
+    }
+
+    /// decode symbols range to destination pointer, e.g. to decode disjoint ranges of the same slot concurrently
+    template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
+    void add(D_IT dest, int slot, MessageRange range, const void* decoderExt = nullptr)
+    {
+      mJobs.emplace_back([dest, slot, range, decoderExt](const EncodedBlocks& eb) { eb.decode(dest, slot, range, decoderExt); });
+    }
+
+    size_t size() const { return mJobs.size(); }
+
+   private:
+    std::vector<std::function<void(const EncodedBlocks&)>> mJobs;
+    friend class EncodedBlocks;
+  };
+
+  /// decode all slots of the batch concurrently on nThreads
+  void decodeBatch(const DecodeBatch& batch, int nThreads = 1) const;
+
   /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
   static std::vector<char> createDictionaryBlocks(const std::vector<o2::rans::FrequencyTable>& vfreq, const std::vector<Metadata>& prbits);
 
@@ -484,6 +610,82 @@ class EncodedBlocks
   /// Create its own flat copy in the destination empty flat object
   void fillFlatCopy(EncodedBlocks& dest) const;
 
+  /// effective chunk size stored in the metadata: messages fitting to a single chunk are not chunked
+  static size_t getEffectiveChunkSize(size_t messageLength, size_t chunkSize) { return messageLength > chunkSize ? chunkSize : 0; }
+
+  /// upper limit on the words added to the encoded message by its chunking: flushed states and the chunk index
+  static size_t estimateChunkingOverhead(size_t messageLength, size_t chunkSize, int nStreams)
+  {
+    const size_t nChunks = chunkSize ? (messageLength + chunkSize - 1) / chunkSize : 0;
+    return nChunks * (2 * std::max(nStreams, 2) + 2);
+  }
+
+  /// entropy-encode message as a single stream or, if chunkSize>0, as a sequence of independent chunks followed by the chunk index
+  template <typename encoder_T, typename input_IT, typename output_IT, typename literals_T>
+  static output_IT encodeMessage(const encoder_T& encoder, int nStreams, size_t chunkSize, const input_IT srcBegin, const input_IT srcEnd, output_IT dest, literals_T& literals)
+  {
+    const size_t messageLength = std::distance(srcBegin, srcEnd);
+    if (!chunkSize) {
+      return encodeStream(encoder, nStreams, srcBegin, srcEnd, dest, literals);
+    }
+    const size_t nChunks = (messageLength + chunkSize - 1) / chunkSize;
+    std::vector<W> index(2 * nChunks);
+    auto chunkBegin = srcBegin;
+    auto out = dest;
+    for (size_t ic = 0; ic < nChunks; ic++) {
+      auto chunkEnd = chunkBegin;
+      std::advance(chunkEnd, std::min(chunkSize, messageLength - ic * chunkSize));
+      const auto streamEnd = encodeStream(encoder, nStreams, chunkBegin, chunkEnd, out, literals);
+      index[ic] = static_cast<W>(std::distance(dest, streamEnd));
+      index[nChunks + ic] = static_cast<W>(literals.size());
+      out = std::prev(streamEnd); // the encoder starts writing after the provided position
+      chunkBegin = chunkEnd;
+    }
+    for (auto w : index) {
+      *(++out) = w;
+    }
+    return ++out;
+  }
+
+  /// entropy-encode message with requested number of interleaved rANS streams
+  template <typename encoder_T, typename input_IT, typename output_IT, typename literals_T>
+  static output_IT encodeStream(const encoder_T& encoder, int nStreams, const input_IT srcBegin, const input_IT srcEnd, output_IT dest, literals_T& literals)
+  {
+    switch (nStreams) {
+      case 4:
+        return encoder.template processInterleaved<4>(srcBegin, srcEnd, dest, literals);
+      case 8:
+        return encoder.template processInterleaved<8>(srcBegin, srcEnd, dest, literals);
+      case 16:
+        return encoder.template processInterleaved<16>(srcBegin, srcEnd, dest, literals);
+      default:
+        return encoder.process(srcBegin, srcEnd, dest, literals);
+    }
+  }
+
+  /// entropy-decode single rANS stream ending at inputEnd with the number of interleaved rANS states it was encoded with
+  template <typename decoder_T, typename stream_IT, typename D_IT, typename literals_T>
+  static void decodeStream(const decoder_T& decoder, int nStreams, stream_IT inputEnd, D_IT dest, size_t messageLength, literals_T& literals)
+  {
+    switch (nStreams) {
+      case 0:
+      case 2:
+        decoder.process(inputEnd, dest, messageLength, literals);
+        break;
+      case 4:
+        decoder.template processInterleaved<4>(inputEnd, dest, messageLength, literals);
+        break;
+      case 8:
+        decoder.template processInterleaved<8>(inputEnd, dest, messageLength, literals);
+        break;
+      case 16:
+        decoder.template processInterleaved<16>(inputEnd, dest, messageLength, literals);
+        break;
+      default:
+        throw std::runtime_error(fmt::format("unsupported number {} of interleaved rANS streams", nStreams));
+    }
+  }
+
   /// add and fill single branch
   template <typename D>
   static size_t fillTreeBranch(TTree& tree, const std::string& brname, D& dt, int compLevel, int splitLevel = 99);
@@ -761,11 +963,34 @@ inline void EncodedBlocks<H, N, W>::decode(container_T& dest,            // dest
   decode(std::begin(dest), slot, decoderExt);
 }
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
+inline void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to destination
+                                           int slot,                     // slot of the block to decode
+                                           const void* decoderExt) const // optional externally provided decoder
+{
+  decode(dest, slot, MessageRange{0, mMetadata[slot].messageLength}, decoderExt);
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <class container_T, class container_IT>
+inline void EncodedBlocks<H, N, W>::decode(container_T& dest,            // destination container
+                                           int slot,                     // slot of the block to decode
+                                           MessageRange range,           // range of symbols to decode
+                                           const void* decoderExt) const // optional externally provided decoder
+{
+  dest.resize(range.size()); // allocate output buffer
+  decode(std::begin(dest), slot, range, decoderExt);
+}
+
 ///_____________________________________________________________________________
 template <typename H, int N, typename W>
 template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
 void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to destination
                                     int slot,                     // slot of the block to decode
+                                    MessageRange range,           // range of symbols to decode
                                     const void* decoderExt) const // optional externally provided decoder
 {
   // get references to the right data
@@ -774,8 +999,12 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
 
   using dest_t = typename std::iterator_traits<D_IT>::value_type;
 
+  if (range.first > range.last || range.last > md.messageLength) {
+    throw std::runtime_error(fmt::format("requested range [{}:{}) is outside of the message of length {} in slot {}", range.first, range.last, md.messageLength, slot));
+  }
+
   // decode
-  if (block.getNStored()) {
+  if (block.getNStored() && range.size()) {
     if (md.opt == Metadata::OptStore::EENCODE) {
       if (!decoderExt && !block.getNDict()) {
         LOG(error) << "Dictionaty is not saved for slot " << slot << " and no external decoder is provided";
@@ -793,21 +1022,40 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
           throw std::runtime_error("Mismatch between min symbol in metadata and the one in external decoder");
         }
       }
-      // load incompressible symbols if they existed
-      std::vector<dest_t> literals;
-      if (block.getNLiterals()) {
-        // note: here we have to use md.nLiterals (original number of literal words) rather than md.nLiteralWords == block.getNLiterals()
-        // (number of W-words in the EncodedBlock occupied by literals) as we cast literals stored in W-word array
-        // to D-word array
-        literals = std::vector<dest_t>{reinterpret_cast<const dest_t*>(block.getLiterals()), reinterpret_cast<const dest_t*>(block.getLiterals()) + md.nLiterals};
+      if (md.nStreams && !rans::isValidNInterleavedStreams(md.nStreams)) {
+        LOG(error) << "Unsupported number " << int(md.nStreams) << " of interleaved rANS streams for slot " << slot;
+        throw std::runtime_error("Unsupported number of interleaved rANS streams");
+      }
+      // note: literals are counted in md.nLiterals original words rather than in md.nLiteralWords == block.getNLiterals()
+      // (number of W-words in the EncodedBlock occupied by literals) as we cast literals stored in W-word array to D-word array
+      const auto* literalsBegin = reinterpret_cast<const dest_t*>(block.getLiterals());
+      const auto* data = block.getData();
+      const size_t nChunks = md.getNChunks();
+      const W* chunkIndex = data + block.getNData() - 2 * nChunks; // valid only for chunked blocks
+      const size_t chunkSize = md.chunkSize ? md.chunkSize : md.messageLength;
+
+      std::vector<dest_t> literals, tmp;
+      for (size_t ic = range.first / chunkSize; ic < nChunks && ic * chunkSize < range.last; ic++) {
+        const size_t chunkFirst = ic * chunkSize, chunkLast = std::min(chunkFirst + chunkSize, md.messageLength);
+        const auto* inputEnd = md.chunkSize ? data + chunkIndex[ic] : data + block.getNData();
+        // load incompressible symbols of the chunk if they existed
+        if (block.getNLiterals()) {
+          const size_t litFirst = (md.chunkSize && ic) ? chunkIndex[nChunks + ic - 1] : 0;
+          const size_t litLast = md.chunkSize ? chunkIndex[nChunks + ic] : md.nLiterals;
+          literals.assign(literalsBegin + litFirst, literalsBegin + litLast);
+        }
+        if (chunkFirst >= range.first && chunkLast <= range.last) { // chunk is fully requested, decode directly to destination
+          decodeStream(*decoder, md.nStreams, inputEnd, dest, chunkLast - chunkFirst, literals);
+          std::advance(dest, chunkLast - chunkFirst);
+        } else {
+          tmp.resize(chunkLast - chunkFirst);
+          decodeStream(*decoder, md.nStreams, inputEnd, tmp.begin(), tmp.size(), literals);
+          dest = std::copy(tmp.begin() + (std::max(range.first, chunkFirst) - chunkFirst), tmp.begin() + (std::min(range.last, chunkLast) - chunkFirst), dest);
+        }
       }
-      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
     } else { // data was stored as is
-      using destPtr_t = typename std::iterator_traits<D_IT>::pointer;
-      destPtr_t srcBegin = reinterpret_cast<destPtr_t>(block.payload);
-      destPtr_t srcEnd = srcBegin + md.messageLength * sizeof(dest_t);
-      std::copy(srcBegin, srcEnd, dest);
-      // std::memcpy(dest, block.payload, md.messageLength * sizeof(dest_t));
+      const auto* srcBegin = reinterpret_cast<const dest_t*>(block.payload);
+      std::copy(srcBegin + range.first, srcBegin + range.last, dest);
     }
   }
 }
@@ -821,8 +1069,10 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
                                     uint8_t symbolTablePrecision, // encoding into
                                     Metadata::OptStore opt,       // option for data compression
                                     buffer_T* buffer,             // optional buffer (vector) providing memory for encoded blocks
-                                    const void* encoderExt,       // optional external encoder
-                                    float memfc)                  // memory allocation margin factor
+                                    ExternalEncoder encoderExt,   // optional external encoder or precomputed statistics
+                                    float memfc,                  // memory allocation margin factor
+                                    int nStreams,                 // number of interleaved rANS states, 0 for default
+                                    size_t chunkSize)             // number of symbols per independently decodable chunk, 0 for no chunking
 {
 
   using storageBuffer_t = W;
@@ -839,6 +1089,13 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
   assert(slot == mRegistry.nFilledBlocks);
   mRegistry.nFilledBlocks++;
 
+  if (nStreams && !rans::isValidNInterleavedStreams(nStreams)) {
+    throw std::runtime_error(fmt::format("unsupported number {} of interleaved rANS streams requested for slot {}", nStreams, slot));
+  }
+  if (opt == Metadata::OptStore::EENCODE && nStreams > 2 && mANSHeader.minorVersion < ANSMinorVersionInterleaved) {
+    mANSHeader.minorVersion = ANSMinorVersionInterleaved; // old decoders must not attempt to decode interleaved blocks
+  }
+
   const size_t messageLength = std::distance(srcBegin, srcEnd);
   // cover three cases:
   // * empty source message: no entropy coding
@@ -877,20 +1134,22 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
     const float SizeEstMarginRel = 1.5 * memfc;
 
     const auto [inplaceEncoder, frequencyTable] = [&]() {
-      if (encoderExt) {
+      if (encoderExt.encoder) {
         return std::make_tuple(ransEncoder_t{}, rans::FrequencyTable{});
       } else {
-        rans::FrequencyTable frequencyTable = rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
+        rans::FrequencyTable frequencyTable = encoderExt.frequencyTable ? *encoderExt.frequencyTable : rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
         RenormedFrequencyTable renormedFrequencyTable = rans::renorm(frequencyTable, symbolTablePrecision);
         return std::make_tuple(ransEncoder_t{renormedFrequencyTable}, frequencyTable);
       }
     }();
-    ransEncoder_t const* const encoder = encoderExt ? reinterpret_cast<ransEncoder_t const* const>(encoderExt) : &inplaceEncoder;
+    ransEncoder_t const* const encoder = encoderExt.encoder ? reinterpret_cast<ransEncoder_t const* const>(encoderExt.encoder) : &inplaceEncoder;
 
     // estimate size of encode buffer
     int dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t)); // size in bytes
     // preliminary expansion of storage based on dict size + estimated size of encode buffer
     dataSize = SizeEstMarginAbs + int(SizeEstMarginRel * (dataSize / sizeof(storageBuffer_t))) + (sizeof(input_t) < sizeof(storageBuffer_t)); // size in words of output stream
+    chunkSize = getEffectiveChunkSize(messageLength, chunkSize);
+    dataSize += estimateChunkingOverhead(messageLength, chunkSize, nStreams);
     expandStorage(frequencyTable.size() + dataSize);
     // store dictionary first
     if (!frequencyTable.empty()) {
@@ -902,7 +1161,7 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
     // directly encode source message into block buffer.
     storageBuffer_t* const blockBufferBegin = thisBlock->getCreateData();
     const size_t maxBufferSize = thisBlock->registry->getFreeSize(); // note: "this" might be not valid after expandStorage call!!!
-    const auto encodedMessageEnd = encoder->process(srcBegin, srcEnd, blockBufferBegin, literals);
+    const auto encodedMessageEnd = encodeMessage(*encoder, nStreams, chunkSize, srcBegin, srcEnd, blockBufferBegin, literals);
     rans::utils::checkBounds(encodedMessageEnd, blockBufferBegin + maxBufferSize / sizeof(W));
     dataSize = encodedMessageEnd - thisBlock->getDataPointer();
     thisBlock->setNData(dataSize);
@@ -939,7 +1198,13 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
                              encoder->getMaxSymbol(),
                              static_cast<int32_t>(frequencyTable.size()),
                              dataSize,
-                             static_cast<int32_t>(nLiteralWords)};
+                             static_cast<int32_t>(nLiteralWords),
+                             static_cast<uint8_t>(nStreams > 2 ? nStreams : 0),
+                             static_cast<uint32_t>(chunkSize)};
+    auto* blockHead = get(thisBlock->registry->head); // "this" might be invalid after expandStorage call
+    if (chunkSize && blockHead->mANSHeader.minorVersion < ANSMinorVersionChunked) {
+      blockHead->mANSHeader.minorVersion = ANSMinorVersionChunked; // old decoders must not attempt to decode chunked blocks
+    }
   } else { // store original data w/o EEncoding
     // FIXME(milettri): we should be able to do without an intermediate vector;
     //  provided iterator is not necessarily pointer, need to use intermediate vector!!!
@@ -951,12 +1216,186 @@ void EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,      // iterator be
 
     const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
     expandStorage(nBufferElems);
-    thisBlock->storeData(thisMetadata->nDataWords, reinterpret_cast<const storageBuffer_t*>(tmp.data()));
+    thisBlock->storeData(nBufferElems, reinterpret_cast<const storageBuffer_t*>(tmp.data()));
 
     *thisMetadata = Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
   }
 }
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename input_IT>
+void EncodedBlocks<H, N, W>::encodeSlot(const input_IT srcBegin,      // iterator begin of source message
+                                        const input_IT srcEnd,        // iterator end of source message
+                                        SlotBuffer<W>& dest,          // standalone storage to fill
+                                        uint8_t symbolTablePrecision, // encoding into
+                                        Metadata::OptStore opt,       // option for data compression
+                                        ExternalEncoder encoderExt,   // optional external encoder or precomputed statistics
+                                        float memfc,                  // memory allocation margin factor
+                                        int nStreams,                 // number of interleaved rANS states, 0 for default
+                                        size_t chunkSize)             // number of symbols per independently decodable chunk, 0 for no chunking
+{
+  using storageBuffer_t = W;
+  using input_t = typename std::iterator_traits<input_IT>::value_type;
+  using ransEncoder_t = typename rans::LiteralEncoder64<input_t>;
+  using ransState_t = typename ransEncoder_t::coder_t;
+  using ransStream_t = typename ransEncoder_t::stream_t;
+
+  static_assert(std::is_same_v<storageBuffer_t, ransStream_t>);
+  static_assert(std::is_same_v<storageBuffer_t, typename rans::count_t>);
+
+  if (nStreams && !rans::isValidNInterleavedStreams(nStreams)) {
+    throw std::runtime_error(fmt::format("unsupported number {} of interleaved rANS streams requested", nStreams));
+  }
+  dest.dict.clear();
+  dest.data.clear();
+  dest.literals.clear();
+
+  const size_t messageLength = std::distance(srcBegin, srcEnd);
+  if (messageLength == 0) {
+    dest.md = Metadata{0, 0, sizeof(input_t), sizeof(ransState_t), sizeof(ransStream_t), symbolTablePrecision, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
+    return;
+  }
+
+  if (opt == Metadata::OptStore::EENCODE) {
+    constexpr size_t SizeEstMarginAbs = 10 * 1024;
+    const float SizeEstMarginRel = 1.5 * memfc;
+
+    const auto [inplaceEncoder, frequencyTable] = [&]() {
+      if (encoderExt.encoder) {
+        return std::make_tuple(ransEncoder_t{}, rans::FrequencyTable{});
+      } else {
+        rans::FrequencyTable frequencyTable = encoderExt.frequencyTable ? *encoderExt.frequencyTable : rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
+        RenormedFrequencyTable renormedFrequencyTable = rans::renorm(frequencyTable, symbolTablePrecision);
+        return std::make_tuple(ransEncoder_t{renormedFrequencyTable}, frequencyTable);
+      }
+    }();
+    ransEncoder_t const* const encoder = encoderExt.encoder ? reinterpret_cast<ransEncoder_t const* const>(encoderExt.encoder) : &inplaceEncoder;
+
+    if (!frequencyTable.empty()) {
+      dest.dict.assign(frequencyTable.data(), frequencyTable.data() + frequencyTable.size());
+    }
+    // pre-size the data buffer with the same margins as the in-place encoding
+    const size_t dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(input_t)); // size in bytes
+    chunkSize = getEffectiveChunkSize(messageLength, chunkSize);
+    dest.data.resize(SizeEstMarginAbs + size_t(SizeEstMarginRel * (dataSize / sizeof(storageBuffer_t))) + (sizeof(input_t) < sizeof(storageBuffer_t)) +
+                     estimateChunkingOverhead(messageLength, chunkSize, nStreams));
+
+    std::vector<input_t> literals;
+    storageBuffer_t* const bufferBegin = dest.data.data();
+    const auto encodedMessageEnd = encodeMessage(*encoder, nStreams, chunkSize, srcBegin, srcEnd, bufferBegin, literals);
+    rans::utils::checkBounds(encodedMessageEnd, bufferBegin + dest.data.size());
+    dest.data.resize(encodedMessageEnd - bufferBegin);
+
+    const size_t nLiteralSymbols = literals.size();
+    if (!literals.empty()) {
+      literals.resize(calculatePaddedSize<input_t, storageBuffer_t>(nLiteralSymbols), {});
+      const size_t nLiteralStorageElems = calculateNDestTElements<input_t, storageBuffer_t>(nLiteralSymbols);
+      const auto* literalsBegin = reinterpret_cast<const storageBuffer_t*>(literals.data());
+      dest.literals.assign(literalsBegin, literalsBegin + nLiteralStorageElems);
+    }
+
+    dest.md = Metadata{messageLength,
+                       nLiteralSymbols,
+                       sizeof(input_t),
+                       sizeof(ransState_t),
+                       sizeof(ransStream_t),
+                       static_cast<uint8_t>(encoder->getSymbolTablePrecision()),
+                       opt,
+                       encoder->getMinSymbol(),
+                       encoder->getMaxSymbol(),
+                       static_cast<int32_t>(dest.dict.size()),
+                       static_cast<int32_t>(dest.data.size()),
+                       static_cast<int32_t>(dest.literals.size()),
+                       static_cast<uint8_t>(nStreams > 2 ? nStreams : 0),
+                       static_cast<uint32_t>(chunkSize)};
+  } else { // store original data w/o EEncoding
+    const size_t nSourceElemsPadded = calculatePaddedSize<input_t, storageBuffer_t>(messageLength);
+    std::vector<input_t> tmp(nSourceElemsPadded, {});
+    std::copy(srcBegin, srcEnd, std::begin(tmp));
+    const size_t nBufferElems = calculateNDestTElements<input_t, storageBuffer_t>(messageLength);
+    const auto* tmpBegin = reinterpret_cast<const storageBuffer_t*>(tmp.data());
+    dest.data.assign(tmpBegin, tmpBegin + nBufferElems);
+    dest.md = Metadata{messageLength, 0, sizeof(input_t), sizeof(ransState_t), sizeof(storageBuffer_t), symbolTablePrecision, opt, 0, 0, 0, static_cast<int>(nBufferElems), 0};
+  }
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T>
+void EncodedBlocks<H, N, W>::storeSlot(buffer_T& buffer, int slot, const SlotBuffer<W>& src)
+{
+  auto* eb = get(buffer.data());
+  assert(slot == eb->mRegistry.nFilledBlocks);
+  const size_t sz = src.estimateSize();
+  if (sz > eb->getFreeSize()) {
+    eb = expand(buffer, eb->size() + (sz - eb->getFreeSize()));
+  }
+  eb->mRegistry.nFilledBlocks++;
+  eb->mMetadata[slot] = src.md;
+  if (src.md.opt == Metadata::OptStore::NODATA) {
+    return;
+  }
+  if (src.md.nStreams > 2 && eb->mANSHeader.minorVersion < ANSMinorVersionInterleaved) {
+    eb->mANSHeader.minorVersion = ANSMinorVersionInterleaved;
+  }
+  if (src.md.chunkSize && eb->mANSHeader.minorVersion < ANSMinorVersionChunked) {
+    eb->mANSHeader.minorVersion = ANSMinorVersionChunked;
+  }
+  auto ptrOrNull = [](const std::vector<W>& v) { return v.empty() ? nullptr : v.data(); };
+  eb->mBlocks[slot].store(src.dict.size(), src.data.size(), src.literals.size(), ptrOrNull(src.dict), ptrOrNull(src.data), ptrOrNull(src.literals));
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T>
+void EncodedBlocks<H, N, W>::encodeBatch(buffer_T& buffer, const EncodeBatch& batch, int nThreads)
+{
+  std::array<SlotBuffer<W>, N> slots;
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve(N);
+  int nFilled = get(buffer.data())->mRegistry.nFilledBlocks;
+  for (int i = 0; i < N; i++) {
+    if (i < nFilled) {
+      if (batch.mJobs[i]) {
+        throw std::runtime_error(fmt::format("trying to encode in occupied block {}, {} blocks are already filled", i, nFilled));
+      }
+      continue;
+    }
+    if (batch.mJobs[i]) {
+      jobs.emplace_back([&batch, &slots, i]() { batch.mJobs[i](slots[i]); });
+    } else {
+      slots[i].md.opt = Metadata::OptStore::NODATA;
+    }
+  }
+  runConcurrently(jobs, nThreads);
+
+  // compaction: single expansion to the final size, then sequential copy in the slots order
+  auto* eb = get(buffer.data());
+  size_t sz = eb->mRegistry.offsFreeStart;
+  for (const auto& sl : slots) {
+    sz += sl.estimateSize();
+  }
+  if (sz > eb->size()) {
+    expand(buffer, sz);
+  }
+  for (int i = nFilled; i < N; i++) {
+    storeSlot(buffer, i, slots[i]);
+  }
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+void EncodedBlocks<H, N, W>::decodeBatch(const DecodeBatch& batch, int nThreads) const
+{
+  std::vector<std::function<void()>> jobs;
+  jobs.reserve(batch.mJobs.size());
+  for (const auto& job : batch.mJobs) {
+    jobs.emplace_back([this, &job]() { job(*this); });
+  }
+  runConcurrently(jobs, nThreads);
+}
+
 /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
 template <typename H, int N, typename W>
 std::vector<char> EncodedBlocks<H, N, W>::createDictionaryBlocks(const std::vector<o2::rans::FrequencyTable>& vfreq, const std::vector<Metadata>& vmd)
@@ -0,0 +1,239 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.cxx
+/// \brief Indexed flat file container of CTFs which can be memory-mapped and read w/o deserialization
+
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "Framework/Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace o2::ctf;
+
+///_________________________________________________________________________________
+CTFHeader CTFFlatFileEntry::getCTFHeader() const
+{
+  CTFHeader h{run, creationTime, firstTForbit, tfCounter};
+  h.detectors = o2::detectors::DetID::mask_t(detectors);
+  return h;
+}
+
+///_________________________________________________________________________________
+CTFFlatFileWriter::~CTFFlatFileWriter()
+{
+  try {
+    close();
+  } catch (const std::exception& e) {
+    LOGP(error, "Failed to close CTF flat file {}: {}", mFileName, e.what());
+  }
+}
+
+///_________________________________________________________________________________
+void CTFFlatFileWriter::open(const std::string& fileName)
+{
+  close();
+  mFD = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+  if (mFD == -1) {
+    throw std::runtime_error(fmt::format("Failed to create CTF flat file {}: {}", fileName, strerror(errno)));
+  }
+  mFileName = fileName;
+  mIndex.clear();
+  mCurrent = CTFFlatFileEntry{};
+  CTFFlatFileHeader header; // will be rewritten at closing
+  writeAt(&header, sizeof(header), 0);
+  mOffset = sizeof(header);
+  pad();
+}
+
+///_________________________________________________________________________________
+void CTFFlatFileWriter::close()
+{
+  if (mFD == -1) {
+    return;
+  }
+  pad();
+  CTFFlatFileHeader header;
+  header.nCTFs = mIndex.size();
+  header.indexOffset = mOffset;
+  writeAt(mIndex.data(), mIndex.size() * sizeof(CTFFlatFileEntry), mOffset);
+  mOffset += mIndex.size() * sizeof(CTFFlatFileEntry);
+  writeAt(&header, sizeof(header), 0);
+  if (::close(mFD)) {
+    mFD = -1;
+    throw std::runtime_error(fmt::format("Failed to close CTF flat file {}: {}", mFileName, strerror(errno)));
+  }
+  mFD = -1;
+}
+
+///_________________________________________________________________________________
+size_t CTFFlatFileWriter::addDetector(DetID det, const void* data, size_t size)
+{
+  if (mFD == -1) {
+    throw std::runtime_error("CTF flat file is not open");
+  }
+  if (mCurrent.size[det]) {
+    throw std::runtime_error(fmt::format("Detector {} was already added to the current CTF", det.getName()));
+  }
+  size_t sz = pad();
+  mCurrent.offset[det] = mOffset;
+  mCurrent.size[det] = size;
+  writeAt(data, size, mOffset);
+  mOffset += size;
+  return sz + size;
+}
+
+///_________________________________________________________________________________
+size_t CTFFlatFileWriter::addCTF(const CTFHeader& header)
+{
+  if (mFD == -1) {
+    throw std::runtime_error("CTF flat file is not open");
+  }
+  mCurrent.run = header.run;
+  mCurrent.creationTime = header.creationTime;
+  mCurrent.firstTForbit = header.firstTForbit;
+  mCurrent.tfCounter = header.tfCounter;
+  mCurrent.detectors = header.detectors.to_ulong();
+  mIndex.push_back(mCurrent);
+  mCurrent = CTFFlatFileEntry{};
+  return sizeof(CTFFlatFileEntry);
+}
+
+///_________________________________________________________________________________
+void CTFFlatFileWriter::writeAt(const void* data, size_t size, uint64_t offset)
+{
+  const char* ptr = reinterpret_cast<const char*>(data);
+  while (size) {
+    auto nwr = ::pwrite(mFD, ptr, size, offset);
+    if (nwr < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(fmt::format("Failed to write {} bytes to CTF flat file {}: {}", size, mFileName, strerror(errno)));
+    }
+    ptr += nwr;
+    offset += nwr;
+    size -= nwr;
+  }
+}
+
+///_________________________________________________________________________________
+size_t CTFFlatFileWriter::pad()
+{
+  // align current position so that the written EncodedBlocks image can be used in place
+  static const std::array<char, Alignment> zeros{};
+  size_t npad = alignSize(mOffset) - mOffset;
+  if (npad) {
+    writeAt(zeros.data(), npad, mOffset);
+    mOffset += npad;
+  }
+  return npad;
+}
+
+///_________________________________________________________________________________
+void CTFFlatFileReader::open(const std::string& fileName)
+{
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw std::runtime_error(fmt::format("Failed to open CTF flat file {}: {}", fileName, strerror(errno)));
+  }
+  struct stat statbuf;
+  if (fstat(fd, &statbuf) || size_t(statbuf.st_size) < sizeof(CTFFlatFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("CTF flat file {} is too short or cannot be accessed", fileName));
+  }
+  size_t size = statbuf.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping stays valid
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("Failed to map CTF flat file {}: {}", fileName, strerror(errno)));
+  }
+  std::shared_ptr<const char> mapping(reinterpret_cast<const char*>(addr), [size](const char* p) { munmap(const_cast<char*>(p), size); });
+  const auto& header = *reinterpret_cast<const CTFFlatFileHeader*>(addr);
+  if (header.magic != CTFFlatFileHeader::Magic || header.version != CTFFlatFileHeader::Version) {
+    throw std::runtime_error(fmt::format("{} is not a CTF flat file of version {}", fileName, CTFFlatFileHeader::Version));
+  }
+  if (!header.indexOffset || header.indexOffset + header.nCTFs * sizeof(CTFFlatFileEntry) > size) {
+    throw std::runtime_error(fmt::format("CTF flat file {} was not closed properly, the index is missing", fileName));
+  }
+  mIndex = reinterpret_cast<const CTFFlatFileEntry*>(mapping.get() + header.indexOffset);
+  mNCTFs = header.nCTFs;
+  for (size_t i = 0; i < mNCTFs; i++) {
+    for (int id = DetID::First; id <= DetID::Last; id++) {
+      if (mIndex[i].size[id] && mIndex[i].offset[id] + mIndex[i].size[id] > header.indexOffset) {
+        throw std::runtime_error(fmt::format("CTF flat file {} is corrupted: {} data of CTF {} exceeds the payload", fileName, DetID::getName(id), i));
+      }
+    }
+  }
+  mMapping = std::move(mapping);
+  mSize = size;
+  mFileName = fileName;
+  madvise(const_cast<char*>(mMapping.get()), mSize, MADV_SEQUENTIAL);
+}
+
+///_________________________________________________________________________________
+void CTFFlatFileReader::close()
+{
+  mMapping.reset(); // the file is unmapped when the last user releases it
+  mIndex = nullptr;
+  mNCTFs = 0;
+  mSize = 0;
+  mFileName.clear();
+}
+
+///_________________________________________________________________________________
+const CTFFlatFileEntry& CTFFlatFileReader::getEntry(size_t ctf) const
+{
+  if (ctf >= mNCTFs) {
+    throw std::runtime_error(fmt::format("CTF {} is requested but {} contains {} CTFs", ctf, mFileName, mNCTFs));
+  }
+  return mIndex[ctf];
+}
+
+///_________________________________________________________________________________
+const char* CTFFlatFileReader::getDetectorData(size_t ctf, DetID det, size_t& size) const
+{
+  const auto& entry = getEntry(ctf);
+  size = entry.size[det];
+  return size ? mMapping.get() + entry.offset[det] : nullptr;
+}
+
+///_________________________________________________________________________________
+void CTFFlatFileReader::prefetch(size_t ctf) const
+{
+  const auto& entry = getEntry(ctf);
+  uint64_t start = mSize, end = 0;
+  for (int id = DetID::First; id <= DetID::Last; id++) {
+    if (entry.size[id]) {
+      start = std::min(start, entry.offset[id]);
+      end = std::max(end, entry.offset[id] + entry.size[id]);
+    }
+  }
+  if (start < end) {
+    const uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    start -= start % pageSize; // madvise needs page aligned address
+    madvise(const_cast<char*>(mMapping.get()) + start, end - start, MADV_WILLNEED);
+  }
+}
+
+///_________________________________________________________________________________
+bool CTFFlatFileReader::isFlatFile(const std::string& fileName)
+{
+  const auto ext = fmt::format(".{}", CTFFlatFileWriter::FileExtension);
+  return fileName.size() > ext.size() && fileName.compare(fileName.size() - ext.size(), ext.size(), ext) == 0;
+}
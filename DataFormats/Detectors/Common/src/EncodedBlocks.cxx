@@ -10,5 +10,37 @@
 // or submit itself to any jurisdiction.
 
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include <algorithm>
+#include <exception>
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
 
 using namespace o2::ctf;
+
+void o2::ctf::runConcurrently(const std::vector<std::function<void()>>& jobs, int nThreads)
+{
+  const int nJobs = jobs.size();
+#ifdef WITH_OPENMP
+  if (nThreads > 1 && nJobs > 1) {
+    std::vector<std::exception_ptr> errors(nJobs);
+#pragma omp parallel for schedule(dynamic) num_threads(std::min(nThreads, nJobs))
+    for (int i = 0; i < nJobs; i++) {
+      try {
+        jobs[i]();
+      } catch (...) { // exceptions must not escape the parallel region
+        errors[i] = std::current_exception();
+      }
+    }
+    for (auto& err : errors) {
+      if (err) {
+        std::rethrow_exception(err);
+      }
+    }
+    return;
+  }
+#endif
+  for (const auto& job : jobs) {
+    job();
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFFlatFile
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <vector>
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+BOOST_AUTO_TEST_CASE(CTFFlatFile_test)
+{
+  const std::string fileName = "test_ctf_flat_file.ctf";
+  const int nCTFs = 5;
+  auto payloadSize = [](int ctf, int det) { return 13 * ctf + det + 1; };
+  auto isStored = [](int ctf, int det) { return det % (ctf + 1) == 0; };
+  {
+    CTFFlatFileWriter writer;
+    writer.open(fileName);
+    for (int ctf = 0; ctf < nCTFs; ctf++) {
+      CTFHeader header{1234, 5678, uint32_t(ctf * 32), uint32_t(ctf)};
+      for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+        if (isStored(ctf, id)) {
+          std::vector<char> payload(payloadSize(ctf, id), char('a' + id));
+          writer.addDetector(id, payload.data(), payload.size());
+          header.detectors.set(id);
+        }
+      }
+      writer.addCTF(header);
+    }
+    writer.close();
+  }
+  BOOST_CHECK(CTFFlatFileReader::isFlatFile(fileName));
+
+  CTFFlatFileReader reader(fileName);
+  BOOST_CHECK(reader.getNCTFs() == nCTFs);
+  for (int ctf = 0; ctf < nCTFs; ctf++) {
+    auto header = reader.getCTFHeader(ctf);
+    BOOST_CHECK(header.run == 1234 && header.creationTime == 5678 && header.firstTForbit == uint32_t(ctf * 32) && header.tfCounter == uint32_t(ctf));
+    for (DetID::ID id = DetID::First; id <= DetID::Last; id++) {
+      size_t size = 0;
+      const char* data = reader.getDetectorData(ctf, id, size);
+      BOOST_CHECK(header.detectors[id] == isStored(ctf, id));
+      if (!isStored(ctf, id)) {
+        BOOST_CHECK(!data && !size);
+        continue;
+      }
+      BOOST_CHECK(size == size_t(payloadSize(ctf, id)));
+      BOOST_CHECK(reinterpret_cast<uintptr_t>(data) % Alignment == 0);
+      BOOST_CHECK(std::all_of(data, data + size, [id](char c) { return c == char('a' + id); }));
+    }
+  }
+  // the mapping must survive the closing of the reader while in use
+  auto mapping = reader.getMapping();
+  reader.close();
+  BOOST_CHECK(mapping.use_count() == 1);
+  BOOST_CHECK_THROW(reader.getCTFHeader(0), std::runtime_error);
+}
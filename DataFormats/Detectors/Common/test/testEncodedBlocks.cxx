@@ -0,0 +1,205 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test EncodedBlocks
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <vector>
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+using namespace o2::ctf;
+using TestBlocks = EncodedBlocks<CTFHeader, 4, uint32_t>;
+
+namespace
+{
+template <typename T>
+std::vector<T> makeSource(size_t n, int range, int seed)
+{
+  std::vector<T> v(n);
+  uint32_t x = seed;
+  for (auto& e : v) {
+    x = x * 1664525u + 1013904223u;
+    e = static_cast<T>(int((x >> 16) % range) - range / 4); // non-uniform: more weight on the low values
+  }
+  return v;
+}
+
+struct Sources {
+  std::vector<int16_t> s0 = makeSource<int16_t>(20000, 200, 1);
+  std::vector<int16_t> s1; // empty
+  std::vector<uint8_t> s2 = makeSource<uint8_t>(1001, 256, 2);
+  std::vector<int32_t> s3 = makeSource<int32_t>(12345, 5000, 3);
+};
+
+void checkSameBlocks(const TestBlocks& a, const TestBlocks& b)
+{
+  BOOST_CHECK_EQUAL(a.getRegistry().nFilledBlocks, b.getRegistry().nFilledBlocks);
+  BOOST_CHECK_EQUAL(a.getRegistry().offsFreeStart, b.getRegistry().offsFreeStart);
+  BOOST_CHECK_EQUAL(a.getANSHeader().minorVersion, b.getANSHeader().minorVersion);
+  for (int i = 0; i < TestBlocks::getNBlocks(); i++) {
+    const auto &ma = a.getMetadata(i), &mb = b.getMetadata(i);
+    BOOST_CHECK(ma.opt == mb.opt);
+    BOOST_CHECK_EQUAL(ma.messageLength, mb.messageLength);
+    BOOST_CHECK_EQUAL(ma.nLiterals, mb.nLiterals);
+    BOOST_CHECK_EQUAL(ma.nDictWords, mb.nDictWords);
+    BOOST_CHECK_EQUAL(ma.nDataWords, mb.nDataWords);
+    BOOST_CHECK_EQUAL(ma.nLiteralWords, mb.nLiteralWords);
+    BOOST_CHECK_EQUAL(ma.nStreams, mb.nStreams);
+    BOOST_CHECK_EQUAL(ma.chunkSize, mb.chunkSize);
+    const auto &ba = a.getBlock(i), &bb = b.getBlock(i);
+    BOOST_REQUIRE_EQUAL(ba.getNStored(), bb.getNStored());
+    BOOST_CHECK_EQUAL(ba.getNDict(), bb.getNDict());
+    BOOST_CHECK_EQUAL(ba.getNData(), bb.getNData());
+    BOOST_CHECK_EQUAL(ba.getNLiterals(), bb.getNLiterals());
+    if (ba.getNStored()) {
+      BOOST_CHECK(std::equal(ba.payload, ba.payload + ba.getNStored(), bb.payload));
+    }
+  }
+}
+
+template <typename T>
+void checkDecoded(const TestBlocks& eb, int slot, const std::vector<T>& src)
+{
+  std::vector<T> dest;
+  eb.decode(dest, slot);
+  BOOST_CHECK_EQUAL(dest.size(), src.size());
+  BOOST_CHECK(dest == src);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(EncodeBatchMatchesSequential)
+{
+  Sources src;
+  const size_t chunkSize = 1000;
+  std::vector<char> seqBuff, batchBuff;
+  TestBlocks::create(seqBuff);
+  TestBlocks::create(batchBuff);
+
+  TestBlocks::get(seqBuff.data())->encode(src.s0, 0, 0, Metadata::OptStore::EENCODE, &seqBuff);
+  TestBlocks::get(seqBuff.data())->encode(src.s1, 1, 0, Metadata::OptStore::EENCODE, &seqBuff);
+  TestBlocks::get(seqBuff.data())->encode(src.s2, 2, 0, Metadata::OptStore::NONE, &seqBuff);
+  TestBlocks::get(seqBuff.data())->encode(src.s3, 3, 0, Metadata::OptStore::EENCODE, &seqBuff, nullptr, 1.f, 4, chunkSize);
+
+  TestBlocks::EncodeBatch batch;
+  batch.add(src.s0, 0, 0, Metadata::OptStore::EENCODE);
+  batch.add(src.s1, 1, 0, Metadata::OptStore::EENCODE);
+  batch.add(src.s2, 2, 0, Metadata::OptStore::NONE);
+  batch.add(src.s3, 3, 0, Metadata::OptStore::EENCODE, nullptr, 1.f, 4, chunkSize);
+  TestBlocks::encodeBatch(batchBuff, batch, 4);
+
+  const auto* seq = TestBlocks::get(seqBuff.data());
+  const auto* bat = TestBlocks::get(batchBuff.data());
+  checkSameBlocks(*seq, *bat);
+  BOOST_CHECK(bat->getMetadata(1).opt == Metadata::OptStore::NODATA);
+  BOOST_CHECK(bat->getMetadata(2).opt == Metadata::OptStore::NONE);
+  BOOST_CHECK_EQUAL(bat->getANSHeader().minorVersion, ANSMinorVersionChunked);
+
+  for (const auto* eb : {seq, bat}) {
+    checkDecoded(*eb, 0, src.s0);
+    checkDecoded(*eb, 1, src.s1);
+    checkDecoded(*eb, 2, src.s2);
+    checkDecoded(*eb, 3, src.s3);
+  }
+
+  // the same through the concurrent decoding
+  std::vector<int16_t> d0;
+  std::vector<uint8_t> d2;
+  std::vector<int32_t> d3;
+  TestBlocks::DecodeBatch dbatch;
+  dbatch.add(d0, 0);
+  dbatch.add(d2, 2);
+  dbatch.add(d3, 3);
+  bat->decodeBatch(dbatch, 3);
+  BOOST_CHECK(d0 == src.s0);
+  BOOST_CHECK(d2 == src.s2);
+  BOOST_CHECK(d3 == src.s3);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeBatchAfterFilledBlocks)
+{
+  Sources src;
+  std::vector<char> buff;
+  TestBlocks::create(buff);
+  TestBlocks::get(buff.data())->encode(src.s0, 0, 0, Metadata::OptStore::EENCODE, &buff);
+
+  // the already filled block cannot be encoded again by the batch
+  TestBlocks::EncodeBatch badBatch;
+  badBatch.add(src.s0, 0, 0, Metadata::OptStore::EENCODE);
+  badBatch.add(src.s2, 2, 0, Metadata::OptStore::NONE);
+  BOOST_CHECK_THROW(TestBlocks::encodeBatch(buff, badBatch, 2), std::runtime_error);
+
+  TestBlocks::EncodeBatch batch;
+  batch.add(src.s2, 2, 0, Metadata::OptStore::NONE);
+  batch.add(src.s3, 3, 0, Metadata::OptStore::EENCODE);
+  TestBlocks::encodeBatch(buff, batch, 2);
+  const auto* eb = TestBlocks::get(buff.data());
+  BOOST_CHECK_EQUAL(eb->getRegistry().nFilledBlocks, TestBlocks::getNBlocks());
+  BOOST_CHECK(eb->getMetadata(1).opt == Metadata::OptStore::NODATA);
+  checkDecoded(*eb, 0, src.s0);
+  checkDecoded(*eb, 2, src.s2);
+  checkDecoded(*eb, 3, src.s3);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkedRangeDecoding)
+{
+  const size_t chunkSize = 1000;
+  const auto src = makeSource<int16_t>(10 * chunkSize + 321, 300, 4);
+  for (int nStreams : {0, 4, 8}) {
+    std::vector<char> buff;
+    TestBlocks::create(buff);
+    TestBlocks::get(buff.data())->encode(src, 0, 0, Metadata::OptStore::EENCODE, &buff, nullptr, 1.f, nStreams, chunkSize);
+    // a message shorter than a chunk is not chunked
+    TestBlocks::get(buff.data())->encode(src.begin(), src.begin() + chunkSize / 2, 1, 0, Metadata::OptStore::EENCODE, &buff, nullptr, 1.f, nStreams, chunkSize);
+    // the range decoding works for unchunked messages too
+    TestBlocks::get(buff.data())->encode(src, 2, 0, Metadata::OptStore::EENCODE, &buff, nullptr, 1.f, nStreams);
+    TestBlocks::get(buff.data())->encode(src, 3, 0, Metadata::OptStore::NONE, &buff);
+    const auto* eb = TestBlocks::get(buff.data());
+
+    BOOST_CHECK_EQUAL(eb->getMetadata(0).chunkSize, chunkSize);
+    BOOST_CHECK_EQUAL(eb->getMetadata(0).getNChunks(), 11u);
+    BOOST_CHECK_EQUAL(eb->getMetadata(1).chunkSize, 0u);
+    BOOST_CHECK_EQUAL(eb->getMetadata(2).chunkSize, 0u);
+    checkDecoded(*eb, 0, src);
+
+    const std::vector<MessageRange> ranges{{0, chunkSize},                     // exactly the first chunk
+                                           {chunkSize - 1, chunkSize + 1},     // across a chunk boundary
+                                           {chunkSize, 2 * chunkSize},         // exactly an inner chunk
+                                           {2 * chunkSize + 500, 7 * chunkSize + 3},
+                                           {10 * chunkSize, src.size()},       // the last, incomplete, chunk
+                                           {src.size() - 1, src.size()},
+                                           {0, src.size()},
+                                           {5 * chunkSize, 5 * chunkSize}}; // empty
+    for (int slot : {0, 2, 3}) {
+      for (const auto& r : ranges) {
+        std::vector<int16_t> dest;
+        eb->decode(dest, slot, r);
+        BOOST_REQUIRE_EQUAL(dest.size(), r.size());
+        BOOST_CHECK(std::equal(dest.begin(), dest.end(), src.begin() + r.first));
+      }
+    }
+    std::vector<int16_t> dest;
+    eb->decode(dest, 1, MessageRange{100, 200});
+    BOOST_CHECK(std::equal(dest.begin(), dest.end(), src.begin() + 100));
+    BOOST_CHECK_THROW(eb->decode(dest, 0, MessageRange{0, src.size() + 1}), std::runtime_error);
+
+    // disjoint ranges of the same slot decoded concurrently, split off the chunk boundaries
+    std::vector<int16_t> all(src.size());
+    TestBlocks::DecodeBatch batch;
+    const size_t split = 4 * chunkSize + 17;
+    batch.add(all.begin(), 0, MessageRange{0, split});
+    batch.add(all.begin() + split, 0, MessageRange{split, src.size()});
+    eb->decodeBatch(batch, 2);
+    BOOST_CHECK(all == src);
+  }
+}
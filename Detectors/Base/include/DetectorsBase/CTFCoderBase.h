@@ -17,12 +17,18 @@
 #define _ALICEO2_CTFCODER_BASE_H_
 
 #include <memory>
+#include <functional>
+#include <tuple>
+#include <typeinfo>
+#include <cmath>
+#include <map>
 #include <TFile.h>
 #include <TTree.h>
 #include "DetectorsCommonDataFormats/DetID.h"
 #include "CommonUtils/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFDictHeader.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "rANS/rans.h"
 #include <filesystem>
 #include "Framework/InitContext.h"
@@ -50,6 +56,19 @@ class CTFCoderBase
   enum class OpType : int { Encoder,
                             Decoder };
 
+  // identifies the coder built from given dictionary for the detector slot
+  struct SharedCoderKey {
+    int det = 0;
+    int slot = 0;
+    int op = 0;
+    size_t type = 0;       // hash of the source type
+    uint64_t dictHash = 0; // hash of the renormed dictionary
+    bool operator<(const SharedCoderKey& other) const
+    {
+      return std::tie(det, slot, op, type, dictHash) < std::tie(other.det, other.slot, other.op, other.type, other.dictHash);
+    }
+  };
+
   CTFCoderBase() = delete;
   CTFCoderBase(int n, DetID det, float memFactor = 1.f) : mCoders(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
   CTFCoderBase(OpType op, int n, DetID det, float memFactor = 1.f) : mOpType(op), mCoders(n), mDet(det), mMemMarginFactor(memFactor > 1.f ? memFactor : 1.f) {}
@@ -73,16 +92,22 @@ class CTFCoderBase
       LOG(warning) << "Empty dictionary provided for slot " << slot << ", " << (op == OpType::Encoder ? "encoding" : "decoding") << " will assume literal symbols only";
     }
 
-    switch (op) {
-      case OpType::Encoder:
-        mCoders[slot].reset(new o2::rans::LiteralEncoder64<S>(renormedFrequencyTable));
-        break;
-      case OpType::Decoder:
-        mCoders[slot].reset(new o2::rans::LiteralDecoder64<S>(renormedFrequencyTable));
-        break;
-    }
+    // coders are not modified after creation, those built from the same dictionary are shared by all instances and threads of the process
+    const SharedCoderKey key{mDet, slot, int(op), typeid(S).hash_code(), getDictionaryHash(renormedFrequencyTable)};
+    mCoders[slot] = getSharedCoder(key, [op, &renormedFrequencyTable]() -> std::shared_ptr<void> {
+      switch (op) {
+        case OpType::Encoder:
+          return std::make_shared<o2::rans::LiteralEncoder64<S>>(renormedFrequencyTable);
+        case OpType::Decoder:
+          return std::make_shared<o2::rans::LiteralDecoder64<S>>(renormedFrequencyTable);
+      }
+      return {};
+    });
   }
 
+  /// number of distinct coders currently alive in the shared coders cache
+  static size_t getNSharedCoders();
+
   void clear()
   {
     for (auto c : mCoders) {
@@ -93,10 +118,40 @@ class CTFCoderBase
   void setMemMarginFactor(float v) { mMemMarginFactor = v > 1.f ? v : 1.f; }
   float getMemMarginFactor() const { return mMemMarginFactor; }
 
+  void setNInterleavedStreams(int n)
+  {
+    if (n && !o2::rans::isValidNInterleavedStreams(n)) {
+      throw std::runtime_error(fmt::format("{}unsupported number {} of interleaved rANS streams", getPrefix(), n));
+    }
+    mNInterleavedStreams = n;
+  }
+  int getNInterleavedStreams() const { return mNInterleavedStreams; }
+
+  /// external encoder of the slot or, if in adaptive dictionary mode encoding with the per-block dictionary is estimated to be
+  /// cheaper, the statistics of the message collected for the estimate, to be used for the per-block dictionary
+  template <typename source_IT>
+  ExternalEncoder selectEncoder(source_IT srcBegin, source_IT srcEnd, int slot) const;
+
+  template <typename VE>
+  ExternalEncoder selectEncoder(const VE& src, int slot) const
+  {
+    return selectEncoder(std::begin(src), std::end(src), slot);
+  }
+
+  void setAdaptiveDictionary(bool v) { mAdaptiveDict = v; }
+  bool getAdaptiveDictionary() const { return mAdaptiveDict; }
+
+  void setChunkSize(int n) { mChunkSize = n > 0 ? n : 0; }
+  size_t getChunkSize() const { return mChunkSize; }
+
+  void setNThreads(int n) { mNThreads = n > 1 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
   const CTFDictHeader& getExtDictHeader() const { return mExtHeader; }
+  size_t getNDictVersions() const { return mDictVersions.size(); }
 
   template <typename T>
   static bool readFromTree(TTree& tree, const std::string brname, T& dest, int ev = 0);
@@ -114,14 +169,30 @@ class CTFCoderBase
   void updateTimeDependentParams(o2::framework::ProcessingContext& pc);
 
  protected:
+  static std::shared_ptr<void> getSharedCoder(const SharedCoderKey& key, const std::function<std::shared_ptr<void>()>& creator);
+  static uint64_t getDictionaryHash(const o2::rans::RenormedFrequencyTable& renormedFrequencyTable);
+
   std::string getPrefix() const { return o2::utils::Str::concat_string(mDet.getName(), "_CTF: "); }
 
-  void checkDictVersion(const CTFDictHeader& h) const;
+  void checkDictVersion(const CTFDictHeader& h);
+  void checkDictUpdate();
+  void storeDictVersion();
+  bool selectDictVersion(const CTFDictHeader& h);
 
   std::vector<std::shared_ptr<void>> mCoders; // encoders/decoders
   DetID mDet;
   CTFDictHeader mExtHeader;      // external dictionary header
   float mMemMarginFactor = 1.0f; // factor for memory allocation in EncodedBlocks
+  int mNInterleavedStreams = 0;  // number of interleaved rANS states used for encoding, 0 for default
+  int mNThreads = 1;             // number of threads for concurrent encoding/decoding of the blocks
+  size_t mChunkSize = 0;         // number of symbols per independently decodable rANS chunk, 0 for no chunking
+  bool mAdaptiveDict = false;    // choose per block between the external dictionary and the embedded one
+  int mDictCheckAfter = 0;       // if > 0, check every so many TFs if the external dictionary file was updated
+  size_t mNTFSinceDictCheck = 0;
+  std::string mDictPath{};                          // local external dictionary file, if any
+  std::filesystem::file_time_type mDictFileTime{};  // modification time of the loaded local dictionary
+  std::function<void(const std::string&)> mDictLoader{}; // loads a local dictionary file (needs the detector CTF type)
+  std::map<uint32_t, std::pair<CTFDictHeader, std::vector<std::shared_ptr<void>>>> mDictVersions; // decoders of all loaded dictionaries, by timestamp
   bool mLoadDictFromCCDB{true};
   OpType mOpType; // Encoder or Decoder
   int mVerbosity = 0;
@@ -154,6 +225,7 @@ void CTFCoderBase::createCodersFromFile(const std::string& dictPath, o2::ctf::CT
     throw std::runtime_error("Failed to create CTF dictionaty");
   }
   createCoders(buff, op);
+  storeDictVersion();
 }
 
 ///________________________________
@@ -218,6 +290,21 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   if (ic.options().hasOption("mem-factor")) {
     setMemMarginFactor(ic.options().get<float>("mem-factor"));
   }
+  if (ic.options().hasOption("ans-streams")) {
+    setNInterleavedStreams(ic.options().get<int>("ans-streams"));
+  }
+  if (ic.options().hasOption("ans-chunk-size")) {
+    setChunkSize(ic.options().get<int>("ans-chunk-size"));
+  }
+  if (ic.options().hasOption("nthreads")) {
+    setNThreads(ic.options().get<int>("nthreads"));
+  }
+  if (ic.options().hasOption("ctf-dict-adaptive")) {
+    setAdaptiveDictionary(ic.options().get<bool>("ctf-dict-adaptive"));
+  }
+  if (ic.options().hasOption("ctf-dict-check-after")) {
+    mDictCheckAfter = ic.options().get<int>("ctf-dict-check-after");
+  }
   auto dict = ic.options().get<std::string>("ctf-dict");
   if (dict.empty() || dict == "ccdb") { // load from CCDB
     mLoadDictFromCCDB = true;
@@ -225,6 +312,10 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
     if (dict != "none") { // none means per-CTF dictionary will created on the fly
       createCodersFromFile<CTF>(dict, mOpType);
       LOGP(info, "Loaded {} from {}", mExtHeader.asString(), dict);
+      // the dictionary may be updated by the online dictionary creation in the CTFWriter, which keeps the earlier versions next to it
+      mDictPath = dict;
+      mDictFileTime = std::filesystem::last_write_time(dict);
+      mDictLoader = [this](const std::string& path) { createCodersFromFile<CTF>(path, mOpType); };
     } else {
       LOGP(info, "Internal per-TF CTF Dict will be created");
     }
@@ -232,6 +323,41 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   }
 }
 
+///________________________________
+template <typename source_IT>
+ExternalEncoder CTFCoderBase::selectEncoder(source_IT srcBegin, source_IT srcEnd, int slot) const
+{
+  using source_t = typename std::iterator_traits<source_IT>::value_type;
+  const auto* encoder = static_cast<const o2::rans::LiteralEncoder64<source_t>*>(mCoders[slot].get());
+  if (!mAdaptiveDict || !encoder || srcBegin == srcEnd) {
+    return encoder;
+  }
+  // estimate the encoded size in bits with the entropy of the message for the embedded dictionary (which must be stored) and
+  // with the cross-entropy wrt the external dictionary, accounting for the literals of the symbols absent in the latter
+  auto freq = o2::rans::makeFrequencyTableFromSamples(srcBegin, srcEnd);
+  const double nSamples = freq.getNumSamples();
+  const double precision = encoder->getSymbolTablePrecision();
+  double bitsEmbedded = freq.size() * sizeof(o2::rans::count_t) * 8, bitsExternal = 0;
+  auto symbol = freq.getMinSymbol();
+  for (auto cnt : freq) {
+    if (cnt) {
+      bitsEmbedded += cnt * std::log2(nSamples / cnt);
+      bitsExternal += cnt * (precision - std::log2(encoder->getSymbolFrequency(symbol)));
+      if (encoder->isEscapeSymbol(symbol)) {
+        bitsExternal += cnt * sizeof(source_t) * 8;
+      }
+    }
+    symbol++;
+  }
+  if (mVerbosity > 1) {
+    LOGP(info, "{}slot {}: estimated {} bits with external and {} bits with embedded dictionary", getPrefix(), slot, bitsExternal, bitsEmbedded);
+  }
+  if (bitsExternal <= bitsEmbedded) {
+    return encoder;
+  }
+  return std::make_shared<const o2::rans::FrequencyTable>(std::move(freq)); // spare histogramming the message again for the embedded dictionary
+}
+
 ///________________________________
 template <typename CTF, typename BUF>
 size_t CTFCoderBase::finaliseCTFOutput(BUF& buffer)
@@ -253,8 +379,9 @@ bool CTFCoderBase::finaliseCCDB(o2::framework::ConcreteDataMatcher& matcher, voi
     if (dict->empty()) {
       LOGP(info, "Empty dictionary object fetched from CCDB, internal per-TF CTF Dict will be created");
     } else {
-      createCoders(*dict, mOpType);
       mExtHeader = static_cast<const CTFDictHeader&>(CTF::get(dict->data())->getHeader());
+      createCoders(*dict, mOpType);
+      storeDictVersion();
       LOGP(info, "Loaded {} from CCDB", mExtHeader.asString());
     }
     mLoadDictFromCCDB = false; // we read the dictionary at most once!
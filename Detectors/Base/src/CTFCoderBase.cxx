@@ -17,17 +17,61 @@
 #include "Framework/ControlService.h"
 #include "Framework/ProcessingContext.h"
 #include "Framework/InputRecord.h"
+#include <map>
+#include <mutex>
 
 using namespace o2::ctf;
 using namespace o2::framework;
 
-void CTFCoderBase::checkDictVersion(const CTFDictHeader& h) const
+// select the dictionary the data was encoded with among the loaded versions, looking for it next to the local dictionary
+// file (where the online dictionary creation keeps the earlier versions) if it was not loaded yet
+void CTFCoderBase::checkDictVersion(const CTFDictHeader& h)
 {
-  if (h.isValidDictTimeStamp()) { // external dictionary was used
-    if (h.isValidDictTimeStamp() && h != mExtHeader) {
-      throw std::runtime_error(fmt::format("Mismatch in {} CTF dictionary: need {}, provided {}", mDet.getName(), h.asString(), mExtHeader.asString()));
+  if (!h.isValidDictTimeStamp() || h == mExtHeader) { // no external dictionary was used or it is the current one
+    return;
+  }
+  if (selectDictVersion(h)) {
+    return;
+  }
+  if (mDictLoader) {
+    const std::string prefix = fmt::format("{}_{}_", o2::base::NameConf::CTFDICT, h.dictTimeStamp);
+    auto dictDir = std::filesystem::path(mDictPath).parent_path();
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dictDir.empty() ? "." : dictDir, ec)) {
+      const auto fname = entry.path().filename().string();
+      if (fname.rfind(prefix, 0) == 0 && entry.path().extension() == ".root") {
+        LOGP(info, "{}loading dictionary {} from {}", getPrefix(), h.asString(), entry.path().string());
+        mDictLoader(entry.path().string());
+        break;
+      }
     }
   }
+  if (!selectDictVersion(h)) {
+    throw std::runtime_error(fmt::format("Mismatch in {} CTF dictionary: need {}, provided {}", mDet.getName(), h.asString(), mExtHeader.asString()));
+  }
+}
+
+// keep the decoders of the current external dictionary, the data encoded with it must stay decodable after an update
+void CTFCoderBase::storeDictVersion()
+{
+  if (mOpType == OpType::Decoder && mExtHeader.isValidDictTimeStamp()) {
+    mDictVersions[mExtHeader.dictTimeStamp] = std::make_pair(mExtHeader, mCoders);
+  }
+}
+
+// make the decoders of the dictionary version h current, if it was loaded
+bool CTFCoderBase::selectDictVersion(const CTFDictHeader& h)
+{
+  auto it = mDictVersions.find(h.dictTimeStamp);
+  if (it == mDictVersions.end() || it->second.first != h) {
+    return false;
+  }
+  if (mVerbosity > 0) {
+    LOGP(info, "{}switching from dictionary {} to {}", getPrefix(), mExtHeader.asString(), h.asString());
+  }
+  mExtHeader = it->second.first;
+  mCoders = it->second.second;
+  return true;
 }
 
 // Assign version of the dictionary which will be stored in the data (including dictionary data during dictionary creation)
@@ -50,4 +94,88 @@ void CTFCoderBase::updateTimeDependentParams(ProcessingContext& pc)
   if (mLoadDictFromCCDB) {
     pc.inputs().get<std::vector<char>*>("ctfdict"); // just to trigger the finaliseCCDB
   }
+  checkDictUpdate();
+}
+
+// reload the local external dictionary if it was updated since the last check
+void CTFCoderBase::checkDictUpdate()
+{
+  if (!mDictLoader || mDictCheckAfter <= 0 || ++mNTFSinceDictCheck < size_t(mDictCheckAfter)) {
+    return;
+  }
+  mNTFSinceDictCheck = 0;
+  std::error_code ec;
+  auto ftime = std::filesystem::last_write_time(mDictPath, ec);
+  if (ec || ftime == mDictFileTime) {
+    return;
+  }
+  auto prevHeader = mExtHeader;
+  try {
+    mDictLoader(mDictPath);
+    mDictFileTime = ftime;
+    if (mExtHeader != prevHeader) {
+      LOGP(info, "Reloaded {} from {}, replacing {}", mExtHeader.asString(), mDictPath, prevHeader.asString());
+    }
+  } catch (const std::exception& e) { // the file may be in the middle of an update, retry at next check
+    LOGP(warning, "{}failed to reload dictionary from {}: {}", getPrefix(), mDictPath, e.what());
+  }
+}
+
+namespace
+{
+// cache of the coders built from external dictionaries: coders are kept alive by their users, the cache only holds weak
+// references, so that the coders of replaced dictionaries are released
+struct SharedCoders {
+  std::mutex mutex;
+  std::map<CTFCoderBase::SharedCoderKey, std::weak_ptr<void>> coders;
+  static SharedCoders& instance()
+  {
+    static SharedCoders cache;
+    return cache;
+  }
+};
+} // namespace
+
+std::shared_ptr<void> CTFCoderBase::getSharedCoder(const SharedCoderKey& key, const std::function<std::shared_ptr<void>()>& creator)
+{
+  auto& cache = SharedCoders::instance();
+  std::lock_guard<std::mutex> lock(cache.mutex); // the coder is created under the lock to build it only once
+  auto& entry = cache.coders[key];
+  auto coder = entry.lock();
+  if (coder) {
+    LOGP(debug, "{}: reusing coder of slot {} built from dictionary {:#x}", DetID::getName(key.det), key.slot, key.dictHash);
+    return coder;
+  }
+  coder = creator();
+  entry = coder;
+  for (auto it = cache.coders.begin(); it != cache.coders.end();) { // purge coders of the released dictionaries
+    it = it->second.expired() ? cache.coders.erase(it) : std::next(it);
+  }
+  return coder;
+}
+
+size_t CTFCoderBase::getNSharedCoders()
+{
+  auto& cache = SharedCoders::instance();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return std::count_if(cache.coders.begin(), cache.coders.end(), [](const auto& entry) { return !entry.second.expired(); });
+}
+
+// FNV-1a hash of the renormed dictionary content
+uint64_t CTFCoderBase::getDictionaryHash(const o2::rans::RenormedFrequencyTable& renormedFrequencyTable)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  auto add = [&hash](uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+      hash = (hash ^ ((v >> (8 * i)) & 0xff)) * 0x100000001b3ULL;
+    }
+  };
+  add(renormedFrequencyTable.getRenormingBits());
+  add(uint64_t(int64_t(renormedFrequencyTable.getMinSymbol())));
+  add(renormedFrequencyTable.size());
+  add(renormedFrequencyTable.getIncompressibleSymbolFrequency());
+  for (auto freq : renormedFrequencyTable) {
+    add(freq);
+  }
+  return hash;
 }
@@ -0,0 +1,178 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFCoderBase
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <vector>
+#include "DetectorsBase/CTFCoderBase.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+using namespace o2::ctf;
+
+namespace
+{
+using TestBlocks = EncodedBlocks<CTFHeader, 2, uint32_t>;
+
+// coder with 2 slots whose "dictionary" is just a sample of symbols to build the frequency tables from
+class TestCoder : public CTFCoderBase
+{
+ public:
+  TestCoder(OpType op, DetID det = DetID::ITS) : CTFCoderBase(op, 2, det) {}
+
+  void createCoders(const std::vector<char>& bufVec, OpType op) final
+  {
+    auto renormed = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(bufVec.begin(), bufVec.end()), 12);
+    for (int slot = 0; slot < 2; slot++) {
+      createCoder<char>(op, renormed, slot);
+    }
+  }
+
+  // load the external dictionary of given version, as createCodersFromFile does
+  void loadDictionary(uint32_t timeStamp, const std::vector<char>& sample)
+  {
+    mExtHeader.det = mDet;
+    mExtHeader.dictTimeStamp = timeStamp;
+    createCoders(sample, mOpType);
+    storeDictVersion();
+  }
+
+  const void* getCoder(int slot) const { return mCoders[slot].get(); }
+  using CTFCoderBase::checkDictVersion;
+};
+
+std::vector<char> makeSample(int nSymbols, int size)
+{
+  std::vector<char> v(size);
+  for (int i = 0; i < size; i++) {
+    v[i] = char(i % nSymbols);
+  }
+  return v;
+}
+
+CTFDictHeader makeHeader(uint32_t timeStamp)
+{
+  CTFDictHeader h;
+  h.det = DetID::ITS;
+  h.dictTimeStamp = timeStamp;
+  return h;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(DictionaryUpdateAndSelection)
+{
+  TestCoder coder(CTFCoderBase::OpType::Decoder);
+  coder.loadDictionary(100, makeSample(10, 1000));
+  const auto* coderV1 = coder.getCoder(0);
+  BOOST_CHECK_EQUAL(coder.getNDictVersions(), 1u);
+
+  // an update makes the new version current but keeps the earlier one
+  coder.loadDictionary(200, makeSample(20, 1000));
+  const auto* coderV2 = coder.getCoder(0);
+  BOOST_CHECK(coderV1 != coderV2);
+  BOOST_CHECK_EQUAL(coder.getNDictVersions(), 2u);
+  BOOST_CHECK_EQUAL(coder.getExtDictHeader().dictTimeStamp, 200u);
+
+  // the data is decoded with the dictionary it was encoded with
+  coder.checkDictVersion(makeHeader(100));
+  BOOST_CHECK_EQUAL(coder.getExtDictHeader().dictTimeStamp, 100u);
+  BOOST_CHECK_EQUAL(coder.getCoder(0), coderV1);
+  coder.checkDictVersion(makeHeader(200));
+  BOOST_CHECK_EQUAL(coder.getExtDictHeader().dictTimeStamp, 200u);
+  BOOST_CHECK_EQUAL(coder.getCoder(0), coderV2);
+
+  // data encoded without external dictionary does not change the selection
+  coder.checkDictVersion(CTFDictHeader{});
+  BOOST_CHECK_EQUAL(coder.getCoder(0), coderV2);
+
+  // unknown versions or the known one with different format version cannot be decoded
+  BOOST_CHECK_THROW(coder.checkDictVersion(makeHeader(300)), std::runtime_error);
+  auto h = makeHeader(100);
+  h.minorVersion++;
+  BOOST_CHECK_THROW(coder.checkDictVersion(h), std::runtime_error);
+  BOOST_CHECK_EQUAL(coder.getCoder(0), coderV2);
+
+  // encoders only use the current dictionary
+  TestCoder encoder(CTFCoderBase::OpType::Encoder);
+  encoder.loadDictionary(100, makeSample(10, 1000));
+  encoder.loadDictionary(200, makeSample(20, 1000));
+  BOOST_CHECK_EQUAL(encoder.getNDictVersions(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(AdaptiveDictionarySelection)
+{
+  TestCoder coder(CTFCoderBase::OpType::Encoder);
+  coder.loadDictionary(100, makeSample(10, 1000));
+  coder.setAdaptiveDictionary(true);
+
+  // message following the external dictionary
+  auto matching = makeSample(10, 5000);
+  auto sel = coder.selectEncoder(matching, 0);
+  BOOST_CHECK_EQUAL(sel.encoder, coder.getCoder(0));
+  BOOST_CHECK(!sel.frequencyTable);
+
+  // message with symbols absent in the external dictionary: its statistics are passed on to build the block dictionary
+  std::vector<char> other(5000, char(50));
+  for (size_t i = 0; i < other.size(); i += 3) {
+    other[i] = char(60);
+  }
+  sel = coder.selectEncoder(other, 0);
+  BOOST_CHECK(sel.encoder == nullptr);
+  BOOST_REQUIRE(sel.frequencyTable);
+  BOOST_CHECK_EQUAL(sel.frequencyTable->getNumSamples(), other.size());
+
+  // the block is the same as if it was encoded with the statistics collected by the encoding
+  std::vector<char> buffSel, buffRef;
+  TestBlocks::create(buffSel);
+  TestBlocks::create(buffRef);
+  TestBlocks::get(buffSel.data())->encode(other, 0, 12, Metadata::OptStore::EENCODE, &buffSel, sel);
+  TestBlocks::get(buffRef.data())->encode(other, 0, 12, Metadata::OptStore::EENCODE, &buffRef);
+  const auto &bSel = TestBlocks::get(buffSel.data())->getBlock(0), &bRef = TestBlocks::get(buffRef.data())->getBlock(0);
+  BOOST_REQUIRE_EQUAL(bSel.getNStored(), bRef.getNStored());
+  BOOST_CHECK(bSel.getNDict() > 0);
+  BOOST_CHECK(std::equal(bSel.payload, bSel.payload + bSel.getNStored(), bRef.payload));
+  std::vector<char> dest;
+  TestBlocks::get(buffSel.data())->decode(dest, 0);
+  BOOST_CHECK(dest == other);
+
+  // w/o adaptive mode the external encoder is always used
+  coder.setAdaptiveDictionary(false);
+  BOOST_CHECK_EQUAL(coder.selectEncoder(other, 0).encoder, coder.getCoder(0));
+}
+
+BOOST_AUTO_TEST_CASE(SharedCoders)
+{
+  const auto n0 = CTFCoderBase::getNSharedCoders();
+  {
+    TestCoder coderA(CTFCoderBase::OpType::Decoder), coderB(CTFCoderBase::OpType::Decoder);
+    coderA.loadDictionary(100, makeSample(10, 1000));
+    BOOST_CHECK_EQUAL(CTFCoderBase::getNSharedCoders(), n0 + 2); // one per slot
+    // the same dictionary: the coders are shared
+    coderB.loadDictionary(100, makeSample(10, 1000));
+    BOOST_CHECK_EQUAL(CTFCoderBase::getNSharedCoders(), n0 + 2);
+    BOOST_CHECK_EQUAL(coderA.getCoder(0), coderB.getCoder(0));
+    BOOST_CHECK_EQUAL(coderA.getCoder(1), coderB.getCoder(1));
+
+    // a different dictionary, the other operation or detector: own coders
+    TestCoder coderC(CTFCoderBase::OpType::Decoder), coderD(CTFCoderBase::OpType::Encoder), coderE(CTFCoderBase::OpType::Decoder, DetID::TPC);
+    coderC.loadDictionary(100, makeSample(11, 1000));
+    coderD.loadDictionary(100, makeSample(10, 1000));
+    coderE.loadDictionary(100, makeSample(10, 1000));
+    BOOST_CHECK(coderC.getCoder(0) != coderA.getCoder(0));
+    BOOST_CHECK(coderD.getCoder(0) != coderA.getCoder(0));
+    BOOST_CHECK(coderE.getCoder(0) != coderA.getCoder(0));
+    BOOST_CHECK_EQUAL(CTFCoderBase::getNSharedCoders(), n0 + 8);
+  }
+  // the cache does not keep the coders alive
+  BOOST_CHECK_EQUAL(CTFCoderBase::getNSharedCoders(), n0);
+}
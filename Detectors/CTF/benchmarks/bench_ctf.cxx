@@ -0,0 +1,893 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_ctf.cxx
+/// \brief Throughput of the CTF encoding/decoding of detector payloads, of the dictionary creation and of the EncodedBlocks relocation
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <TRandom3.h>
+
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "rANS/rans.h"
+#include "ITSMFTReconstruction/CTFCoder.h"
+#include "DataFormatsITSMFT/CTF.h"
+#include "TPCReconstruction/CTFCoder.h"
+#include "DataFormatsTPC/CTF.h"
+#include "TOFReconstruction/CTFCoder.h"
+#include "TOFBase/Geo.h"
+#include "TOFBase/Digit.h"
+#include "DataFormatsTOF/CTF.h"
+#include "MCHCTF/CTFCoder.h"
+#include "DataFormatsMCH/CTF.h"
+#include "EMCALReconstruction/CTFCoder.h"
+#include "DataFormatsEMCAL/CTF.h"
+#include "MIDCTF/CTFCoder.h"
+#include "DataFormatsMID/CTF.h"
+#include "FT0Reconstruction/CTFCoder.h"
+#include "FT0Base/Geometry.h"
+#include "FV0Reconstruction/CTFCoder.h"
+#include "FV0Base/Constants.h"
+#include "FDDReconstruction/CTFCoder.h"
+#include "FDDBase/Constants.h"
+#include "ZDCReconstruction/CTFCoder.h"
+#include "ZDCBase/Constants.h"
+#include "CommonConstants/LHCConstants.h"
+#include "PHOSReconstruction/CTFCoder.h"
+#include "DataFormatsPHOS/CTF.h"
+#include "CPVReconstruction/CTFCoder.h"
+#include "DataFormatsCPV/CTF.h"
+#include "HMPIDReconstruction/CTFCoder.h"
+#include "DataFormatsHMP/CTF.h"
+#include "TRDReconstruction/CTFCoder.h"
+#include "DataFormatsTRD/CTF.h"
+#include "CTPReconstruction/CTFCoder.h"
+#include "DataFormatsCTP/CTF.h"
+#include "DataFormatsCTP/Digits.h"
+
+using OpType = o2::ctf::CTFCoderBase::OpType;
+using Buffer = std::vector<o2::ctf::BufferType>;
+
+// Every payload generates synthetic data of a single TF, modelled after the CTF IO tests, with the size
+// scaled by the number of readout frames/triggers. It owns an encoder and a decoder, so that the benchmarks
+// measure the per-TF cost only.
+
+//_________________________________________________
+template <o2::detectors::DetID::ID DET>
+struct ITSMFTPayload {
+  using CTF = o2::itsmft::CTF;
+  std::vector<o2::itsmft::ROFRecord> rofs, rofsD;
+  std::vector<o2::itsmft::CompClusterExt> clusters, clustersD;
+  std::vector<unsigned char> patterns, patternsD;
+  o2::itsmft::LookUp lookup;
+  o2::itsmft::CTFCoder encoder{OpType::Encoder, DET};
+  o2::itsmft::CTFCoder decoder{OpType::Decoder, DET};
+
+  void generate(int nROFs, TRandom& rnd)
+  {
+    std::vector<int> row, col;
+    for (int irof = 0; irof < nROFs; irof++) {
+      auto& rofr = rofs.emplace_back();
+      rofr.getBCData().orbit = irof / 10;
+      rofr.getBCData().bc = irof % 10;
+      rofr.setFirstEntry(clusters.size());
+      int chipID = rnd.Integer(100);
+      for (int ichip = 0; ichip < 50; ichip++) {
+        int nhits = rnd.Poisson(50);
+        row.resize(nhits);
+        col.resize(nhits);
+        for (int i = 0; i < nhits; i++) {
+          row[i] = rnd.Integer(512);
+          col[i] = rnd.Integer(1024);
+        }
+        std::sort(col.begin(), col.end());
+        for (int i = 0; i < nhits; i++) {
+          auto& cl = clusters.emplace_back(row[i], col[i], rnd.Integer(1000), chipID);
+          if (cl.getPatternID() > 900) {
+            for (int ib = 1 + rnd.Poisson(3.); ib--;) {
+              patterns.push_back(rnd.Integer(256));
+            }
+          }
+        }
+        chipID += 1 + rnd.Poisson(10);
+      }
+      rofr.setNEntries(int(clusters.size()) - rofr.getFirstEntry());
+    }
+  }
+
+  size_t rawSize() const { return rofs.size() * sizeof(rofs[0]) + clusters.size() * sizeof(clusters[0]) + patterns.size(); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, rofs, clusters, patterns);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), rofsD, clustersD, patternsD, nullptr, lookup);
+  }
+};
+
+struct ITSPayload : ITSMFTPayload<o2::detectors::DetID::ITS> {
+};
+struct MFTPayload : ITSMFTPayload<o2::detectors::DetID::MFT> {
+};
+
+//_________________________________________________
+struct TPCPayload {
+  using CTF = o2::tpc::CTF;
+  o2::tpc::CompressedClusters clusters;
+  std::vector<char> clustersBuffer, clustersD;
+  size_t clustersSize = 0;
+  o2::tpc::CTFCoder encoder{OpType::Encoder};
+  o2::tpc::CTFCoder decoder{OpType::Decoder};
+
+  TPCPayload()
+  {
+    encoder.setCombineColumns(true);
+    decoder.setCombineColumns(true);
+  }
+
+  void generate(int nTracks, TRandom& rnd)
+  {
+    auto& c = clusters;
+    c.nTracks = nTracks;
+    c.nUnattachedClusters = 50 * nTracks;
+    c.nAttachedClusters = 0;
+    std::vector<unsigned short> nTrackClusters(nTracks);
+    for (auto& n : nTrackClusters) {
+      n = 10 + rnd.Integer(142);
+      c.nAttachedClusters += n;
+    }
+    c.nAttachedClustersReduced = c.nAttachedClusters - c.nTracks;
+    clustersSize = o2::tpc::CTFCoder::estimateSize(c);
+    clustersBuffer.resize(clustersSize);
+    void* buff = clustersBuffer.data();
+    o2::tpc::CTFCoder::setCompClusAddresses(c, buff);
+
+    for (unsigned int i = 0; i < c.nAttachedClusters; i++) {
+      c.qTotA[i] = 20 + rnd.Exp(100.);
+      c.qMaxA[i] = c.qTotA[i] / (2 + rnd.Integer(4));
+      c.flagsA[i] = rnd.Rndm() < 0.95 ? 0 : 1 << rnd.Integer(8);
+      c.sigmaPadA[i] = rnd.Integer(64);
+      c.sigmaTimeA[i] = rnd.Integer(64);
+    }
+    for (unsigned int i = 0; i < c.nAttachedClustersReduced; i++) {
+      c.rowDiffA[i] = 1 + rnd.Poisson(0.2);
+      c.sliceLegDiffA[i] = rnd.Rndm() < 0.98 ? 0 : rnd.Integer(36);
+      c.padResA[i] = int(rnd.Gaus(0., 20.)) & 0xffff;
+      c.timeResA[i] = int(rnd.Gaus(0., 40.)) & 0xffffff;
+    }
+    for (unsigned int i = 0; i < c.nTracks; i++) {
+      c.qPtA[i] = rnd.Integer(128);
+      c.rowA[i] = rnd.Integer(152);
+      c.sliceA[i] = rnd.Integer(36);
+      c.timeA[i] = rnd.Integer(114048 * 16);
+      c.padA[i] = rnd.Integer(140 * 64);
+      c.nTrackClusters[i] = nTrackClusters[i];
+    }
+    for (unsigned int i = 0; i < c.nUnattachedClusters; i++) {
+      c.qTotU[i] = 20 + rnd.Exp(50.);
+      c.qMaxU[i] = c.qTotU[i] / (2 + rnd.Integer(4));
+      c.flagsU[i] = rnd.Rndm() < 0.95 ? 0 : 1 << rnd.Integer(8);
+      c.padDiffU[i] = rnd.Integer(140 * 64);
+      c.timeDiffU[i] = rnd.Exp(200.);
+      c.sigmaPadU[i] = rnd.Integer(64);
+      c.sigmaTimeU[i] = rnd.Integer(64);
+    }
+    // distribute the unattached clusters over the slice rows
+    std::fill(c.nSliceRowClusters, c.nSliceRowClusters + c.nSliceRows, 0);
+    for (unsigned int i = 0; i < c.nUnattachedClusters; i++) {
+      c.nSliceRowClusters[rnd.Integer(c.nSliceRows)]++;
+    }
+  }
+
+  size_t rawSize() const { return clustersSize; }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, clusters);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    clustersD.clear();
+    decoder.decode(CTF::getImage(buff.data()), clustersD);
+  }
+};
+
+//_________________________________________________
+struct TOFPayload {
+  using CTF = o2::tof::CTF;
+  using Geo = o2::tof::Geo;
+  std::vector<o2::tof::ReadoutWindowData> rows, rowsD;
+  std::vector<o2::tof::Digit> digits, digitsD;
+  std::vector<uint8_t> patterns, patternsD;
+  o2::tof::CTFCoder encoder{OpType::Encoder};
+  o2::tof::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nROFs, TRandom& rnd)
+  {
+    std::vector<int> strips;
+    for (int irof = 0; irof < nROFs; irof++) {
+      auto& rofr = rows.emplace_back();
+      int orbit = irof / Geo::NWINDOW_IN_ORBIT;
+      int bc = Geo::BC_IN_ORBIT / Geo::NWINDOW_IN_ORBIT * (irof % Geo::NWINDOW_IN_ORBIT);
+      rofr.SetOrbit(orbit);
+      rofr.SetBC(bc);
+      int ndig = rnd.Poisson(50);
+      rofr.setFirstEntry(digits.size());
+      rofr.setNEntries(ndig);
+      rofr.setFirstEntryDia(patterns.size());
+      rofr.setNEntriesDia(0);
+      strips.resize(ndig);
+      for (auto& s : strips) {
+        s = rnd.Integer(Geo::NSTRIPS);
+      }
+      std::sort(strips.begin(), strips.end());
+      for (auto s : strips) {
+        uint64_t digBC = uint64_t(Geo::BC_IN_ORBIT) * orbit + bc + rnd.Integer(Geo::BC_IN_ORBIT / Geo::NWINDOW_IN_ORBIT);
+        digits.emplace_back(s * Geo::NPADS + rnd.Integer(Geo::NPADS), rnd.Integer(1024), rnd.Integer(2048), digBC);
+      }
+      std::sort(digits.begin() + rofr.first(), digits.end(), [](const o2::tof::Digit& a, const o2::tof::Digit& b) {
+        int strip1 = a.getChannel() / Geo::NPADS, strip2 = b.getChannel() / Geo::NPADS;
+        if (strip1 == strip2) {
+          return a.getBC() == b.getBC() ? a.getTDC() < b.getTDC() : a.getBC() < b.getBC();
+        }
+        return strip1 < strip2;
+      });
+    }
+  }
+
+  size_t rawSize() const { return rows.size() * sizeof(rows[0]) + digits.size() * sizeof(digits[0]) + patterns.size(); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, rows, digits, patterns);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), rowsD, digitsD, patternsD);
+  }
+};
+
+//_________________________________________________
+struct MCHPayload {
+  using CTF = o2::mch::CTF;
+  std::vector<o2::mch::ROFRecord> rofs, rofsD;
+  std::vector<o2::mch::Digit> digits, digitsD;
+  o2::mch::CTFCoder encoder{OpType::Encoder};
+  o2::mch::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nROFs, TRandom& rnd)
+  {
+    o2::InteractionRecord ir0(3, 5), ir(ir0);
+    for (int irof = 0; irof < nROFs; irof++) {
+      ir += 1 + rnd.Integer(200);
+      int nch = 1 + rnd.Poisson(20);
+      int start = digits.size();
+      for (int ich = 0; ich < nch; ich++) {
+        int16_t detID = 100 + rnd.Integer(1025 - 100);
+        int16_t padID = rnd.Integer(28672);
+        uint32_t adc = rnd.Integer(1024 * 1024);
+        uint16_t nsamp = rnd.Integer(1024);
+        auto& d = digits.emplace_back(detID, padID, adc, ir.differenceInBC(ir0), nsamp);
+        d.setSaturated(rnd.Rndm() > 0.9);
+      }
+      rofs.emplace_back(ir, start, nch);
+    }
+  }
+
+  size_t rawSize() const { return rofs.size() * sizeof(rofs[0]) + digits.size() * sizeof(digits[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, rofs, digits);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), rofsD, digitsD);
+  }
+};
+
+//_________________________________________________
+struct EMCALPayload {
+  using CTF = o2::emcal::CTF;
+  std::vector<o2::emcal::TriggerRecord> triggers, triggersD;
+  std::vector<o2::emcal::Cell> cells, cellsD;
+  o2::emcal::CTFCoder encoder{OpType::Encoder};
+  o2::emcal::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    for (int itrig = 0; itrig < nTriggers; itrig++) {
+      ir += 1 + rnd.Integer(200);
+      auto start = cells.size();
+      for (short tower = rnd.Poisson(10); tower < 17665; tower += 1 + rnd.Integer(100)) {
+        cells.emplace_back(tower, rnd.Exp(2.), rnd.Rndm() * 1500 - 600., (o2::emcal::ChannelType_t)rnd.Integer(5));
+      }
+      triggers.emplace_back(ir, rnd.Integer(0xffff), start, cells.size() - start);
+    }
+  }
+
+  size_t rawSize() const { return triggers.size() * sizeof(triggers[0]) + cells.size() * sizeof(cells[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, triggers, cells);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), triggersD, cellsD);
+  }
+};
+
+//_________________________________________________
+struct MIDPayload {
+  using CTF = o2::mid::CTF;
+  std::array<std::vector<o2::mid::ColumnData>, o2::mid::NEvTypes> columns{}, columnsD{};
+  std::array<std::vector<o2::mid::ROFRecord>, o2::mid::NEvTypes> rofs{}, rofsD{};
+  o2::mid::CTFHelper::TFData tfData;
+  o2::mid::CTFCoder encoder{OpType::Encoder};
+  o2::mid::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nROFs, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    std::array<uint16_t, 5> pattern;
+    for (int irof = 0; irof < nROFs; irof++) {
+      ir += 1 + rnd.Integer(200);
+      for (uint8_t evtyp = 0; evtyp < o2::mid::NEvTypes; evtyp++) {
+        if (rnd.Rndm() > 0.8) {
+          continue;
+        }
+        int nch = 1 + rnd.Poisson(10);
+        auto start = columns[evtyp].size();
+        for (int ich = 0; ich < nch; ich++) {
+          uint8_t deId = rnd.Integer(128);
+          uint8_t columnId = rnd.Integer(128);
+          for (auto& p : pattern) {
+            p = rnd.Integer(0x7fff);
+          }
+          columns[evtyp].emplace_back(o2::mid::ColumnData{deId, columnId, pattern});
+        }
+        rofs[evtyp].emplace_back(o2::mid::ROFRecord{ir, o2::mid::EventType(evtyp), start, columns[evtyp].size() - start});
+      }
+    }
+    for (uint32_t i = 0; i < o2::mid::NEvTypes; i++) {
+      tfData.colData[i] = {columns[i].data(), columns[i].size()};
+      tfData.rofData[i] = {rofs[i].data(), rofs[i].size()};
+    }
+    tfData.buildReferences();
+  }
+
+  size_t rawSize() const
+  {
+    size_t sz = 0;
+    for (uint32_t i = 0; i < o2::mid::NEvTypes; i++) {
+      sz += rofs[i].size() * sizeof(o2::mid::ROFRecord) + columns[i].size() * sizeof(o2::mid::ColumnData);
+    }
+    return sz;
+  }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, tfData);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), rofsD, columnsD);
+  }
+};
+
+//_________________________________________________
+// FT0 and FV0 digits share the same layout: a trigger record per BC pointing to the fired channels
+template <typename Coder, typename CTFT, typename Digit, typename ChannelData, int NChannels>
+struct FITPayload {
+  using CTF = CTFT;
+  std::vector<Digit> digits, digitsD;
+  std::vector<ChannelData> channels, channelsD;
+  Coder encoder{OpType::Encoder};
+  Coder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    for (int idig = 0; idig < nTriggers; idig++) {
+      ir += 1 + rnd.Integer(200);
+      auto start = channels.size();
+      int8_t nChanA = 0, nChanC = 0;
+      int32_t ampTotA = 0, ampTotC = 0;
+      for (int ich = rnd.Poisson(4); ich < NChannels; ich += 1 + rnd.Poisson(4)) {
+        int16_t t = -2048 + rnd.Integer(2048 * 2);
+        uint16_t q = rnd.Integer(4096);
+        channels.emplace_back(ich, t, q, rnd.Rndm() > 0.5 ? 0 : 1);
+        if (ich < NChannels / 2) {
+          nChanA++;
+          ampTotA += q;
+        } else {
+          nChanC++;
+          ampTotC += q;
+        }
+      }
+      o2::fit::Triggers trig;
+      trig.setTriggers(rnd.Integer(128), nChanA, nChanC, ampTotA / 8, ampTotC / 8, rnd.Integer(256), rnd.Integer(256));
+      digits.emplace_back(start, channels.size() - start, ir, trig, idig);
+    }
+  }
+
+  size_t rawSize() const { return digits.size() * sizeof(Digit) + channels.size() * sizeof(ChannelData); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, digits, channels);
+    encoder.template finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), digitsD, channelsD);
+  }
+};
+
+struct FT0Payload : FITPayload<o2::ft0::CTFCoder, o2::ft0::CTF, o2::ft0::Digit, o2::ft0::ChannelData, 4 * (o2::ft0::Geometry::NCellsA + o2::ft0::Geometry::NCellsC)> {
+};
+struct FV0Payload : FITPayload<o2::fv0::CTFCoder, o2::fv0::CTF, o2::fv0::Digit, o2::fv0::ChannelData, o2::fv0::Constants::nChannelsPerPm * o2::fv0::Constants::nPms> {
+};
+
+// FDD digits have no event ID
+struct FDDPayload {
+  using CTF = o2::fdd::CTF;
+  std::vector<o2::fdd::Digit> digits, digitsD;
+  std::vector<o2::fdd::ChannelData> channels, channelsD;
+  o2::fdd::CTFCoder encoder{OpType::Encoder};
+  o2::fdd::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    for (int idig = 0; idig < nTriggers; idig++) {
+      ir += 1 + rnd.Integer(200);
+      auto start = channels.size();
+      int8_t nChanA = 0, nChanC = 0;
+      int32_t ampTotA = 0, ampTotC = 0;
+      for (int ich = rnd.Poisson(4); ich < o2::fdd::Nchannels; ich += 1 + rnd.Poisson(4)) {
+        int16_t t = -2048 + rnd.Integer(2048 * 2);
+        uint16_t q = rnd.Integer(4096);
+        channels.emplace_back(ich, t, q, rnd.Rndm() > 0.5 ? 0 : 1);
+        if (ich > 7) {
+          nChanA++;
+          ampTotA += q;
+        } else {
+          nChanC++;
+          ampTotC += q;
+        }
+      }
+      o2::fdd::Triggers trig;
+      trig.setTriggers(rnd.Integer(128), nChanA, nChanC, ampTotA / 8, ampTotC / 8, rnd.Integer(256), rnd.Integer(256));
+      digits.emplace_back(start, channels.size() - start, ir, trig);
+    }
+  }
+
+  size_t rawSize() const { return digits.size() * sizeof(digits[0]) + channels.size() * sizeof(channels[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, digits, channels);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), digitsD, channelsD);
+  }
+};
+
+//_________________________________________________
+struct ZDCPayload {
+  using CTF = o2::zdc::CTF;
+  std::vector<o2::zdc::BCData> bcdata, bcdataD;
+  std::vector<o2::zdc::ChannelData> chandata, chandataD;
+  std::vector<o2::zdc::OrbitData> pedsdata, pedsdataD;
+  o2::zdc::CTFCoder encoder{OpType::Encoder};
+  o2::zdc::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nBCs, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    std::array<float, o2::zdc::NTimeBinsPerBC> chanVals;
+    for (int irof = 0; irof < nBCs; irof++) {
+      ir += 1 + rnd.Integer(100);
+      uint32_t channPatt = 0, triggers = 0;
+      int firstChEntry = chandata.size();
+      for (int ich = rnd.Poisson(2.); ich < o2::zdc::NDigiChannels; ich += 1 + rnd.Poisson(2.)) {
+        channPatt |= 0x1 << ich;
+        for (auto& v : chanVals) {
+          v = rnd.Integer(0xffff);
+        }
+        if (rnd.Rndm() > 0.4) {
+          triggers |= 0x1 << ich;
+        }
+        chandata.emplace_back(ich, chanVals);
+      }
+      auto& bcd = bcdata.emplace_back(firstChEntry, chandata.size() - firstChEntry, ir, channPatt, triggers, rnd.Integer(0xff));
+      for (int im = 0; im < o2::zdc::NModules; im++) {
+        bcd.moduleTriggers[im] = rnd.Rndm() > 0.7 ? rnd.Integer((0x1 << 10) - 1) : 0;
+      }
+    }
+    // one pedestal record per orbit
+    const auto &irFirst = bcdata.front().ir, irLast = bcdata.back().ir;
+    o2::InteractionRecord irPed(o2::constants::lhc::LHCMaxBunches - 1, irFirst.orbit);
+    pedsdata.resize(irLast.orbit - irFirst.orbit + 1);
+    for (auto& ped : pedsdata) {
+      ped.ir = irPed;
+      for (int ic = 0; ic < o2::zdc::NChannels; ic++) {
+        ped.data[ic] = rnd.Integer(0xffff);
+        ped.scaler[ic] = rnd.Integer(20);
+      }
+      irPed.orbit++;
+    }
+  }
+
+  size_t rawSize() const { return bcdata.size() * sizeof(bcdata[0]) + chandata.size() * sizeof(chandata[0]) + pedsdata.size() * sizeof(pedsdata[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, bcdata, chandata, pedsdata);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), bcdataD, chandataD, pedsdataD);
+  }
+};
+
+//_________________________________________________
+struct PHSPayload {
+  using CTF = o2::phos::CTF;
+  std::vector<o2::phos::TriggerRecord> triggers, triggersD;
+  std::vector<o2::phos::Cell> cells, cellsD;
+  o2::phos::CTFCoder encoder{OpType::Encoder};
+  o2::phos::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    using namespace o2::phos;
+    o2::InteractionRecord ir(0, 0);
+    for (int itrig = 0; itrig < nTriggers; itrig++) {
+      ir += 1 + rnd.Integer(200);
+      auto start = cells.size();
+      for (int i = 1 + rnd.Poisson(100); i--;) {
+        ChannelType_t tp = rnd.Rndm() > 0.5 ? (rnd.Rndm() > 0.5 ? TRU2x2 : TRU4x4) : (rnd.Rndm() > 0.5 ? HIGH_GAIN : LOW_GAIN);
+        uint16_t id = (tp == TRU2x2 || tp == TRU4x4) ? 3000 : rnd.Integer(kNmaxCell);
+        cells.emplace_back(id, rnd.Rndm() * 160., rnd.Rndm() * 3.00e-07 - 0.3e-9, tp);
+      }
+      triggers.emplace_back(ir, start, cells.size() - start);
+    }
+  }
+
+  size_t rawSize() const { return triggers.size() * sizeof(triggers[0]) + cells.size() * sizeof(cells[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, triggers, cells);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), triggersD, cellsD);
+  }
+};
+
+//_________________________________________________
+struct CPVPayload {
+  using CTF = o2::cpv::CTF;
+  std::vector<o2::cpv::TriggerRecord> triggers, triggersD;
+  std::vector<o2::cpv::Cluster> clusters, clustersD;
+  o2::cpv::CTFCoder encoder{OpType::Encoder};
+  o2::cpv::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    for (int itrig = 0; itrig < nTriggers; itrig++) {
+      ir += 1 + rnd.Integer(200);
+      auto start = clusters.size();
+      for (int i = 1 + rnd.Poisson(100); i--;) {
+        char mult = rnd.Integer(30);
+        char mod = 2 + rnd.Integer(3); // there are M2, M3 and M4
+        char exMax = rnd.Integer(3);
+        float x = 72.3 * 2. * (rnd.Rndm() - 0.5);
+        float z = 63.3 * 2. * (rnd.Rndm() - 0.5);
+        clusters.emplace_back(mult, mod, exMax, x, z, 10000. * rnd.Rndm());
+      }
+      triggers.emplace_back(ir, start, clusters.size() - start);
+    }
+  }
+
+  size_t rawSize() const { return triggers.size() * sizeof(triggers[0]) + clusters.size() * sizeof(clusters[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, triggers, clusters);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), triggersD, clustersD);
+  }
+};
+
+//_________________________________________________
+struct HMPPayload {
+  using CTF = o2::hmpid::CTF;
+  std::vector<o2::hmpid::Trigger> triggers, triggersD;
+  std::vector<o2::hmpid::Digit> digits, digitsD;
+  o2::hmpid::CTFCoder encoder{OpType::Encoder};
+  o2::hmpid::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(0, 0);
+    for (int itrig = 0; itrig < nTriggers; itrig++) {
+      ir += 1 + rnd.Integer(200);
+      auto start = digits.size();
+      for (int chID = rnd.Integer(10); chID < 0xff; chID += rnd.Integer(10)) {
+        digits.emplace_back(chID, rnd.Integer(0xff), rnd.Integer(0xff), rnd.Integer(0xff), rnd.Integer(0xffff));
+      }
+      triggers.emplace_back(ir, start, digits.size() - start);
+    }
+  }
+
+  size_t rawSize() const { return triggers.size() * sizeof(triggers[0]) + digits.size() * sizeof(digits[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, triggers, digits);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), triggersD, digitsD);
+  }
+};
+
+//_________________________________________________
+struct TRDPayload {
+  using CTF = o2::trd::CTF;
+  std::vector<o2::trd::TriggerRecord> triggers, triggersD;
+  std::vector<o2::trd::Tracklet64> tracklets, trackletsD;
+  std::vector<o2::trd::Digit> digits, digitsD;
+  o2::trd::CTFCoder encoder{OpType::Encoder};
+  o2::trd::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    constexpr int NHCID = 2 * 540;
+    constexpr uint32_t formatTrk = 5;
+    o2::trd::ArrayADC adc;
+    o2::InteractionRecord ir(0, 0);
+    for (int itrig = 0; itrig < nTriggers; itrig++) {
+      ir += 1 + rnd.Integer(600);
+      bool doDigits = rnd.Rndm() > 0.8;
+      auto startTrk = tracklets.size();
+      auto startDig = digits.size();
+      for (int cid = rnd.Poisson(5); cid < NHCID; cid += rnd.Poisson(5)) {
+        int hcid = cid / 2;
+        int nTrk = rnd.Poisson(3);
+        int nDig = doDigits ? nTrk * 5 * (1. + rnd.Rndm()) : 0;
+        for (int i = nTrk; i--;) {
+          tracklets.emplace_back(formatTrk, hcid, rnd.Integer(0x1 << 4), rnd.Integer(0x1 << 2),
+                                 rnd.Integer(0x1 << 11), rnd.Integer(0x1 << 8), rnd.Integer(0x1 << 24));
+        }
+        for (int i = nDig; i--;) {
+          auto& dig = digits.emplace_back(cid, rnd.Integer(0x1 << 8), rnd.Integer(0x1 << 8), rnd.Integer(0x1 << 8));
+          for (auto& a : adc) {
+            a = rnd.Integer(0x1 << 16);
+          }
+          dig.setADC(adc);
+        }
+      }
+      triggers.emplace_back(ir, startDig, digits.size() - startDig, startTrk, tracklets.size() - startTrk);
+    }
+  }
+
+  size_t rawSize() const { return triggers.size() * sizeof(triggers[0]) + tracklets.size() * sizeof(tracklets[0]) + digits.size() * sizeof(digits[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, triggers, tracklets, digits);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), triggersD, trackletsD, digitsD);
+  }
+};
+
+//_________________________________________________
+struct CTPPayload {
+  using CTF = o2::ctp::CTF;
+  std::vector<o2::ctp::CTPDigit> digits, digitsD;
+  o2::ctp::CTFCoder encoder{OpType::Encoder};
+  o2::ctp::CTFCoder decoder{OpType::Decoder};
+
+  void generate(int nTriggers, TRandom& rnd)
+  {
+    o2::InteractionRecord ir(3, 5);
+    for (int itrg = 0; itrg < nTriggers; itrg++) {
+      ir += 1 + rnd.Integer(200);
+      auto& dig = digits.emplace_back();
+      dig.intRecord = ir;
+      dig.CTPInputMask |= (uint64_t(rnd.Integer(0xffffffff)) << 32) | rnd.Integer(0xffffffff);
+      dig.CTPClassMask |= (uint64_t(rnd.Integer(0xffffffff)) << 32) | rnd.Integer(0xffffffff);
+    }
+  }
+
+  size_t rawSize() const { return digits.size() * sizeof(digits[0]); }
+
+  void encode(Buffer& buff)
+  {
+    encoder.encode(buff, digits);
+    encoder.finaliseCTFOutput<CTF>(buff);
+  }
+
+  void decode(const Buffer& buff)
+  {
+    decoder.decode(CTF::getImage(buff.data()), digitsD);
+  }
+};
+
+//_________________________________________________
+// args: {TF size in readout frames/triggers/tracks, number of interleaved rANS streams}
+static void CTFArguments(benchmark::internal::Benchmark* b)
+{
+  for (int n : {128, 1024}) {
+    for (int nStreams : {0, 4, 16}) {
+      b->Args({n, nStreams});
+    }
+  }
+  b->Unit(benchmark::kMillisecond);
+}
+
+template <typename P>
+static void BM_CTFEncode(benchmark::State& state)
+{
+  TRandom3 rnd(12345);
+  P payload;
+  payload.generate(state.range(0), rnd);
+  payload.encoder.setNInterleavedStreams(state.range(1));
+  Buffer buff;
+  for (auto _ : state) {
+    buff.clear();
+    payload.encode(buff);
+    benchmark::DoNotOptimize(buff.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * payload.rawSize());
+  state.counters["compression"] = double(payload.rawSize()) / (buff.size() * sizeof(o2::ctf::BufferType));
+}
+
+template <typename P>
+static void BM_CTFDecode(benchmark::State& state)
+{
+  TRandom3 rnd(12345);
+  P payload;
+  payload.generate(state.range(0), rnd);
+  payload.encoder.setNInterleavedStreams(state.range(1));
+  Buffer buff;
+  payload.encode(buff);
+  for (auto _ : state) {
+    payload.decode(buff);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * payload.rawSize());
+}
+
+#define CTF_BENCHMARKS(P)                                     \
+  BENCHMARK_TEMPLATE(BM_CTFEncode, P)->Apply(CTFArguments); \
+  BENCHMARK_TEMPLATE(BM_CTFDecode, P)->Apply(CTFArguments)
+
+CTF_BENCHMARKS(ITSPayload);
+CTF_BENCHMARKS(MFTPayload);
+CTF_BENCHMARKS(TPCPayload);
+CTF_BENCHMARKS(TRDPayload);
+CTF_BENCHMARKS(TOFPayload);
+CTF_BENCHMARKS(PHSPayload);
+CTF_BENCHMARKS(CPVPayload);
+CTF_BENCHMARKS(EMCALPayload);
+CTF_BENCHMARKS(HMPPayload);
+CTF_BENCHMARKS(MCHPayload);
+CTF_BENCHMARKS(MIDPayload);
+CTF_BENCHMARKS(ZDCPayload);
+CTF_BENCHMARKS(FT0Payload);
+CTF_BENCHMARKS(FV0Payload);
+CTF_BENCHMARKS(FDDPayload);
+CTF_BENCHMARKS(CTPPayload);
+
+//_________________________________________________
+// creation of the per-TF dictionary and of the encoder from it, as done for the blocks w/o external dictionary
+static void BM_DictionaryBuild(benchmark::State& state)
+{
+  TRandom3 rnd(12345);
+  std::vector<int16_t> source(state.range(0));
+  for (auto& s : source) {
+    s = int16_t(rnd.Gaus(0., state.range(1)));
+  }
+  for (auto _ : state) {
+    auto frequencyTable = o2::rans::makeFrequencyTableFromSamples(source.begin(), source.end());
+    auto renormedFrequencyTable = o2::rans::renorm(std::move(frequencyTable));
+    o2::rans::LiteralEncoder64<int16_t> encoder{renormedFrequencyTable};
+    benchmark::DoNotOptimize(encoder);
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * source.size() * sizeof(int16_t));
+}
+
+BENCHMARK(BM_DictionaryBuild)->Args({1 << 16, 10})->Args({1 << 20, 10})->Args({1 << 20, 1000})->Unit(benchmark::kMicrosecond);
+
+//_________________________________________________
+// growth of the output buffer by EncodedBlocks::expand (reallocation + relocation of the blocks) and
+// relocation of a const buffer to a CTF image, both are done for every TF
+static void BM_EncodedBlocksExpand(benchmark::State& state)
+{
+  using CTF = o2::itsmft::CTF;
+  TRandom3 rnd(12345);
+  ITSPayload payload;
+  payload.generate(state.range(0), rnd);
+  Buffer source;
+  payload.encode(source);
+  Buffer buff;
+  for (auto _ : state) {
+    buff = source;
+    benchmark::DoNotOptimize(CTF::expand(buff, 2 * buff.size()));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * source.size());
+}
+
+BENCHMARK(BM_EncodedBlocksExpand)->Arg(128)->Arg(1024)->Unit(benchmark::kMicrosecond);
+
+static void BM_EncodedBlocksGetImage(benchmark::State& state)
+{
+  using CTF = o2::itsmft::CTF;
+  TRandom3 rnd(12345);
+  ITSPayload payload;
+  payload.generate(state.range(0), rnd);
+  Buffer source;
+  payload.encode(source);
+  for (auto _ : state) {
+    auto image = CTF::getImage(source.data());
+    benchmark::DoNotOptimize(image);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_EncodedBlocksGetImage)->Arg(128)->Unit(benchmark::kNanosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,143 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test CTFQueue
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "CTFWorkflow/CTFQueue.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace o2::ctf;
+
+// the CTFWriter pattern: the processing thread queues the CTFs, the writer thread writes them
+BOOST_AUTO_TEST_CASE(AsyncWriting)
+{
+  const size_t maxQueued = 3, nCTFs = 50;
+  CTFQueue<int> queue(maxQueued);
+  std::vector<int> written;
+  std::atomic<size_t> maxSeen{0};
+  std::thread writer([&]() {
+    while (auto ctf = queue.pop()) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200)); // slower than the processing
+      written.push_back(*ctf);
+    }
+  });
+  for (size_t i = 0; i < nCTFs; i++) {
+    BOOST_CHECK(queue.push(std::make_unique<int>(i)));
+    size_t sz = queue.size(), prev = maxSeen;
+    while (sz > prev && !maxSeen.compare_exchange_weak(prev, sz)) {
+    }
+  }
+  queue.close(); // the CTFs still queued are written before the writer exits
+  writer.join();
+  BOOST_CHECK(maxSeen <= maxQueued);
+  BOOST_REQUIRE_EQUAL(written.size(), nCTFs);
+  for (size_t i = 0; i < nCTFs; i++) {
+    BOOST_CHECK_EQUAL(written[i], int(i));
+  }
+  BOOST_CHECK(!queue.getError());
+  BOOST_CHECK(!queue.push(std::make_unique<int>(0))); // nothing is accepted after the closure
+}
+
+// a failure of the writer thread is reported to the processing thread, which must not block on the full queue
+BOOST_AUTO_TEST_CASE(AsyncWritingFailure)
+{
+  CTFQueue<int> queue(2);
+  std::thread writer([&]() {
+    while (auto ctf = queue.pop()) {
+      try {
+        if (*ctf == 5) {
+          throw std::runtime_error("disk full");
+        }
+      } catch (...) {
+        queue.close(std::current_exception());
+        queue.clear();
+        break;
+      }
+    }
+  });
+  bool thrown = false;
+  for (int i = 0; i < 100 && !thrown; i++) {
+    try {
+      queue.push(std::make_unique<int>(i));
+    } catch (const std::runtime_error& e) {
+      thrown = true;
+      BOOST_CHECK_EQUAL(std::string(e.what()), "disk full");
+    }
+  }
+  writer.join();
+  BOOST_CHECK(thrown);
+  BOOST_CHECK(queue.getError());
+  BOOST_CHECK_EQUAL(queue.size(), 0u);
+}
+
+// the CTFReader pattern: the reading thread reads the CTFs ahead, the processing thread sends them
+BOOST_AUTO_TEST_CASE(ReadAhead)
+{
+  const int nCTFs = 20, failAt = 15;
+  for (bool fail : {false, true}) {
+    CTFQueue<int> queue(4);
+    std::thread reader([&]() {
+      try {
+        for (int i = 0; i < nCTFs; i++) {
+          if (fail && i == failAt) {
+            throw std::runtime_error("corrupted file");
+          }
+          if (!queue.push(std::make_unique<int>(i))) {
+            break;
+          }
+        }
+        queue.close();
+      } catch (...) {
+        queue.close(std::current_exception());
+      }
+    });
+    // the CTFs read before the failure are sent before it is reported
+    int nSent = 0;
+    bool thrown = false;
+    try {
+      while (auto ctf = queue.pop()) {
+        BOOST_CHECK_EQUAL(*ctf, nSent++);
+      }
+    } catch (const std::runtime_error& e) {
+      thrown = true;
+    }
+    reader.join();
+    BOOST_CHECK_EQUAL(thrown, fail);
+    BOOST_CHECK_EQUAL(nSent, fail ? failAt : nCTFs);
+  }
+}
+
+// the processing stops before everything was read: the reading thread waiting on the full queue is released
+BOOST_AUTO_TEST_CASE(ReadAheadStop)
+{
+  CTFQueue<int> queue(2);
+  std::atomic<int> nRead{0};
+  std::thread reader([&]() {
+    for (int i = 0; i < 1000; i++) {
+      if (!queue.push(std::make_unique<int>(i))) {
+        break;
+      }
+      nRead++;
+    }
+  });
+  BOOST_CHECK_EQUAL(*queue.pop(), 0);
+  queue.close();
+  reader.join();
+  BOOST_CHECK(nRead <= 4);
+  queue.clear();
+  BOOST_CHECK(!queue.pop());
+}
@@ -0,0 +1,122 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   CTFQueue.h
+/// @brief  Bounded queue of CTFs passed between the processing thread and the writing or reading-ahead thread
+
+#ifndef O2_CTF_QUEUE_H
+#define O2_CTF_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace o2
+{
+namespace ctf
+{
+
+/// FIFO of at most maxSize CTFs: push waits while the queue is full, pop while it is empty.
+/// The side which stops first closes the queue, optionally with the exception it failed with. After that push does not
+/// add anything and rethrows the exception (if any), pop returns the queued CTFs, then rethrows the exception or returns nullptr.
+template <typename T>
+class CTFQueue
+{
+ public:
+  explicit CTFQueue(size_t maxSize) : mMaxSize(maxSize > 0 ? maxSize : 1) {}
+
+  /// add the CTF, waiting while the queue is full. Returns false if the queue was closed w/o error
+  bool push(std::unique_ptr<T> ctf)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCond.wait(lock, [this] { return mQueue.size() < mMaxSize || mClosed; });
+    if (mClosed) {
+      if (mError) {
+        std::rethrow_exception(mError);
+      }
+      return false;
+    }
+    mQueue.push_back(std::move(ctf));
+    lock.unlock();
+    mCond.notify_all();
+    return true;
+  }
+
+  /// take the oldest CTF, waiting while the queue is empty. Returns nullptr if the queue was closed w/o error and is empty
+  std::unique_ptr<T> pop()
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCond.wait(lock, [this] { return !mQueue.empty() || mClosed; });
+    if (mQueue.empty()) {
+      if (mError) {
+        std::rethrow_exception(mError);
+      }
+      return nullptr;
+    }
+    auto ctf = std::move(mQueue.front());
+    mQueue.pop_front();
+    lock.unlock();
+    mCond.notify_all();
+    return ctf;
+  }
+
+  /// wake up the waiting threads, nothing can be pushed anymore. The 1st error is kept
+  void close(std::exception_ptr error = nullptr)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mClosed = true;
+      if (!mError) {
+        mError = error;
+      }
+    }
+    mCond.notify_all();
+  }
+
+  /// drop the queued CTFs
+  void clear()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mQueue.clear();
+    }
+    mCond.notify_all();
+  }
+
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mQueue.size();
+  }
+  size_t getMaxSize() const { return mMaxSize; }
+  bool isFull() const { return size() >= mMaxSize; }
+
+  std::exception_ptr getError() const
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mError;
+  }
+
+ private:
+  size_t mMaxSize = 1;
+  bool mClosed = false;
+  std::exception_ptr mError{};
+  std::deque<std::unique_ptr<T>> mQueue;
+  mutable std::mutex mMutex;
+  std::condition_variable mCond;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
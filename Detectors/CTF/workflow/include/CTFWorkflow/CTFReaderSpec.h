@@ -33,6 +33,8 @@ struct CTFReaderInp {
   bool allowMissingDetectors = false;
   bool sup0xccdb = false;
   int maxFileCache = 1;
+  int prefetchCTFs = 0; // number of CTFs to read ahead in a separate thread (0: read synchronously)
+  int nReadThreads = 1; // number of threads reading detectors of the CTF in parallel
   int64_t delay_us = 0;
   int maxLoops = 0;
   int maxTFs = -1;
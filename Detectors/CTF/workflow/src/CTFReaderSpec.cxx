@@ -12,8 +12,14 @@
 /// @file   CTFReaderSpec.cxx
 
 #include <vector>
+#include <array>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
 #include <TFile.h>
 #include <TTree.h>
+#include <TROOT.h>
 
 #include "Framework/Logger.h"
 #include "Framework/ControlService.h"
@@ -22,7 +28,9 @@
 #include "CommonUtils/StringUtils.h"
 #include "CommonUtils/FileFetcher.h"
 #include "CTFWorkflow/CTFReaderSpec.h"
+#include "CTFWorkflow/CTFQueue.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "CommonUtils/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "Headers/STFHeader.h"
@@ -76,27 +84,69 @@ class CTFReaderSpec : public o2::framework::Task
   void run(o2::framework::ProcessingContext& pc) final;
 
  private:
+  // payload of the detector, kept alive by the owner (buffer read from the tree or mapping of the flat file) until it is sent
+  struct DetData {
+    const char* data = nullptr;
+    size_t size = 0;
+    std::shared_ptr<const void> owner{};
+    bool inOutput = false; // read directly to the output message
+  };
+  // CTF read from the input and ready to be sent
+  struct CTFData {
+    CTFHeader header{};
+    int counter = 0; // cumulative counter of CTFs seen
+    long entry = 0;  // entry in the input file
+    std::string entryStr{};
+    double readTime = 0.;
+    std::array<DetData, DetID::nDetectors> data{};
+  };
+  // additional handle to the same ROOT file for the parallel reading
+  struct TreeHandle {
+    std::unique_ptr<TFile> file;
+    std::unique_ptr<TTree> tree;
+  };
+  using DetReader = std::function<void(TTree*)>;
+
   void openCTFFile(const std::string& flname);
-  void processTF(ProcessingContext& pc);
+  void closeCTFFile();
+  bool readNextCTF(CTFData& ctf, ProcessingContext* pc = nullptr);
+  void readCTF(CTFData& ctf, ProcessingContext* pc);
+  void sendCTF(ProcessingContext& pc, const CTFData& ctf);
+  void prefetcher();
   void checkTreeEntries();
+  bool isFileOpen() const { return mCTFTree || mCTFFlatFile; }
+  long getNEntries() const { return mCTFTree ? mCTFTree->GetEntries() : mCTFFlatFile->getNCTFs(); }
+  std::string getFileName() const { return mCTFTree ? mCTFFile->GetName() : mCTFFlatFile->getFileName(); }
   void stopReader();
   template <typename C>
-  void processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const;
+  void addDetectorReader(std::vector<DetReader>& readers, DetID det, CTFData& ctf, ProcessingContext* pc) const;
+  template <typename C>
+  void readDetector(DetID det, CTFData& ctf, TTree* tree, ProcessingContext* pc) const;
+  void sendDetector(DetID det, const CTFData& ctf, const CTFHeader& ctfHeader, ProcessingContext& pc) const;
   void setMessageHeader(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& lbl, unsigned subspec = 0) const;
+  void setMessageHeader(o2::header::Stack* stack, const CTFHeader& ctfHeader, const std::string& lbl) const;
   void tryToFixCTFHeader(CTFHeader& ctfHeader) const;
   CTFReaderInp mInput{};
   std::unique_ptr<o2::utils::FileFetcher> mFileFetcher;
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  std::vector<TreeHandle> mExtraTrees; // extra handles of the current ROOT file, for the parallel reading of detectors
+  std::unique_ptr<CTFFlatFileReader> mCTFFlatFile;
   bool mRunning = false;
   bool mUseLocalTFCounter = false;
   int mCTFCounter = 0;
+  int mReadCounter = 0; // counter of CTFs seen by the reading side (may be ahead of mCTFCounter when prefetching)
   int mNFailedFiles = 0;
   int mFilesRead = 0;
   long mLastSendTime = 0L;
   long mCurrTreeEntry = 0;
   size_t mSelIDEntry = 0; // next CTFID to select from the mInput.ctfIDs (if non-empty)
   TStopwatch mTimer;
+
+  // read-ahead of CTFs in the separate thread
+  std::thread mPrefetchThread;
+  std::unique_ptr<CTFQueue<CTFData>> mPrefetched;
+  std::atomic<bool> mStopReading{false};
 };
 
 ///_______________________________________
@@ -118,17 +168,19 @@ void CTFReaderSpec::stopReader()
   if (!mFileFetcher) {
     return;
   }
+  if (mPrefetchThread.joinable()) {
+    mStopReading = true;
+    mPrefetched->close();
+    mPrefetchThread.join();
+    mPrefetched->clear();
+  }
   LOGP(info, "CTFReader stops processing, {} files read, {} files failed", mFilesRead - mNFailedFiles, mNFailedFiles);
   LOGP(info, "CTF reading total timing: Cpu: {:.3f} Real: {:.3f} s for {} TFs in {} loops",
        mTimer.CpuTime(), mTimer.RealTime(), mCTFCounter, mFileFetcher->getNLoops());
   mRunning = false;
   mFileFetcher->stop();
   mFileFetcher.reset();
-  mCTFTree.reset();
-  if (mCTFFile) {
-    mCTFFile->Close();
-  }
-  mCTFFile.reset();
+  closeCTFFile();
 }
 
 ///_______________________________________
@@ -141,6 +193,14 @@ void CTFReaderSpec::init(InitContext& ic)
   mFileFetcher->setMaxFilesInQueue(mInput.maxFileCache);
   mFileFetcher->setMaxLoops(mInput.maxLoops);
   mFileFetcher->start();
+  if (mInput.prefetchCTFs > 0 || mInput.nReadThreads > 1) {
+    ROOT::EnableThreadSafety();
+  }
+  if (mInput.prefetchCTFs > 0) {
+    LOGP(info, "Will read ahead up to {} CTFs using {} thread(s) per CTF", mInput.prefetchCTFs, mInput.nReadThreads);
+    mPrefetched = std::make_unique<CTFQueue<CTFData>>(mInput.prefetchCTFs);
+    mPrefetchThread = std::thread(&CTFReaderSpec::prefetcher, this);
+  }
 }
 
 ///_______________________________________
@@ -148,6 +208,11 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
   try {
     mFilesRead++;
+    if (CTFFlatFileReader::isFlatFile(flname)) { // memory-mapped flat file, its payload is sent w/o deserialization
+      mCTFFlatFile = std::make_unique<CTFFlatFileReader>(flname);
+      mCurrTreeEntry = 0;
+      return;
+    }
     mCTFFile.reset(TFile::Open(flname.c_str()));
     if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
       throw std::runtime_error("failed to open CTF file");
@@ -156,10 +221,21 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
     if (!mCTFTree) {
       throw std::runtime_error("failed to load CTF tree from");
     }
+    for (int i = 1; i < mInput.nReadThreads; i++) { // every reading thread needs its own file handle
+      TreeHandle handle;
+      handle.file.reset(TFile::Open(flname.c_str()));
+      if (handle.file && handle.file->IsOpen() && !handle.file->IsZombie()) {
+        handle.tree.reset((TTree*)handle.file->Get(std::string(o2::base::NameConf::CTFTREENAME).c_str()));
+      }
+      if (!handle.tree) {
+        LOGP(warning, "Failed to open extra handle of {}, will read it with {} threads", flname, mExtraTrees.size() + 1);
+        break;
+      }
+      mExtraTrees.push_back(std::move(handle));
+    }
   } catch (const std::exception& e) {
     LOG(error) << "Cannot process " << flname << ", reason: " << e.what();
-    mCTFTree.reset();
-    mCTFFile.reset();
+    closeCTFFile();
     mNFailedFiles++;
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
@@ -168,6 +244,22 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
   mCurrTreeEntry = 0;
 }
 
+///_______________________________________
+void CTFReaderSpec::closeCTFFile()
+{
+  for (auto& handle : mExtraTrees) {
+    handle.tree.reset();
+    handle.file->Close();
+  }
+  mExtraTrees.clear();
+  mCTFTree.reset();
+  if (mCTFFile) {
+    mCTFFile->Close();
+  }
+  mCTFFile.reset();
+  mCTFFlatFile.reset(); // the mapping is released once the messages sent from it are consumed
+}
+
 ///_______________________________________
 void CTFReaderSpec::run(ProcessingContext& pc)
 {
@@ -177,23 +269,50 @@ void CTFReaderSpec::run(ProcessingContext& pc)
     usleep(1000000);
   }
 
-  std::string tfFileName;
-  if (mCTFCounter >= mInput.maxTFs || (!mInput.ctfIDs.empty() && mSelIDEntry >= mInput.ctfIDs.size())) { // done
-    LOG(info) << "All CTFs from selected range were injected, stopping";
-    mRunning = false;
+  if (mRunning) {
+    std::unique_ptr<CTFData> ctf;
+    if (mInput.prefetchCTFs > 0) {
+      ctf = mPrefetched->pop(); // rethrows the error of the reading thread once the CTFs read before are sent
+    } else {
+      ctf = std::make_unique<CTFData>();
+      if (!readNextCTF(*ctf, &pc)) {
+        ctf.reset();
+      }
+    }
+    if (ctf) {
+      sendCTF(pc, *ctf);
+    } else {
+      mRunning = false;
+    }
   }
 
-  while (mRunning) {
-    if (mCTFTree) { // there is a tree open with multiple CTF
-      if (mInput.ctfIDs.empty() || mInput.ctfIDs[mSelIDEntry] == mCTFCounter) { // no selection requested or matching CTF ID is found
-        LOG(debug) << "TF " << mCTFCounter << " of " << mInput.maxTFs << " loop " << mFileFetcher->getNLoops();
+  if (!mRunning) {
+    pc.services().get<ControlService>().endOfStream();
+    pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
+    stopReader();
+  }
+}
+
+///_______________________________________
+bool CTFReaderSpec::readNextCTF(CTFData& ctf, ProcessingContext* pc)
+{
+  // find next selected CTF, opening new files when needed, and read it. Returns false if there is nothing more to read
+  std::string tfFileName;
+  while (!mStopReading) {
+    if (mReadCounter >= mInput.maxTFs || (!mInput.ctfIDs.empty() && mSelIDEntry >= mInput.ctfIDs.size())) { // done
+      LOG(info) << "All CTFs from selected range were read";
+      return false;
+    }
+    if (isFileOpen()) { // there is a tree or flat file open with multiple CTF
+      if (mInput.ctfIDs.empty() || mInput.ctfIDs[mSelIDEntry] == mReadCounter) { // no selection requested or matching CTF ID is found
+        LOG(debug) << "TF " << mReadCounter << " of " << mInput.maxTFs << " loop " << mFileFetcher->getNLoops();
         mSelIDEntry++;
-        processTF(pc);
-        break;
+        readCTF(ctf, pc);
+        return true;
       } else { // explict CTF ID selection list was provided and current entry is not selected
-        LOGP(info, "Skipping CTF${} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
+        LOGP(info, "Skipping CTF${} ({} of {} in {})", mReadCounter, mCurrTreeEntry, getNEntries(), getFileName());
         checkTreeEntries();
-        mCTFCounter++;
+        mReadCounter++;
         continue;
       }
     }
@@ -201,8 +320,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
     tfFileName = mFileFetcher->getNextFileInQueue();
     if (tfFileName.empty()) {
       if (!mFileFetcher->isRunning()) { // nothing expected in the queue
-        mRunning = false;
-        break;
+        return false;
       }
       usleep(5000); // wait 5ms for the files cache to be filled
       continue;
@@ -210,28 +328,79 @@ void CTFReaderSpec::run(ProcessingContext& pc)
     LOG(info) << "Reading CTF input " << ' ' << tfFileName;
     openCTFFile(tfFileName);
   }
-
-  if (!mRunning) {
-    pc.services().get<ControlService>().endOfStream();
-    pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
-    stopReader();
-  }
+  return false;
 }
 
 ///_______________________________________
-void CTFReaderSpec::processTF(ProcessingContext& pc)
+void CTFReaderSpec::readCTF(CTFData& ctf, ProcessingContext* pc)
 {
   auto cput = mTimer.CpuTime();
   mTimer.Start(false);
 
-  CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
+  ctf.counter = mReadCounter++;
+  ctf.entry = mCurrTreeEntry;
+  if (mCTFFlatFile) {
+    ctf.header = mCTFFlatFile->getCTFHeader(mCurrTreeEntry);
+    if (mCurrTreeEntry + 1 < getNEntries()) {
+      mCTFFlatFile->prefetch(mCurrTreeEntry + 1); // let the kernel read ahead the next CTF while this one is processed
+    }
+  } else if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctf.header, mCurrTreeEntry)) {
     throw std::runtime_error("did not find CTFHeader");
   }
-  if (ctfHeader.creationTime == 0) { // try to repair header with ad hoc data
-    tryToFixCTFHeader(ctfHeader);
+  if (ctf.header.creationTime == 0) { // try to repair header with ad hoc data
+    tryToFixCTFHeader(ctf.header);
   }
 
+  if (!mExtraTrees.empty()) { // the output messages cannot be created by the reading threads
+    pc = nullptr;
+  }
+  std::vector<DetReader> readers;
+  addDetectorReader<o2::itsmft::CTF>(readers, DetID::ITS, ctf, pc);
+  addDetectorReader<o2::itsmft::CTF>(readers, DetID::MFT, ctf, pc);
+  addDetectorReader<o2::emcal::CTF>(readers, DetID::EMC, ctf, pc);
+  addDetectorReader<o2::hmpid::CTF>(readers, DetID::HMP, ctf, pc);
+  addDetectorReader<o2::phos::CTF>(readers, DetID::PHS, ctf, pc);
+  addDetectorReader<o2::tpc::CTF>(readers, DetID::TPC, ctf, pc);
+  addDetectorReader<o2::trd::CTF>(readers, DetID::TRD, ctf, pc);
+  addDetectorReader<o2::ft0::CTF>(readers, DetID::FT0, ctf, pc);
+  addDetectorReader<o2::fv0::CTF>(readers, DetID::FV0, ctf, pc);
+  addDetectorReader<o2::fdd::CTF>(readers, DetID::FDD, ctf, pc);
+  addDetectorReader<o2::tof::CTF>(readers, DetID::TOF, ctf, pc);
+  addDetectorReader<o2::mid::CTF>(readers, DetID::MID, ctf, pc);
+  addDetectorReader<o2::mch::CTF>(readers, DetID::MCH, ctf, pc);
+  addDetectorReader<o2::cpv::CTF>(readers, DetID::CPV, ctf, pc);
+  addDetectorReader<o2::zdc::CTF>(readers, DetID::ZDC, ctf, pc);
+  addDetectorReader<o2::ctp::CTF>(readers, DetID::CTP, ctf, pc);
+
+  if (mExtraTrees.empty() || readers.size() < 2) {
+    for (const auto& reader : readers) {
+      reader(mCTFTree.get());
+    }
+  } else { // every thread reads its share of detectors with its own handle of the file
+    std::atomic<size_t> next{0};
+    std::vector<std::function<void()>> jobs;
+    for (size_t ih = 0; ih <= mExtraTrees.size(); ih++) {
+      TTree* tree = ih ? mExtraTrees[ih - 1].tree.get() : mCTFTree.get();
+      jobs.emplace_back([&readers, &next, tree]() {
+        for (size_t i = next++; i < readers.size(); i = next++) {
+          readers[i](tree);
+        }
+      });
+    }
+    runConcurrently(jobs, jobs.size());
+  }
+
+  ctf.entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, getNEntries(), getFileName());
+  checkTreeEntries();
+  mTimer.Stop();
+  ctf.readTime = mTimer.CpuTime() - cput;
+}
+
+///_______________________________________
+void CTFReaderSpec::sendCTF(ProcessingContext& pc, const CTFData& ctf)
+{
+  mCTFCounter = ctf.counter;
+  CTFHeader ctfHeader = ctf.header;
   if (mUseLocalTFCounter) {
     ctfHeader.tfCounter = mCTFCounter;
   }
@@ -248,35 +417,19 @@ void CTFReaderSpec::processTF(ProcessingContext& pc)
   pc.outputs().snapshot({"header"}, ctfHeader);
   setMessageHeader(pc, ctfHeader, "header");
 
-  processDetector<o2::itsmft::CTF>(DetID::ITS, ctfHeader, pc);
-  processDetector<o2::itsmft::CTF>(DetID::MFT, ctfHeader, pc);
-  processDetector<o2::emcal::CTF>(DetID::EMC, ctfHeader, pc);
-  processDetector<o2::hmpid::CTF>(DetID::HMP, ctfHeader, pc);
-  processDetector<o2::phos::CTF>(DetID::PHS, ctfHeader, pc);
-  processDetector<o2::tpc::CTF>(DetID::TPC, ctfHeader, pc);
-  processDetector<o2::trd::CTF>(DetID::TRD, ctfHeader, pc);
-  processDetector<o2::ft0::CTF>(DetID::FT0, ctfHeader, pc);
-  processDetector<o2::fv0::CTF>(DetID::FV0, ctfHeader, pc);
-  processDetector<o2::fdd::CTF>(DetID::FDD, ctfHeader, pc);
-  processDetector<o2::tof::CTF>(DetID::TOF, ctfHeader, pc);
-  processDetector<o2::mid::CTF>(DetID::MID, ctfHeader, pc);
-  processDetector<o2::mch::CTF>(DetID::MCH, ctfHeader, pc);
-  processDetector<o2::cpv::CTF>(DetID::CPV, ctfHeader, pc);
-  processDetector<o2::zdc::CTF>(DetID::ZDC, ctfHeader, pc);
-  processDetector<o2::ctp::CTF>(DetID::CTP, ctfHeader, pc);
+  for (auto id = DetID::First; id <= DetID::Last; id++) {
+    sendDetector(DetID(id), ctf, ctfHeader, pc);
+  }
 
   // send sTF acknowledge message
   if (!mInput.sup0xccdb) {
     auto& stfDist = pc.outputs().make<o2::header::STFHeader>(OutputRef{"TFDist", 0xccdb});
-    stfDist.id = uint64_t(mCurrTreeEntry);
+    stfDist.id = uint64_t(ctf.entry);
     stfDist.firstOrbit = ctfHeader.firstTForbit;
     stfDist.runNumber = uint32_t(ctfHeader.run);
     setMessageHeader(pc, ctfHeader, "TFDist", 0xccdb);
   }
 
-  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
-  checkTreeEntries();
-  mTimer.Stop();
   // do we need to way to respect the delay ?
   long tNow = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
   auto tDiff = tNow - mLastSendTime;
@@ -288,19 +441,34 @@ void CTFReaderSpec::processTF(ProcessingContext& pc)
     mLastSendTime = tNow;
   }
   tNow = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now()).time_since_epoch().count();
-  LOGP(info, "Read CTF#{} {} in {:.3f} s, {:.4f} s elapsed from previous CTF", mCTFCounter, entryStr, mTimer.CpuTime() - cput, 1e-6 * (tNow - mLastSendTime));
+  LOGP(info, "Read CTF#{} {} in {:.3f} s, {:.4f} s elapsed from previous CTF", mCTFCounter, ctf.entryStr, ctf.readTime, 1e-6 * (tNow - mLastSendTime));
   mLastSendTime = tNow;
   mCTFCounter++;
 }
 
+///_______________________________________
+void CTFReaderSpec::prefetcher()
+{
+  // runs in the separate thread, keeping up to mInput.prefetchCTFs CTFs read ahead, opening new files when needed
+  try {
+    while (true) {
+      auto ctf = std::make_unique<CTFData>();
+      if (!readNextCTF(*ctf) || !mPrefetched->push(std::move(ctf))) { // nothing more to read or stopped by the processing
+        break;
+      }
+    }
+    mPrefetched->close();
+  } catch (...) { // will be rethrown in the processing thread once the CTFs read before are sent
+    mPrefetched->close(std::current_exception());
+  }
+}
+
 ///_______________________________________
 void CTFReaderSpec::checkTreeEntries()
 {
   // check if the tree has entries left, if needed, close current tree/file
-  if (++mCurrTreeEntry >= mCTFTree->GetEntries()) { // this file is done, check if there are other files
-    mCTFTree.reset();
-    mCTFFile->Close();
-    mCTFFile.reset();
+  if (++mCurrTreeEntry >= getNEntries()) { // this file is done, check if there are other files
+    closeCTFFile();
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
     }
@@ -310,7 +478,12 @@ void CTFReaderSpec::checkTreeEntries()
 ///_______________________________________
 void CTFReaderSpec::setMessageHeader(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& lbl, unsigned subspec) const
 {
-  auto* stack = pc.outputs().findMessageHeaderStack(OutputRef{lbl, subspec});
+  setMessageHeader(pc.outputs().findMessageHeaderStack(OutputRef{lbl, subspec}), ctfHeader, lbl);
+}
+
+///_______________________________________
+void CTFReaderSpec::setMessageHeader(o2::header::Stack* stack, const CTFHeader& ctfHeader, const std::string& lbl) const
+{
   if (!stack) {
     throw std::runtime_error(fmt::format("failed to find output message header stack for {}", lbl));
   }
@@ -324,18 +497,71 @@ void CTFReaderSpec::setMessageHeader(ProcessingContext& pc, const CTFHeader& ctf
 
 ///_______________________________________
 template <typename C>
-void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const
+void CTFReaderSpec::addDetectorReader(std::vector<DetReader>& readers, DetID det, CTFData& ctf, ProcessingContext* pc) const
 {
   if (mInput.detMask[det]) {
-    const auto lbl = det.getName();
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({lbl}, ctfHeader.detectors[det] ? sizeof(C) : 0);
-    if (ctfHeader.detectors[det]) {
-      C::readFromTree(bufVec, *(mCTFTree.get()), lbl, mCurrTreeEntry);
-    } else if (!mInput.allowMissingDetectors) {
+    readers.emplace_back([this, det, &ctf, pc](TTree* tree) { readDetector<C>(det, ctf, tree, pc); });
+  }
+}
+
+///_______________________________________
+template <typename C>
+void CTFReaderSpec::readDetector(DetID det, CTFData& ctf, TTree* tree, ProcessingContext* pc) const
+{
+  const auto lbl = det.getName();
+  auto& detData = ctf.data[det];
+  if (!ctf.header.detectors[det]) {
+    if (!mInput.allowMissingDetectors) {
       throw std::runtime_error(fmt::format("Requested detector {} is missing in the CTF", lbl));
     }
-    setMessageHeader(pc, ctfHeader, lbl);
+    return;
+  }
+  if (mCTFFlatFile) { // the mapped data will be sent, the message keeps the mapping alive until it is released
+    // N.B.: the shmem transport copies adopted buffers to the shared memory (once, straight from the mapping), only
+    // the zeromq transport sends them as they are
+    detData.data = mCTFFlatFile->getDetectorData(ctf.entry, det, detData.size);
+    if (!detData.data) {
+      throw std::runtime_error(fmt::format("Detector {} is flagged in the CTF header but its data is absent in {}", lbl, getFileName()));
+    }
+    detData.owner = mCTFFlatFile->getMapping();
+    return;
+  }
+  if (pc) { // synchronous reading: read directly to the output message, the header is set when the CTF is sent
+    auto& bufVec = pc->outputs().make<std::vector<o2::ctf::BufferType>>({lbl}, sizeof(C));
+    C::readFromTree(bufVec, *tree, lbl, ctf.entry);
+    detData.size = bufVec.size();
+    detData.inOutput = true;
+    return;
+  }
+  // read-ahead or reading with multiple threads: the buffer is adopted by the output message when the CTF is sent,
+  // which under the shmem transport copies it to the shared memory
+  auto buffer = std::make_shared<std::vector<o2::ctf::BufferType>>(sizeof(C));
+  C::readFromTree(*buffer, *tree, lbl, ctf.entry);
+  detData.data = reinterpret_cast<const char*>(buffer->data());
+  detData.size = buffer->size();
+  detData.owner = std::move(buffer);
+}
+
+///_______________________________________
+void CTFReaderSpec::sendDetector(DetID det, const CTFData& ctf, const CTFHeader& ctfHeader, ProcessingContext& pc) const
+{
+  if (!mInput.detMask[det]) {
+    return;
+  }
+  const auto& detData = ctf.data[det];
+  if (detData.inOutput) {
+    setMessageHeader(pc, ctfHeader, det.getName());
+    return;
+  }
+  if (!detData.size) { // missing detector, send empty message
+    pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, 0);
+    setMessageHeader(pc, ctfHeader, det.getName());
+    return;
   }
+  Output output{det.getDataOrigin(), "CTFDATA", mInput.subspec};
+  auto* owner = new std::shared_ptr<const void>(detData.owner);
+  pc.outputs().adoptChunk(output, const_cast<char*>(detData.data), detData.size, [](void*, void* hint) { delete static_cast<std::shared_ptr<const void>*>(hint); }, owner);
+  setMessageHeader(pc.outputs().findMessageHeaderStack(output), ctfHeader, det.getName());
 }
 
 ///_______________________________________
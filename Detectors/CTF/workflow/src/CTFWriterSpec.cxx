@@ -20,10 +20,12 @@
 #include <fairmq/Device.h>
 
 #include "CTFWorkflow/CTFWriterSpec.h"
+#include "CTFWorkflow/CTFQueue.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "CommonUtils/NameConf.h"
 #include "CommonUtils/FileSystemUtils.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DetectorsCommonDataFormats/FileMetaData.h"
 #include "CommonUtils/StringUtils.h"
 #include "DataFormatsITSMFT/CTF.h"
@@ -48,12 +50,15 @@
 #include <vector>
 #include <TFile.h>
 #include <TTree.h>
+#include <TROOT.h>
 #include <filesystem>
 #include <ctime>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <regex>
+#include <thread>
+#include <exception>
 
 using namespace o2::framework;
 
@@ -98,16 +103,35 @@ class CTFWriterSpec : public o2::framework::Task
   bool isPresent(DetID id) const { return mDets[id]; }
 
  private:
+  // CTF to be written, in the asynchronous mode the detector data are owned copies of the inputs
+  struct CTFOutput {
+    CTFHeader header{};
+    size_t id = 0;          // sequential number of the CTF
+    size_t estSize = 0;     // estimated size of the CTF
+    bool closeFile = false; // close the currently open file before writing (run or environment change)
+    std::string environmentID{};
+    std::string lhcPeriod{};
+    std::array<gsl::span<const o2::ctf::BufferType>, DetID::nDetectors> data{};
+    std::array<std::vector<o2::ctf::BufferType>, DetID::nDetectors> buffers{};
+  };
+
+  template <typename C>
+  void processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, CTFOutput& out);
   template <typename C>
-  size_t processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, TTree* tree);
+  size_t writeDet(DetID det, const CTFOutput& out);
+  size_t writeCTF(const CTFOutput& out);
+  void writerLoop();
+  void pushCTF(std::unique_ptr<CTFOutput> out);
+  void stopWriter();
   template <typename C>
   void storeDictionary(DetID det, CTFHeader& header);
   void storeDictionaries();
+  void decayDictionaryStatistics();
   void closeTFTreeAndFile();
-  void prepareTFTreeAndFile(const o2::header::DataHeader* dh);
+  void prepareTFTreeAndFile(const CTFOutput& out);
   size_t estimateCTFSize(ProcessingContext& pc);
   size_t getAvailableDiskSpace(const std::string& path, int level);
-  void createLockFile(const o2::header::DataHeader* dh, int level);
+  void createLockFile(const CTFOutput& out, int level);
   void removeLockFile();
   void finalize();
 
@@ -117,9 +141,12 @@ class CTFWriterSpec : public o2::framework::Task
   bool mCreateDict = false;
   bool mCreateRunEnvDir = true;
   bool mStoreMetaFile = false;
+  bool mOnlineDict = false; // continuously update and publish dictionaries, keeping all published versions
+  bool mFlatFile = false;   // write CTFs to memory-mappable flat files instead of the trees
   int mVerbosity = 0;
   int mSaveDictAfter = 0; // if positive and mWriteCTF==true, save dictionary after each mSaveDictAfter TFs processed
   int mFlagMinDet = 1;    // append list of detectors to LHC period if their number is <= mFlagMinDet
+  float mDictDecay = 0.5; // in online mode, scale accumulated statistics by this factor after each dictionary publication
   uint32_t mPrevDictTimeStamp = 0; // timestamp of the previously stored dictionary
   uint32_t mDictTimeStamp = 0;     // timestamp of the currently stored dictionary
   uint64_t mRun = 0;
@@ -127,7 +154,6 @@ class CTFWriterSpec : public o2::framework::Task
   size_t mMaxSize = 0;               // if > MinSize, and accumulated size will exceed this value, stop accumulation (even if mMinSize is not reached)
   size_t mChkSize = 0;               // if > 0 and fallback storage provided, reserve this size per CTF file in production on primary storage
   size_t mAccCTFSize = 0;            // so far accumulated size (if any)
-  size_t mCurrCTFSize = 0;           // size of currently processed CTF
   size_t mNCTF = 0;                  // total number of CTFs written
   size_t mNCTFPrevDict = 0;          // total number of CTFs used for previous dictionary version
   size_t mNAccCTF = 0;               // total number of CTFs accumulated in the current file
@@ -135,6 +161,8 @@ class CTFWriterSpec : public o2::framework::Task
   size_t mNCTFFiles = 0;             // total number of CTF files written
   int mMaxCTFPerFile = 0;            // max CTFs per files to store
   std::vector<uint32_t> mTFOrbits{}; // 1st orbits of TF accumulated in current file
+  uint64_t mFileRun = 0;             // run of the current file
+  std::string mFileLHCPeriod{};      // LHC period of the current file
 
   std::string mOutputType{}; // RS FIXME once global/local options clash is solved, --output-type will become device option
   std::string mLHCPeriod{};
@@ -150,6 +178,7 @@ class CTFWriterSpec : public o2::framework::Task
   int mLockFD = -1;
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  std::unique_ptr<CTFFlatFileWriter> mCTFFlatOut;
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
   std::unique_ptr<TTree> mDictTreeOut; // tree to store dictionary
@@ -163,6 +192,12 @@ class CTFWriterSpec : public o2::framework::Task
   std::array<std::shared_ptr<void>, DetID::nDetectors> mHeaders;
   TStopwatch mTimer;
 
+  // asynchronous writing: the CTFs are queued by the processing thread and written to the files by the writer thread,
+  // which owns the output files and lock files
+  size_t mMaxQueuedCTFs = 0; // if > 0, write asynchronously, blocking the processing if so many CTFs are waiting
+  std::thread mWriterThread;
+  std::unique_ptr<CTFQueue<CTFOutput>> mQueue;
+
   static const std::string TMPFileEnding;
 };
 
@@ -197,9 +232,20 @@ void CTFWriterSpec::init(InitContext& ic)
     throw std::invalid_argument("Invalid output-type");
   }
 
+  mDictDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("ctf-dict-dir"));
   mSaveDictAfter = ic.options().get<int>("save-dict-after");
+  mOnlineDict = ic.options().get<bool>("online-dict");
+  mDictDecay = ic.options().get<float>("online-dict-decay");
+  if (mOnlineDict) {
+    if (!mCreateDict || mSaveDictAfter <= 0) {
+      throw std::invalid_argument("online-dict needs dictionary creation (output-type dict or both) with positive save-dict-after");
+    }
+    if (mDictDecay < 0.f || mDictDecay > 1.f) {
+      throw std::invalid_argument(fmt::format("online-dict-decay={} must be in [0:1] range", mDictDecay));
+    }
+    LOGP(info, "Dictionaries will be published every {} TFs to {}, statistics will be scaled by {} after each publication", mSaveDictAfter, mDictDir, mDictDecay);
+  }
   mCTFAutoSave = ic.options().get<int>("save-ctf-after");
-  mDictDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("ctf-dict-dir"));
   mCTFDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("output-dir"));
   mCTFDirFallBack = ic.options().get<std::string>("output-dir-alt");
   if (mCTFDirFallBack != "/dev/null") {
@@ -215,6 +261,8 @@ void CTFWriterSpec::init(InitContext& ic)
   mMinSize = ic.options().get<int64_t>("min-file-size");
   mMaxSize = ic.options().get<int64_t>("max-file-size");
   mMaxCTFPerFile = ic.options().get<int>("max-ctf-per-file");
+  mFlatFile = ic.options().get<bool>("flat-file");
+  mMaxQueuedCTFs = std::max(0, ic.options().get<int>("async-queue-size"));
   if (mWriteCTF) {
     if (mMinSize > 0) {
       LOG(info) << "Multiple CTFs will be accumulated in the tree/file until its size exceeds " << mMinSize << " bytes";
@@ -226,7 +274,14 @@ void CTFWriterSpec::init(InitContext& ic)
   mChkSize = std::max(size_t(mMinSize * 1.1), mMaxSize);
   o2::utils::createDirectoriesIfAbsent(LOCKFileDir);
 
-  if (mCreateDict) { // make sure that there is no local dictonary
+  if (mWriteCTF && mMaxQueuedCTFs > 0) {
+    LOGP(info, "CTFs will be written asynchronously, with at most {} CTFs waiting in the queue", mMaxQueuedCTFs);
+    ROOT::EnableThreadSafety(); // the dictionaries are stored by the processing thread while the CTFs are written
+    mQueue = std::make_unique<CTFQueue<CTFOutput>>(mMaxQueuedCTFs);
+    mWriterThread = std::thread(&CTFWriterSpec::writerLoop, this);
+  }
+
+  if (mCreateDict && !mOnlineDict) { // make sure that there is no local dictonary, in the online mode it is updated
     std::string dictFileName = fmt::format("{}{}.root", mDictDir, o2::base::NameConf::CTFDICT);
     if (std::filesystem::exists(dictFileName)) {
       throw std::runtime_error(o2::utils::Str::concat_string("CTF dictionary creation is requested but ", dictFileName, " already exists, remove it!"));
@@ -238,17 +293,21 @@ void CTFWriterSpec::init(InitContext& ic)
 //___________________________________________________________________
 // process data of particular detector
 template <typename C>
-size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, TTree* tree)
+void CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det, CTFHeader& header, CTFOutput& out)
 {
-  size_t sz = 0;
   if (!isPresent(det) || !pc.inputs().isValid(det.getName())) {
-    return sz;
+    return;
   }
   auto ctfBuffer = pc.inputs().get<gsl::span<o2::ctf::BufferType>>(det.getName());
   const auto ctfImage = C::getImage(ctfBuffer.data());
   ctfImage.print(o2::utils::Str::concat_string(det.getName(), ": "), mVerbosity);
   if (mWriteCTF) {
-    sz += ctfImage.appendToTree(*tree, det.getName());
+    if (mMaxQueuedCTFs > 0) { // the input will be gone when the CTF is written
+      out.buffers[det].assign(ctfBuffer.begin(), ctfBuffer.end());
+      out.data[det] = gsl::span<const o2::ctf::BufferType>(out.buffers[det].data(), out.buffers[det].size());
+    } else {
+      out.data[det] = ctfBuffer;
+    }
     header.detectors.set(det);
   }
   if (mCreateDict) {
@@ -272,7 +331,21 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
       }
     }
   }
-  return sz;
+}
+
+//___________________________________________________________________
+// write data of particular detector to the current file
+template <typename C>
+size_t CTFWriterSpec::writeDet(DetID det, const CTFOutput& out)
+{
+  const auto& data = out.data[det];
+  if (data.empty()) {
+    return 0;
+  }
+  if (mCTFFlatOut) { // the image is flat, store it as it is
+    return mCTFFlatOut->addDetector(det, data.data(), data.size());
+  }
+  return C::getImage(data.data()).appendToTree(*mCTFTreeOut.get(), det.getName());
 }
 
 //___________________________________________________________________
@@ -303,7 +376,7 @@ void CTFWriterSpec::storeDictionary(DetID det, CTFHeader& header)
   flout.WriteObject(&hb, fmt::format("ctf_dict_header_{}", det.getName()).c_str());
   flout.Close();
   LOGP(info, "Saved {} with {} TFs to {}", hb.asString(), mNCTF, outName);
-  if (mPrevDictTimeStamp) {
+  if (mPrevDictTimeStamp && !mOnlineDict) { // in online mode previous versions are needed to decode the CTFs written with them
     auto outNamePrev = getFileName(false);
     if (std::filesystem::exists(outNamePrev)) {
       std::filesystem::remove(outNamePrev);
@@ -361,9 +434,10 @@ void CTFWriterSpec::run(ProcessingContext& pc)
       mEnvironmentID = envN;
     }
   }
+  bool runChanged = false;
   if ((oldRun != 0 && oldRun != mRun) || (!oldEnv.empty() && oldEnv != mEnvironmentID)) {
     LOGP(warning, "RunNumber/Environment changed from {}/{} to {}/{}", oldRun, oldEnv, mRun, mEnvironmentID);
-    closeTFTreeAndFile();
+    runChanged = true;
   }
   // check for the LHCPeriod
   if (mLHCPeriod.empty()) {
@@ -386,62 +460,148 @@ void CTFWriterSpec::run(ProcessingContext& pc)
     }
   }
 
-  mCurrCTFSize = estimateCTFSize(pc);
-  if (mWriteCTF) {
-    prepareTFTreeAndFile(dh);
-  }
-
   // create header
   CTFHeader header{mRun, dph->creation, dh->firstTForbit, dh->tfCounter};
-  size_t szCTF = 0;
-  szCTF += processDet<o2::itsmft::CTF>(pc, DetID::ITS, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::itsmft::CTF>(pc, DetID::MFT, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::tpc::CTF>(pc, DetID::TPC, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::trd::CTF>(pc, DetID::TRD, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::tof::CTF>(pc, DetID::TOF, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::ft0::CTF>(pc, DetID::FT0, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::fv0::CTF>(pc, DetID::FV0, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::fdd::CTF>(pc, DetID::FDD, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::mid::CTF>(pc, DetID::MID, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::mch::CTF>(pc, DetID::MCH, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::emcal::CTF>(pc, DetID::EMC, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::phos::CTF>(pc, DetID::PHS, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::cpv::CTF>(pc, DetID::CPV, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::zdc::CTF>(pc, DetID::ZDC, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::hmpid::CTF>(pc, DetID::HMP, header, mCTFTreeOut.get());
-  szCTF += processDet<o2::ctp::CTF>(pc, DetID::CTP, header, mCTFTreeOut.get());
+  auto out = std::make_unique<CTFOutput>();
+  out->id = mNCTF;
+  out->closeFile = runChanged;
+  out->environmentID = mEnvironmentID;
+  out->lhcPeriod = mLHCPeriod;
+  if (mWriteCTF) {
+    out->estSize = estimateCTFSize(pc);
+  }
+  processDet<o2::itsmft::CTF>(pc, DetID::ITS, header, *out);
+  processDet<o2::itsmft::CTF>(pc, DetID::MFT, header, *out);
+  processDet<o2::tpc::CTF>(pc, DetID::TPC, header, *out);
+  processDet<o2::trd::CTF>(pc, DetID::TRD, header, *out);
+  processDet<o2::tof::CTF>(pc, DetID::TOF, header, *out);
+  processDet<o2::ft0::CTF>(pc, DetID::FT0, header, *out);
+  processDet<o2::fv0::CTF>(pc, DetID::FV0, header, *out);
+  processDet<o2::fdd::CTF>(pc, DetID::FDD, header, *out);
+  processDet<o2::mid::CTF>(pc, DetID::MID, header, *out);
+  processDet<o2::mch::CTF>(pc, DetID::MCH, header, *out);
+  processDet<o2::emcal::CTF>(pc, DetID::EMC, header, *out);
+  processDet<o2::phos::CTF>(pc, DetID::PHS, header, *out);
+  processDet<o2::cpv::CTF>(pc, DetID::CPV, header, *out);
+  processDet<o2::zdc::CTF>(pc, DetID::ZDC, header, *out);
+  processDet<o2::hmpid::CTF>(pc, DetID::HMP, header, *out);
+  processDet<o2::ctp::CTF>(pc, DetID::CTP, header, *out);
+  out->header = header;
 
+  if (mWriteCTF) {
+    if (mMaxQueuedCTFs > 0) {
+      pushCTF(std::move(out));
+    } else {
+      writeCTF(*out);
+    }
+  } else {
+    LOG(info) << "TF#" << mNCTF << " CTF writing is disabled, size was " << estimateCTFSize(pc) << " bytes";
+  }
   mTimer.Stop();
+  if (mVerbosity > 0) {
+    LOGP(info, "TF#{} processed in {:.3f} s", mNCTF, mTimer.CpuTime() - cput);
+  }
 
-  if (mWriteCTF) {
+  mNCTF++;
+  if (mCreateDict && mSaveDictAfter > 0 && (mNCTF % mSaveDictAfter) == 0) {
+    storeDictionaries();
+  }
+}
+
+//___________________________________________________________________
+size_t CTFWriterSpec::writeCTF(const CTFOutput& out)
+{
+  // write the CTF to the current file, opening the new one or closing the current one if needed
+  TStopwatch sw;
+  if (out.closeFile) {
+    closeTFTreeAndFile();
+  }
+  prepareTFTreeAndFile(out);
+  size_t szCTF = 0;
+  szCTF += writeDet<o2::itsmft::CTF>(DetID::ITS, out);
+  szCTF += writeDet<o2::itsmft::CTF>(DetID::MFT, out);
+  szCTF += writeDet<o2::tpc::CTF>(DetID::TPC, out);
+  szCTF += writeDet<o2::trd::CTF>(DetID::TRD, out);
+  szCTF += writeDet<o2::tof::CTF>(DetID::TOF, out);
+  szCTF += writeDet<o2::ft0::CTF>(DetID::FT0, out);
+  szCTF += writeDet<o2::fv0::CTF>(DetID::FV0, out);
+  szCTF += writeDet<o2::fdd::CTF>(DetID::FDD, out);
+  szCTF += writeDet<o2::mid::CTF>(DetID::MID, out);
+  szCTF += writeDet<o2::mch::CTF>(DetID::MCH, out);
+  szCTF += writeDet<o2::emcal::CTF>(DetID::EMC, out);
+  szCTF += writeDet<o2::phos::CTF>(DetID::PHS, out);
+  szCTF += writeDet<o2::cpv::CTF>(DetID::CPV, out);
+  szCTF += writeDet<o2::zdc::CTF>(DetID::ZDC, out);
+  szCTF += writeDet<o2::hmpid::CTF>(DetID::HMP, out);
+  szCTF += writeDet<o2::ctp::CTF>(DetID::CTP, out);
+
+  auto header = out.header; // the header is modified by the tree I/O
+  if (mCTFFlatOut) {
+    szCTF += mCTFFlatOut->addCTF(header);
+    ++mNAccCTF;
+  } else {
     szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
-    mAccCTFSize += szCTF;
     mCTFTreeOut->SetEntries(++mNAccCTF);
-    mTFOrbits.push_back(dh->firstTForbit);
-    LOG(info) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << mTimer.CpuTime() - cput << " s";
-    if (mNAccCTF > 1) {
-      LOG(info) << "Current CTF tree has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
-    }
-    if (mLockFD != -1) {
-      lseek(mLockFD, 0, SEEK_SET);
-      auto nwr = write(mLockFD, &mAccCTFSize, sizeof(size_t));
-      if (nwr != sizeof(size_t)) {
-        LOG(error) << "Failed to write current CTF size " << mAccCTFSize << " to lock file, bytes written: " << nwr;
-      }
+  }
+  mAccCTFSize += szCTF;
+  mTFOrbits.push_back(header.firstTForbit);
+  sw.Stop();
+  LOG(info) << "TF#" << out.id << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << sw.CpuTime() << " s";
+  if (mNAccCTF > 1) {
+    LOG(info) << "Current CTF tree has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
+  }
+  if (mLockFD != -1) {
+    lseek(mLockFD, 0, SEEK_SET);
+    auto nwr = write(mLockFD, &mAccCTFSize, sizeof(size_t));
+    if (nwr != sizeof(size_t)) {
+      LOG(error) << "Failed to write current CTF size " << mAccCTFSize << " to lock file, bytes written: " << nwr;
     }
+  }
+
+  if (mAccCTFSize >= mMinSize || (mMaxCTFPerFile > 0 && mNAccCTF >= mMaxCTFPerFile)) {
+    closeTFTreeAndFile();
+  } else if (mCTFTreeOut && mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) {
+    mCTFTreeOut->AutoSave("override");
+  }
+  return szCTF;
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::pushCTF(std::unique_ptr<CTFOutput> out)
+{
+  // queue the CTF for the writer thread, wait if the queue is full, rethrow the error of the writer thread if it failed
+  if (mQueue->isFull()) {
+    LOGP(warning, "CTF writing is lagging, {} CTFs are waiting in the queue", mQueue->size());
+  }
+  mQueue->push(std::move(out));
+}
 
-    if (mAccCTFSize >= mMinSize || (mMaxCTFPerFile > 0 && mNAccCTF >= mMaxCTFPerFile)) {
-      closeTFTreeAndFile();
-    } else if (mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) {
-      mCTFTreeOut->AutoSave("override");
+//___________________________________________________________________
+void CTFWriterSpec::writerLoop()
+{
+  // runs in the writer thread until stopped, writes all queued CTFs before exiting
+  while (auto out = mQueue->pop()) {
+    try {
+      writeCTF(*out);
+    } catch (...) {
+      mQueue->close(std::current_exception());
+      mQueue->clear();
+      break;
     }
-  } else {
-    LOG(info) << "TF#" << mNCTF << " CTF writing is disabled, size was " << szCTF << " bytes";
   }
+}
 
-  mNCTF++;
-  if (mCreateDict && mSaveDictAfter > 0 && (mNCTF % mSaveDictAfter) == 0) {
-    storeDictionaries();
+//___________________________________________________________________
+void CTFWriterSpec::stopWriter()
+{
+  if (!mWriterThread.joinable()) {
+    return;
+  }
+  // write the queued CTFs, a failure of the final flush fails the device as in the synchronous writing
+  mQueue->close();
+  mWriterThread.join();
+  if (auto error = mQueue->getError()) {
+    std::rethrow_exception(error);
   }
 }
 
@@ -451,6 +611,7 @@ void CTFWriterSpec::finalize()
   if (mFinalized) {
     return;
   }
+  stopWriter(); // flush the queued CTFs
   if (mCreateDict) {
     storeDictionaries();
   }
@@ -463,28 +624,28 @@ void CTFWriterSpec::finalize()
 }
 
 //___________________________________________________________________
-void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
+void CTFWriterSpec::prepareTFTreeAndFile(const CTFOutput& out)
 {
   if (!mWriteCTF) {
     return;
   }
   bool needToOpen = false;
-  if (!mCTFTreeOut) {
+  if (!mCTFTreeOut && !mCTFFlatOut) {
     needToOpen = true;
   } else {
     if ((mAccCTFSize >= mMinSize) ||                                                         // min size exceeded, may close the file.
-        (mAccCTFSize && mMaxSize > mMinSize && ((mAccCTFSize + mCurrCTFSize) > mMaxSize))) { // this is not the 1st CTF in the file and the new size will exceed allowed max
+        (mAccCTFSize && mMaxSize > mMinSize && ((mAccCTFSize + out.estSize) > mMaxSize))) { // this is not the 1st CTF in the file and the new size will exceed allowed max
       needToOpen = true;
     } else {
-      LOGP(info, "Will add new CTF of estimated size {} to existing file of size {}", mCurrCTFSize, mAccCTFSize);
+      LOGP(info, "Will add new CTF of estimated size {} to existing file of size {}", out.estSize, mAccCTFSize);
     }
   }
   if (needToOpen) {
     closeTFTreeAndFile();
-    auto fname = o2::base::NameConf::getCTFFileName(mRun, dh->firstTForbit, dh->tfCounter);
+    const auto& h = out.header;
     auto ctfDir = mCTFDir.empty() ? o2::utils::Str::rectifyDirectory("./") : mCTFDir;
     if (mChkSize > 0 && (mCTFDirFallBack != "/dev/null")) {
-      createLockFile(dh, 0);
+      createLockFile(out, 0);
       auto sz = getAvailableDiskSpace(ctfDir, 0); // check main storage
       if (sz < mChkSize) {
         removeLockFile();
@@ -492,18 +653,27 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
         ctfDir = mCTFDirFallBack;
       }
     }
-    if (mCreateRunEnvDir && !mEnvironmentID.empty()) {
-      ctfDir += fmt::format("{}_{}/", mEnvironmentID, mRun);
+    if (mCreateRunEnvDir && !out.environmentID.empty()) {
+      ctfDir += fmt::format("{}_{}/", out.environmentID, h.run);
       if (!ctfDir.empty()) {
         o2::utils::createDirectoriesIfAbsent(ctfDir);
         LOGP(info, "Created {} directory for CTFs output", ctfDir);
       }
     }
-    mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(mRun, dh->firstTForbit, dh->tfCounter);
-    mCurrentCTFFileNameFull = fmt::format("{}{}", ctfDir, mCurrentCTFFileName);
-    mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
-    mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    if (mFlatFile) {
+      mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(h.run, h.firstTForbit, h.tfCounter, "o2_ctf", CTFFlatFileWriter::FileExtension);
+      mCurrentCTFFileNameFull = fmt::format("{}{}", ctfDir, mCurrentCTFFileName);
+      mCTFFlatOut = std::make_unique<CTFFlatFileWriter>();
+      mCTFFlatOut->open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding));
+    } else {
+      mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(h.run, h.firstTForbit, h.tfCounter);
+      mCurrentCTFFileNameFull = fmt::format("{}{}", ctfDir, mCurrentCTFFileName);
+      mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
+      mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    }
 
+    mFileRun = h.run;
+    mFileLHCPeriod = out.lhcPeriod;
     mNCTFFiles++;
   }
 }
@@ -511,13 +681,18 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
 //___________________________________________________________________
 void CTFWriterSpec::closeTFTreeAndFile()
 {
-  if (mCTFTreeOut) {
+  if (mCTFTreeOut || mCTFFlatOut) {
     try {
-      mCTFFileOut->cd();
-      mCTFTreeOut->Write();
-      mCTFTreeOut.reset();
-      mCTFFileOut->Close();
-      mCTFFileOut.reset();
+      if (mCTFFlatOut) {
+        mCTFFlatOut->close(); // writes the index
+        mCTFFlatOut.reset();
+      } else {
+        mCTFFileOut->cd();
+        mCTFTreeOut->Write();
+        mCTFTreeOut.reset();
+        mCTFFileOut->Close();
+        mCTFFileOut.reset();
+      }
       if (!TMPFileEnding.empty()) {
         std::filesystem::rename(o2::utils::Str::concat_string(mCurrentCTFFileNameFull, TMPFileEnding), mCurrentCTFFileNameFull);
       }
@@ -525,8 +700,8 @@ void CTFWriterSpec::closeTFTreeAndFile()
       if (mStoreMetaFile) {
         o2::dataformats::FileMetaData ctfMetaData;
         ctfMetaData.fillFileData(mCurrentCTFFileNameFull);
-        ctfMetaData.run = mRun;
-        ctfMetaData.LHCPeriod = mLHCPeriod;
+        ctfMetaData.run = mFileRun;
+        ctfMetaData.LHCPeriod = mFileLHCPeriod;
         ctfMetaData.type = "raw";
         ctfMetaData.priority = "high";
         auto metaFileNameTmp = fmt::format("{}{}.tmp", mCTFMetaFileDir, mCurrentCTFFileName);
@@ -559,7 +734,7 @@ void CTFWriterSpec::closeTFTreeAndFile()
 void CTFWriterSpec::storeDictionaries()
 {
   // monolitic dictionary in tree format
-  mDictTimeStamp = uint32_t(std::time(nullptr));
+  mDictTimeStamp = std::max(uint32_t(std::time(nullptr)), mPrevDictTimeStamp + 1); // the timestamp is the version of the dictionary
   auto getFileName = [this](bool curr) {
     return fmt::format("{}{}_{}_{}.root", this->mDictDir, o2::base::NameConf::CTFDICT, curr ? this->mDictTimeStamp : this->mPrevDictTimeStamp, curr ? this->mNCTF : this->mNCTFPrevDict);
   };
@@ -591,12 +766,15 @@ void CTFWriterSpec::storeDictionaries()
   mDictTreeOut.reset();
   mDictFileOut.reset();
   std::string dictFileNameLnk = fmt::format("{}{}.root", mDictDir, o2::base::NameConf::CTFDICT);
-  if (std::filesystem::exists(dictFileNameLnk)) {
-    std::filesystem::remove(dictFileNameLnk);
+  // replace the link atomically, so that the encoders monitoring it never see it missing
+  std::string dictFileNameLnkTmp = dictFileNameLnk + TMPFileEnding;
+  if (std::filesystem::exists(std::filesystem::symlink_status(dictFileNameLnkTmp))) {
+    std::filesystem::remove(dictFileNameLnkTmp);
   }
-  std::filesystem::create_symlink(dictFileName, dictFileNameLnk);
+  std::filesystem::create_symlink(std::filesystem::path(dictFileName).filename(), dictFileNameLnkTmp); // relative to the link, as the versions are next to it
+  std::filesystem::rename(dictFileNameLnkTmp, dictFileNameLnk);
   LOGP(info, "Saved CTF dictionaries tree with {} TFs to {} and linked to {}", mNCTF, dictFileName, dictFileNameLnk);
-  if (mPrevDictTimeStamp) {
+  if (mPrevDictTimeStamp && !mOnlineDict) {
     auto dictFileNamePrev = getFileName(false);
     if (std::filesystem::exists(dictFileNamePrev)) {
       std::filesystem::remove(dictFileNamePrev);
@@ -605,14 +783,40 @@ void CTFWriterSpec::storeDictionaries()
   }
   mNCTFPrevDict = mNCTF;
   mPrevDictTimeStamp = mDictTimeStamp;
+  if (mOnlineDict) {
+    decayDictionaryStatistics();
+  }
+}
+
+//___________________________________________________________________
+void CTFWriterSpec::decayDictionaryStatistics()
+{
+  // reduce the weight of the already published statistics so that the next dictionary version follows the changes of the data
+  for (int id = 0; id < DetID::nDetectors; id++) {
+    for (size_t ib = 0; ib < mFreqsAccumulation[id].size(); ib++) {
+      auto& freq = mFreqsAccumulation[id][ib];
+      if (freq.empty()) {
+        continue;
+      }
+      std::vector<o2::rans::count_t> scaled(freq.begin(), freq.end());
+      for (auto& c : scaled) {
+        c = o2::rans::count_t(c * mDictDecay);
+      }
+      freq = FTrans(scaled.begin(), scaled.end(), freq.getMinSymbol(), o2::rans::count_t(freq.getIncompressibleSymbolFrequency() * mDictDecay));
+      auto& md = mFreqsMetaData[id][ib]; // the range of the table might have shrunk
+      md.min = freq.getMinSymbol();
+      md.max = freq.getMaxSymbol();
+      md.nDictWords = freq.size();
+    }
+  }
 }
 
 //___________________________________________________________________
-void CTFWriterSpec::createLockFile(const o2::header::DataHeader* dh, int level)
+void CTFWriterSpec::createLockFile(const CTFOutput& out, int level)
 {
   // create lock file for the CTF to be written to the storage of given level
   while (1) {
-    mLockFileName = fmt::format("{}/ctfs{}-{}_{}_{}_{}.lock", LOCKFileDir, level, o2::utils::Str::getRandomString(8), mRun, dh->firstTForbit, dh->tfCounter);
+    mLockFileName = fmt::format("{}/ctfs{}-{}_{}_{}_{}.lock", LOCKFileDir, level, o2::utils::Str::getRandomString(8), out.header.run, out.header.firstTForbit, out.header.tfCounter);
     if (!std::filesystem::exists(mLockFileName)) {
       break;
     }
@@ -707,6 +911,8 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, uint64_t run, const std::
     Options{                                                                    //{"output-type", VariantType::String, "ctf", {"output types: ctf (per TF) or dict (create dictionaries) or both or none"}},
             {"save-ctf-after", VariantType::Int, 0, {"if > 0, autosave CTF tree with multiple CTFs after every N CTFs"}},
             {"save-dict-after", VariantType::Int, 0, {"if > 0, in dictionary generation mode save it dictionary after certain number of TFs processed"}},
+            {"online-dict", VariantType::Bool, false, {"publish updated dictionaries every save-dict-after TFs for the encoders monitoring ctf-dict-dir, keeping all versions"}},
+            {"online-dict-decay", VariantType::Float, 0.5f, {"in online-dict mode scale accumulated statistics by this factor after each publication"}},
             {"ctf-dict-dir", VariantType::String, "none", {"CTF dictionary directory, must exist"}},
             {"output-dir", VariantType::String, "none", {"CTF output directory, must exist"}},
             {"output-dir-alt", VariantType::String, "/dev/null", {"Alternative CTF output directory, must exist (if not /dev/null)"}},
@@ -715,6 +921,8 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, uint64_t run, const std::
             {"min-file-size", VariantType::Int64, 0l, {"accumulate CTFs until given file size reached"}},
             {"max-file-size", VariantType::Int64, 0l, {"if > 0, try to avoid exceeding given file size, also used for space check"}},
             {"max-ctf-per-file", VariantType::Int, 0, {"if > 0, avoid storing more than requested CTFs per file"}},
+            {"flat-file", VariantType::Bool, false, {"write CTFs to memory-mappable flat files (.ctf) instead of ROOT trees"}},
+            {"async-queue-size", VariantType::Int, 0, {"if > 0, write CTFs in a separate thread, blocking the processing when so many CTFs wait to be written"}},
             {"ignore-partition-run-dir", VariantType::Bool, false, {"Do not creare partition-run directory in output-dir"}}}};
 }
 
@@ -96,7 +96,7 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& digitVec, const g
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODEFT0(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get(), getMemMarginFactor());
+#define ENCODEFT0(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, selectEncoder(part, int(slot)), getMemMarginFactor(), getNInterleavedStreams());
   // clang-format off
   ENCODEFT0(cd.trigger,     CTF::BLC_trigger,  0);
   ENCODEFT0(cd.bcInc,       CTF::BLC_bcInc,    0);
@@ -78,7 +78,10 @@ DataProcessorSpec getEntropyEncoderSpec()
     Outputs{{"FT0", "CTFDATA", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<EntropyEncoderSpec>()},
     Options{{"ctf-dict", VariantType::String, "ccdb", {"CTF dictionary: empty or ccdb=CCDB, none=no external dictionary otherwise: local filename"}},
-            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}}}};
+            {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
+            {"ans-streams", VariantType::Int, 0, {"Number of interleaved rANS states (2, 4, 8 or 16), 0 for default"}},
+            {"ctf-dict-adaptive", VariantType::Bool, false, {"Choose per block between external and embedded dictionary by estimated encoded size"}},
+            {"ctf-dict-check-after", VariantType::Int, 0, {"If > 0 and ctf-dict is a local file, check for its update every N TFs"}}}};
 }
 
 } // namespace ft0
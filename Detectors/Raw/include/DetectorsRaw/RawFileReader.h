@@ -41,6 +41,7 @@ struct ReaderInp {
   std::string dropTF{};
   size_t spSize = 1024L * 1024L;
   size_t bufferSize = 1024L * 1024L;
+  size_t minSHM = 0;
   int loop = 1;
   int runNumber = 0;
   uint32_t delay_us = 0;
@@ -22,6 +22,7 @@
 #include "Framework/Task.h"
 #include "Framework/Logger.h"
 #include "Framework/DomainInfoHeader.h"
+#include "Framework/RateLimiter.h"
 
 #include "DetectorsRaw/RawFileReader.h"
 #include "DetectorsRaw/RDHUtils.h"
@@ -70,6 +71,7 @@ class RawReaderSpecs : public o2f::Task
   int mLoop = 0;                  // once last TF reached, loop while mLoop>=0
   uint32_t mTFCounter = 0;        // TFId accumulator (accounts for looping)
   uint32_t mDelayUSec = 0;        // Delay in microseconds between TFs
+  size_t mMinSHM = 0;             // Free SHM to preserve when publishing TFs
   uint32_t mMinTFID = 0;          // 1st TF to extract
   uint32_t mMaxTFID = 0xffffffff; // last TF to extrct
   int mRunNumber = 0;             // run number to pass
@@ -83,6 +85,7 @@ class RawReaderSpecs : public o2f::Task
   std::string mRawChannelName = "";                                // name of optional non-DPL channel
   std::unique_ptr<o2::raw::RawFileReader> mReader;                 // matching engine
   std::unordered_map<std::string, std::pair<int, int>> mDropTFMap; // allows to drop certain fraction of TFs
+  o2f::RateLimiter mRateLimiter;                                   // throttles the publishing according to the consumers
   enum TimerIDs { TimerInit,
                   TimerTotal,
                   TimerIO,
@@ -93,7 +96,7 @@ class RawReaderSpecs : public o2f::Task
 
 //___________________________________________________________
 RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
-  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, rinp.verbosity, rinp.bufferSize)), mRawChannelName(rinp.rawChannelConfig), mVerbosity(rinp.verbosity), mPreferCalcTF(rinp.preferCalcTF)
+  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinSHM(rinp.minSHM), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, rinp.verbosity, rinp.bufferSize)), mRawChannelName(rinp.rawChannelConfig), mVerbosity(rinp.verbosity), mPreferCalcTF(rinp.preferCalcTF)
 {
   mReader->setCheckErrors(rinp.errMap);
   mReader->setMaxTFToRead(rinp.maxTF);
@@ -243,6 +246,8 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
   if (tfID < mMinTFID) {
     tfID = mMinTFID;
   }
+  // wait for the downstream to keep up before allocating the TF messages
+  mRateLimiter.check(ctx, std::stoi(device->fConfig->GetValue<std::string>("timeframes-rate-limit")), mMinSHM);
   mReader->setNextTFToRead(tfID);
   std::vector<RawFileReader::PartStat> partsSP;
 
@@ -207,10 +207,17 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
   ec->getANSHeader().majorVersion = 0;
   ec->getANSHeader().minorVersion = 1;
 
-  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor()](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
-    // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  // with multiple threads the slots are only booked here and encoded concurrently at the end
+  const bool concurrent = getNThreads() > 1;
+  CTF::EncodeBatch batch;
+  auto encodeTPC = [this, &buff, &optField, &batch, concurrent, mfc = this->getMemMarginFactor(), nStreams = this->getNInterleavedStreams(), chunkSize = this->getChunkSize()](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
     const auto slotVal = static_cast<int>(slot);
-    CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get(), mfc);
+    if (concurrent) {
+      batch.add(begin, end, slotVal, probabilityBits, optField[slotVal], this->selectEncoder(begin, end, slotVal), mfc, nStreams, chunkSize);
+      return;
+    }
+    // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+    CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, this->selectEncoder(begin, end, slotVal), mfc, nStreams, chunkSize);
   };
 
   if (mCombineColumns) {
@@ -275,6 +282,9 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
 
   encodeTPC(ccl.nTrackClusters, ccl.nTrackClusters + ccl.nTracks, CTF::BLCnTrackClusters, 0);
   encodeTPC(ccl.nSliceRowClusters, ccl.nSliceRowClusters + ccl.nSliceRows, CTF::BLCnSliceRowClusters, 0);
+  if (concurrent) {
+    CTF::encodeBatch(buff, batch, getNThreads());
+  }
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
 }
 
@@ -302,9 +312,16 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   ec.print(getPrefix(), mVerbosity);
 
   // decode encoded data directly to destination buff
-  auto decodeTPC = [&ec, &coders = mCoders](auto begin, CTF::Slots slot) {
+  // with multiple threads the slots are only booked here and decoded concurrently at the end
+  const bool concurrent = getNThreads() > 1;
+  CTF::base::DecodeBatch batch;
+  auto decodeTPC = [&ec, &coders = mCoders, &batch, concurrent](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
-    ec.decode(begin, slotVal, coders[slotVal].get());
+    if (concurrent) {
+      batch.add(begin, slotVal, coders[slotVal].get());
+    } else {
+      ec.decode(begin, slotVal, coders[slotVal].get());
+    }
   };
 
   if (mCombineColumns) {
@@ -359,6 +376,9 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 
   decodeTPC(cc.nTrackClusters, CTF::BLCnTrackClusters);
   decodeTPC(cc.nSliceRowClusters, CTF::BLCnSliceRowClusters);
+  if (concurrent) {
+    ec.decodeBatch(batch, getNThreads());
+  }
 }
 
 } // namespace tpc
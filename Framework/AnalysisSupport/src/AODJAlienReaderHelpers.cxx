@@ -31,6 +31,7 @@
 #endif
 #include <TGrid.h>
 #include <TFile.h>
+#include <TROOT.h>
 #include <TTreeCache.h>
 
 #include <arrow/ipc/reader.h>
@@ -39,6 +40,8 @@
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <cstring>
+#include <future>
 #include <thread>
 
 using namespace o2;
@@ -93,15 +96,6 @@ static constexpr auto columnNamesTrait(framework::pack<C...>)
   return std::vector<std::string>{C::columnLabel()...};
 }
 
-std::vector<std::string> getColumnNames(header::DataHeader dh)
-{
-  auto description = std::string(dh.dataDescription.str);
-  auto origin = std::string(dh.dataOrigin.str);
-
-  // default: column names = {}
-  return std::vector<std::string>({});
-}
-
 using o2::monitoring::Metric;
 using o2::monitoring::Monitoring;
 using o2::monitoring::tags::Key;
@@ -109,6 +103,111 @@ using o2::monitoring::tags::Value;
 
 namespace o2::framework::readers
 {
+namespace
+{
+/// How the tables are read from the trees
+struct ReaderSettings {
+  Long64_t cacheSize = 0;
+  bool parallel = false;
+};
+
+/// The tables of a time frame read ahead, while the previous one is processed.
+struct PrefetchedTimeFrame {
+  int fileCounter = -1;
+  int numTF = -1;
+  /// False if not all the tables could be read, e.g. at the end of a file.
+  bool complete = false;
+  uint64_t timeFrameNumber = 0;
+  std::vector<std::pair<header::DataHeader, std::unique_ptr<TreeToTable>>> tables;
+  size_t sizeCompressed = 0;
+  size_t sizeUncompressed = 0;
+  /// Time spent reading the tables, in ns.
+  uint64_t ioTime = 0;
+};
+
+/// The columns of the table types subscribed by the consumers, as listed in
+/// the "column:" metadata of @a spec. Empty, i.e. all the columns, if at least
+/// one of them did not list any. This selects whole table types, so only the
+/// extra branches of a tree, beyond its data model, are skipped.
+std::vector<std::string> getColumnNames(OutputSpec const& spec)
+{
+  std::vector<std::string> names;
+  for (auto& param : spec.metadata) {
+    if (param.name.rfind("column:", 0) != 0) {
+      continue;
+    }
+    auto name = param.name.substr(strlen("column:"));
+    if (name == "*") {
+      return {};
+    }
+    names.emplace_back(name);
+  }
+  return names;
+}
+
+/// Read the columns subscribed in @a spec from the tree @a tr, which is deleted.
+std::unique_ptr<TreeToTable> readTable(TTree* tr, OutputSpec const& spec, ReaderSettings const& settings,
+                                       size_t& sizeCompressed, size_t& sizeUncompressed)
+{
+  auto t2t = std::make_unique<TreeToTable>();
+  t2t->setCacheSize(settings.cacheSize);
+  t2t->setParallel(settings.parallel);
+
+  // add branches to read
+  // fill the table
+  auto colnames = getColumnNames(spec);
+  t2t->setLabel(tr->GetName());
+  if (colnames.size() == 0) {
+    sizeCompressed += tr->GetZipBytes();
+    sizeUncompressed += tr->GetTotBytes();
+    t2t->addAllColumns(tr);
+  } else {
+    for (auto& colname : colnames) {
+      TBranch* branch = tr->GetBranch(colname.c_str());
+      if (branch == nullptr) {
+        continue;
+      }
+      sizeCompressed += branch->GetZipBytes("*");
+      sizeUncompressed += branch->GetTotBytes("*");
+    }
+    t2t->addAllColumns(tr, std::move(colnames));
+  }
+  t2t->fill(tr);
+  delete tr;
+  return t2t;
+}
+
+PrefetchedTimeFrame prefetchTimeFrame(std::shared_ptr<DataInputDirector> didir, std::vector<OutputRoute> requestedTables,
+                                      size_t inputTimesliceId, ReaderSettings settings, int fcnt, int ntf)
+{
+  PrefetchedTimeFrame result;
+  result.fileCounter = fcnt;
+  result.numTF = ntf;
+  auto ioStart = uv_hrtime();
+  for (auto& route : requestedTables) {
+    if ((inputTimesliceId % route.maxTimeslices) != route.timeslice) {
+      continue;
+    }
+    auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+    auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
+    TTree* tr = didir->getDataTree(dh, fcnt, ntf);
+    if (!tr) {
+      // Moving to the next file, or missing tables, is left to the
+      // reader itself.
+      result.ioTime = uv_hrtime() - ioStart;
+      return result;
+    }
+    if (result.tables.empty()) {
+      result.timeFrameNumber = didir->getTimeFrameNumber(dh, fcnt, ntf);
+    }
+    result.tables.emplace_back(dh, readTable(tr, route.matcher, settings, result.sizeCompressed, result.sizeUncompressed));
+  }
+  result.complete = result.tables.empty() == false;
+  result.ioTime = uv_hrtime() - ioStart;
+  return result;
+}
+} // namespace
+
 auto setEOSCallback(InitContext& ic)
 {
   ic.services().get<CallbackService>().set(CallbackService::Id::EndOfStream,
@@ -191,17 +290,35 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
         auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
         TFNumberHeader = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
       } else {
+        auto columns = getColumnNames(route.matcher);
+        LOGP(debug, "Reading {} columns of {}", columns.empty() ? std::string{"all"} : std::to_string(columns.size()), DataSpecUtils::describe(route.matcher));
         requestedTables.emplace_back(route);
       }
     }
 
+    ReaderSettings settings;
+    settings.cacheSize = options.get<int64_t>("aod-reader-cache-size");
+    auto threads = options.get<int>("aod-reader-threads");
+    settings.parallel = threads > 0;
+    auto prefetch = options.get<bool>("aod-reader-prefetch");
+    if (threads > 0) {
+      ROOT::EnableImplicitMT(threads);
+    } else if (prefetch) {
+      ROOT::EnableThreadSafety();
+    }
+
     auto fileCounter = std::make_shared<int>(0);
     auto numTF = std::make_shared<int>(-1);
+    // The next time frame, being read while the current one is processed
+    auto prefetched = std::make_shared<std::future<PrefetchedTimeFrame>>();
     return adaptStateless([TFNumberHeader,
                            requestedTables,
                            fileCounter,
                            numTF,
                            watchdog,
+                           settings,
+                           prefetch,
+                           prefetched,
                            didir](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
       // Each parallel reader device.inputTimesliceId reads the files fileCounter*device.maxInputTimeslices+device.inputTimesliceId
       // the TF to read is numTF
@@ -230,6 +347,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       if (!watchdog->update()) {
         LOGP(info, "Run time exceeds run time limit of {} seconds. Exiting gracefully...", watchdog->runTimeLimit);
         LOGP(info, "Stopping reader {} after time frame {}.", device.inputTimesliceId, watchdog->numberTimeFrames - 1);
+        if (prefetched->valid()) {
+          prefetched->wait();
+        }
         dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
         monitoring.flushBuffer();
         didir->closeInputFiles();
@@ -238,9 +358,36 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
         return;
       }
 
+      bool sentPrefetched = false;
+      if (prefetched->valid()) {
+        auto timeFrame = prefetched->get();
+        if (timeFrame.complete && timeFrame.fileCounter == fcnt && timeFrame.numTF == ntf) {
+          auto& firstHeader = timeFrame.tables.front().first;
+          timeFrameNumber = timeFrame.timeFrameNumber;
+          outputs.make<uint64_t>(Output(TFNumberHeader)) = timeFrameNumber;
+          for (auto& [dh, t2t] : timeFrame.tables) {
+            outputs.adopt(Output(dh), t2t.release());
+          }
+          totalSizeCompressed += timeFrame.sizeCompressed;
+          totalSizeUncompressed += timeFrame.sizeUncompressed;
+          // read on the prefetching thread, while the previous time frame
+          // was processed
+          currentFileIOTime += timeFrame.ioTime;
+          if (currentFile == nullptr) {
+            currentFile = didir->getFileFolder(firstHeader, fcnt, ntf).file;
+            tfCurrentFile = didir->getTimeFramesInFile(firstHeader, fcnt);
+          }
+          sentPrefetched = true;
+        }
+      }
+
+      // waiting for the prefetched time frame is not counted, its reading is
       auto ioStart = uv_hrtime();
 
       for (auto& route : requestedTables) {
+        if (sentPrefetched) {
+          break;
+        }
         if ((device.inputTimesliceId % route.maxTimeslices) != route.timeslice) {
           continue;
         }
@@ -289,26 +436,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
         // create table output
         auto o = Output(dh);
-        auto& t2t = outputs.make<TreeToTable>(o);
-
-        // add branches to read
-        // fill the table
-        auto colnames = getColumnNames(dh);
-        t2t.setLabel(tr->GetName());
-        if (colnames.size() == 0) {
-          totalSizeCompressed += tr->GetZipBytes();
-          totalSizeUncompressed += tr->GetTotBytes();
-          t2t.addAllColumns(tr);
-        } else {
-          for (auto& colname : colnames) {
-            TBranch* branch = tr->GetBranch(colname.c_str());
-            totalSizeCompressed += branch->GetZipBytes("*");
-            totalSizeUncompressed += branch->GetTotBytes("*");
-          }
-          t2t.addAllColumns(tr, std::move(colnames));
-        }
-        t2t.fill(tr);
-        delete tr;
+        outputs.adopt(o, readTable(tr, route.matcher, settings, totalSizeCompressed, totalSizeUncompressed).release());
 
         // needed for metrics dumping (upon next file read, or terminate due to watchdog)
         if (currentFile == nullptr) {
@@ -327,6 +455,12 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
       *numTF = ntf;
       currentFileIOTime += (uv_hrtime() - ioStart);
+
+      // read the next time frame of the same file while this one is processed
+      if (prefetch) {
+        *prefetched = std::async(std::launch::async, prefetchTimeFrame, didir, requestedTables,
+                                 device.inputTimesliceId, settings, fcnt, ntf + 1);
+      }
     });
   })};
 
@@ -553,13 +553,11 @@ struct Partition {
       expressions::Operations ops = createOperations(filter);
       if (isSchemaCompatible(schema, ops)) {
         tree = createExpressionTree(ops, schema);
+        native = framework::expressions::createNativeFilter(ops);
       } else {
         throw std::runtime_error("Partition filter does not match declared table type");
       }
     }
-    if (gfilter == nullptr) {
-      gfilter = framework::expressions::createFilter(schema, framework::expressions::makeCondition(tree));
-    }
   }
 
   void inline bindTable(T const& table)
@@ -571,7 +569,17 @@ struct Partition {
   {
     intializeCaches(table.asArrowTable()->schema());
     if (dataframeChanged) {
-      mFiltered = getTableFromFilter(table, soa::selectionToVector(framework::expressions::createSelection(table.asArrowTable(), gfilter)));
+      gandiva::Selection selection = nullptr;
+      if (native != nullptr) {
+        selection = framework::expressions::createSelection(table.asArrowTable(), *native);
+      }
+      if (selection == nullptr) {
+        if (gfilter == nullptr) {
+          gfilter = framework::expressions::createFilter(table.asArrowTable()->schema(), framework::expressions::makeCondition(tree));
+        }
+        selection = framework::expressions::createSelection(table.asArrowTable(), gfilter);
+      }
+      mFiltered = getTableFromFilter(table, soa::selectionToVector(selection));
       dataframeChanged = false;
     }
   }
@@ -613,6 +621,7 @@ struct Partition {
   std::unique_ptr<o2::soa::Filtered<T>> mFiltered = nullptr;
   gandiva::NodePtr tree = nullptr;
   gandiva::FilterPtr gfilter = nullptr;
+  std::shared_ptr<expressions::NativeFilter> native = nullptr;
   bool dataframeChanged = true;
 
   using iterator = typename o2::soa::Filtered<T>::iterator;
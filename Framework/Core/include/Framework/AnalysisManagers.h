@@ -543,12 +543,14 @@ void updateInputs(std::string type, bool value, std::vector<InputSpec>& inputs,
     // amend entry
     auto& entryMetadata = locate->metadata;
     entryMetadata.push_back(ConfigParamSpec{std::string{"control:"} + type, VariantType::Bool, value, {"\"\""}});
+    entryMetadata.push_back(ConfigParamSpec{"column:*", VariantType::Bool, true, {"\"\""}});
     std::sort(entryMetadata.begin(), entryMetadata.end(), [](ConfigParamSpec const& a, ConfigParamSpec const& b) { return a.name < b.name; });
     auto new_end = std::unique(entryMetadata.begin(), entryMetadata.end(), [](ConfigParamSpec const& a, ConfigParamSpec const& b) { return a.name == b.name; });
     entryMetadata.erase(new_end, entryMetadata.end());
   } else {
     //add entry
     spec.metadata.push_back(ConfigParamSpec{std::string{"control:"} + type, VariantType::Bool, value, {"\"\""}});
+    spec.metadata.push_back(ConfigParamSpec{"column:*", VariantType::Bool, true, {"\"\""}});
     inputs.emplace_back(spec);
   }
 }
@@ -98,6 +98,18 @@ struct AnalysisDataProcessorBuilder {
     return inputMetadata;
   }
 
+  /// The persistent columns of the table type subscribed by the task, so that
+  /// the reader can skip the branches which are not part of it. The pruning
+  /// works per table type, not per column actually accessed: a typed table
+  /// binds all of its persistent columns when it is created. As most AO2D
+  /// trees hold exactly the persistent columns of their type, only files
+  /// carrying extra branches are read less.
+  template <typename... C>
+  static void appendColumnMetadata(framework::pack<C...>, std::vector<ConfigParamSpec>& inputMetadata)
+  {
+    (inputMetadata.emplace_back(ConfigParamSpec{std::string{"column:"} + C::columnLabel(), VariantType::Bool, true, {"\"\""}}), ...);
+  }
+
   template <typename Arg>
   static void doAppendInputWithMetadata(const char* name, bool value, std::vector<InputSpec>& inputs)
   {
@@ -106,6 +118,7 @@ struct AnalysisDataProcessorBuilder {
                   "Could not find metadata. Did you register your type?");
     std::vector<ConfigParamSpec> inputMetadata;
     inputMetadata.emplace_back(ConfigParamSpec{std::string{"control:"} + name, VariantType::Bool, value, {"\"\""}});
+    appendColumnMetadata(typename std::decay_t<Arg>::persistent_columns_t{}, inputMetadata);
     if constexpr (soa::is_soa_index_table_t<std::decay_t<Arg>>::value || soa::is_soa_extension_table_v<std::decay_t<Arg>>) {
       auto inputSources = getInputMetadata<std::decay_t<Arg>>();
       inputMetadata.insert(inputMetadata.end(), inputSources.begin(), inputSources.end());
@@ -188,11 +201,18 @@ struct AnalysisDataProcessorBuilder {
   static auto extractFilteredFromRecord(InputRecord& record, ExpressionInfo& info, pack<Os...> const&)
   {
     auto table = o2::soa::ArrowHelpers::joinTables(std::vector<std::shared_ptr<arrow::Table>>{extractTableFromRecord<Os>(record)...});
-    if (info.tree != nullptr && info.filter == nullptr) {
-      info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
-    }
-    if (info.tree != nullptr && info.filter != nullptr && info.resetSelection == true) {
-      info.selection = framework::expressions::createSelection(table, info.filter);
+    if (info.tree != nullptr && info.resetSelection == true) {
+      // simple filters are evaluated without compiling them with gandiva
+      info.selection = nullptr;
+      if (info.native != nullptr) {
+        info.selection = framework::expressions::createSelection(table, *info.native);
+      }
+      if (info.selection == nullptr) {
+        if (info.filter == nullptr) {
+          info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
+        }
+        info.selection = framework::expressions::createSelection(table, info.filter);
+      }
       info.resetSelection = false;
     }
     if constexpr (!framework::is_base_of_template<soa::SmallGroups, std::decay_t<T>>::value) {
@@ -243,9 +263,9 @@ struct AnalysisDataProcessorBuilder {
   using is_external_index_to_t = std::is_same<typename C::binding_t, T>;
 
   template <typename Task, typename... T>
-  static void invokeProcessTuple(Task& task, InputRecord& inputs, std::tuple<T...> const& processTuple, std::vector<ExpressionInfo>& infos)
+  static void invokeProcessTuple(Task& task, InputRecord& inputs, std::tuple<T...> const& processTuple, std::vector<ExpressionInfo>& infos, ArrowTableSlicingCache* slicingCache)
   {
-    (invokeProcess<o2::framework::has_type_at_v<T>(pack<T...>{})>(task, inputs, std::get<T>(processTuple), infos), ...);
+    (invokeProcess<o2::framework::has_type_at_v<T>(pack<T...>{})>(task, inputs, std::get<T>(processTuple), infos, slicingCache), ...);
   }
 
   template <typename... As>
@@ -255,7 +275,7 @@ struct AnalysisDataProcessorBuilder {
   }
 
   template <typename Task, typename R, typename C, typename Grouping, typename... Associated>
-  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo>& infos)
+  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo>& infos, ArrowTableSlicingCache* slicingCache)
   {
     using G = std::decay_t<Grouping>;
     auto groupingTable = AnalysisDataProcessorBuilder::bindGroupingTable(inputs, processingFunction, infos);
@@ -330,7 +350,7 @@ struct AnalysisDataProcessorBuilder {
 
       if constexpr (soa::is_soa_iterator_t<std::decay_t<G>>::value) {
         // grouping case
-        auto slicer = GroupSlicer(groupingTable, associatedTables);
+        auto slicer = GroupSlicer(groupingTable, associatedTables, slicingCache);
         for (auto& slice : slicer) {
           auto associatedSlices = slice.associatedTables();
           overwriteInternalIndices(associatedSlices, associatedTables);
@@ -624,14 +644,16 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       if constexpr (has_run_v<T>) {
         task->run(pc);
       }
+      // the slices of the associated tables are shared by all process functions
+      auto* slicingCache = pc.services().active<ArrowTableSlicingCache>() ? &pc.services().get<ArrowTableSlicingCache>() : nullptr;
       if constexpr (has_process_v<T>) {
-        AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos);
+        AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos, slicingCache);
       }
       homogeneous_apply_refs(
-        [&pc, &expressionInfos, &task](auto& x) mutable {
+        [&pc, &expressionInfos, &task, slicingCache](auto& x) mutable {
           if constexpr (is_base_of_template<ProcessConfigurable, std::decay_t<decltype(x)>>::value) {
             if (x.value == true) {
-              AnalysisDataProcessorBuilder::invokeProcess(*task.get(), pc.inputs(), x.process, expressionInfos);
+              AnalysisDataProcessorBuilder::invokeProcess(*task.get(), pc.inputs(), x.process, expressionInfos, slicingCache);
               return true;
             }
           }
@@ -0,0 +1,60 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_ARENAALLOCATOR_H_
+#define O2_FRAMEWORK_ARENAALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace o2::framework
+{
+
+/// Bookkeeping of an arena of @a nBlocks blocks of @a blockSize bytes.
+/// Allocations are carved one after the other from the current block,
+/// so that what is allocated between two calls to rotate() ends up
+/// in as few blocks as possible. A block is reused only once all the
+/// allocations it holds have been released.
+///
+/// Only one thread can allocate, while allocations can be released
+/// from any thread.
+class ArenaAllocator
+{
+ public:
+  constexpr static size_t Alignment = 64;
+
+  ArenaAllocator(size_t blockSize, size_t nBlocks);
+
+  /// @return the offset in the arena of @a size bytes, or -1 if
+  /// there is no space left or @a size is larger than a block.
+  int64_t allocate(size_t size);
+  /// Release the allocation at @a offset
+  void release(size_t offset);
+  /// Stop carving from the current block.
+  void rotate();
+
+  [[nodiscard]] size_t blockSize() const { return mBlockSize; }
+  [[nodiscard]] size_t size() const { return mBlockSize * mNBlocks; }
+  /// @return the number of blocks with live allocations
+  [[nodiscard]] size_t usedBlocks() const;
+
+ private:
+  size_t mBlockSize;
+  size_t mNBlocks;
+  std::unique_ptr<std::atomic<int>[]> mAllocations;
+  int64_t mCurrent = -1;
+  size_t mOffset = 0;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARENAALLOCATOR_H_
@@ -13,6 +13,7 @@
 
 #include "Framework/FairMQDeviceProxy.h"
 #include "Framework/RoutingIndices.h"
+#include <atomic>
 #include <cassert>
 #include <functional>
 #include <memory>
@@ -32,8 +33,19 @@ class FairMQResizableBuffer;
 class ArrowContext
 {
  public:
-  ArrowContext(FairMQDeviceProxy& proxy)
-    : mProxy{proxy}
+  /// The bytes and messages created and destroyed by the device. Each
+  /// processing stream has its own ArrowContext, for the tables of the
+  /// timeslice it processes, but the accounting is shared by all of them.
+  struct Accounting {
+    std::atomic<size_t> bytesSent{0};
+    std::atomic<size_t> bytesDestroyed{0};
+    std::atomic<size_t> messagesCreated{0};
+    std::atomic<size_t> messagesDestroyed{0};
+  };
+
+  ArrowContext(FairMQDeviceProxy& proxy, std::shared_ptr<Accounting> accounting = std::make_shared<Accounting>())
+    : mProxy{proxy},
+      mAccounting{std::move(accounting)}
   {
   }
 
@@ -88,53 +100,55 @@ class ArrowContext
     return mProxy;
   }
 
+  std::shared_ptr<Accounting> const& accounting()
+  {
+    return mAccounting;
+  }
+
   void updateBytesSent(size_t value)
   {
-    mBytesSent += value;
+    mAccounting->bytesSent += value;
   }
 
   void updateBytesDestroyed(size_t value)
   {
-    mBytesDestroyed += value;
+    mAccounting->bytesDestroyed += value;
   }
 
   void updateMessagesSent(size_t value)
   {
-    mMessagesCreated += value;
+    mAccounting->messagesCreated += value;
   }
 
   void updateMessagesDestroyed(size_t value)
   {
-    mMessagesDestroyed += value;
+    mAccounting->messagesDestroyed += value;
   }
 
   size_t bytesSent()
   {
-    return mBytesSent;
+    return mAccounting->bytesSent;
   }
 
   size_t bytesDestroyed()
   {
-    return mBytesDestroyed;
+    return mAccounting->bytesDestroyed;
   }
 
   size_t messagesCreated()
   {
-    return mMessagesCreated;
+    return mAccounting->messagesCreated;
   }
 
   size_t messagesDestroyed()
   {
-    return mMessagesDestroyed;
+    return mAccounting->messagesDestroyed;
   }
 
  private:
   FairMQDeviceProxy& mProxy;
   Messages mMessages;
-  size_t mBytesSent = 0;
-  size_t mBytesDestroyed = 0;
-  size_t mMessagesCreated = 0;
-  size_t mMessagesDestroyed = 0;
+  std::shared_ptr<Accounting> mAccounting;
   size_t mRateLimit = 0;
 };
 
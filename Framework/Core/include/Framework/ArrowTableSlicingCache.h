@@ -0,0 +1,87 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
+#define O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
+
+#include <arrow/table.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// How the rows of a table are split by one of its index columns: for each
+/// row of the grouping table, where its group starts and how many rows it
+/// has. Rows with a negative index do not belong to any group.
+///
+/// If the index is sorted, each group is a contiguous range of rows of the
+/// table. Otherwise the groups are ranges of @a permutation, which lists
+/// the rows of the table ordered by index.
+struct SliceInfo {
+  std::vector<uint64_t> offsets;
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> permutation;
+  bool sorted = true;
+
+  std::pair<uint64_t, int64_t> getSliceFor(int value) const
+  {
+    return {offsets[value], sizes[value]};
+  }
+
+  /// @return the rows of the table in the group of @a value, in ascending order
+  std::vector<int64_t> getRowsFor(int value) const;
+};
+
+/// The slices of the associated tables by their index to the grouping table.
+/// Every process function grouping the same table by the same index, e.g.
+/// the tracks by collision, shares them instead of splitting the table
+/// again. They are valid for the timeframe being processed. Each processing
+/// stream has its own cache, as it processes its own timeframe.
+struct ArrowTableSlicingCache {
+  /// @return the slices of @a table by the index column @a key, with
+  /// @a groupingSize groups, computed only the first time they are needed
+  /// in the current timeframe. @a target is the name of the table.
+  std::shared_ptr<SliceInfo const> getCacheFor(char const* key, char const* target, std::shared_ptr<arrow::Table> const& table, int32_t groupingSize);
+
+  /// Forget the slices of the timeframe which was processed.
+  void reset();
+
+  /// Split @a table by the index column @a key in a single pass, without
+  /// caching the result.
+  static std::shared_ptr<SliceInfo> computeSlices(char const* key, char const* target, std::shared_ptr<arrow::Table> const& table, int32_t groupingSize);
+
+  size_t hits = 0;
+  size_t misses = 0;
+
+ private:
+  struct Entry {
+    /// The name of the index column.
+    std::string key;
+    /// The values of the index column. Tables are read again from the
+    /// same message by each process function, so that the column objects
+    /// differ, but not the memory they point to. The buffer is kept, so
+    /// that its memory cannot be reused by another table before reset().
+    std::shared_ptr<arrow::Buffer> buffer;
+    void const* values = nullptr;
+    int64_t length = 0;
+    int32_t groupingSize = 0;
+    std::shared_ptr<SliceInfo const> info;
+  };
+  std::vector<Entry> mEntries;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARROWTABLESLICINGCACHE_H_
@@ -12,6 +12,7 @@
 #define O2_FRAMEWORK_COMPUTINGRESOURCE_H_
 
 #include <string>
+#include <vector>
 
 namespace o2::framework
 {
@@ -43,6 +44,10 @@ struct ComputingResource {
   unsigned short startPort = 0;
   unsigned short lastPort = 0;
   unsigned short usedPorts = 0;
+  /// The NUMA node whose memory the device should use, -1 for any.
+  int numaNode = -1;
+  /// The cores the device is bound to, empty for any.
+  std::vector<int> cpus;
 };
 
 } // namespace o2::framework
@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_DATADESCRIPTORLOOKUP_H_
+#define O2_FRAMEWORK_DATADESCRIPTORLOOKUP_H_
+
+#include "Framework/DataDescriptorMatcher.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::framework::data_matcher
+{
+
+/// A set of DataDescriptorMatcher compiled in a table, so that finding the
+/// first one which accepts a given header does not require evaluating all
+/// of them.
+///
+/// Matchers requiring a constant origin, description and subspecification
+/// are hashed on the three of them, those requiring only a constant origin
+/// and description on the pair. Only the remaining ones (wildcards,
+/// variables, Or / Not clauses) are tried for every header. The candidates
+/// are still fully matched, in order, so that the variables are captured
+/// and the result is the same as trying all the matchers one by one.
+class DataDescriptorLookup
+{
+ public:
+  static constexpr size_t INVALID = -1;
+
+  DataDescriptorLookup() = default;
+  /// Compile the matchers @a matchers[index[0]], @a matchers[index[1]], ...
+  /// in this order. @a matchers must outlive the lookup.
+  DataDescriptorLookup(std::vector<DataDescriptorMatcher> const& matchers, std::vector<size_t> const& index);
+
+  /// @return the position in the index of the first matcher accepting the
+  /// header stack @a data, or INVALID. The variables captured by the
+  /// accepting matcher are committed to @a context.
+  size_t match(char const* data, VariableContext& context) const;
+
+  /// How many matchers have to be tried for every header.
+  size_t fallbacks() const { return mFallbacks.size(); }
+
+ private:
+  /// Origin, description and subspecification, zero padded.
+  struct Key {
+    uint64_t words[3] = {0, 0, 0};
+    bool operator==(Key const& other) const
+    {
+      return words[0] == other.words[0] && words[1] == other.words[1] && words[2] == other.words[2];
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(Key const& key) const
+    {
+      uint64_t h = key.words[0] * 0x9E3779B97F4A7C15ull;
+      h = (h ^ (h >> 29) ^ key.words[1]) * 0xBF58476D1CE4E5B9ull;
+      h = (h ^ (h >> 31) ^ key.words[2]) * 0x94D049BB133111EBull;
+      return h ^ (h >> 32);
+    }
+  };
+
+  static Key makeKey(char const* origin, char const* description, header::DataHeader::SubSpecificationType subSpec);
+  /// Clear the subspecification, to look up the matchers on the type only.
+  static Key typeOf(Key key);
+
+  /// The compiled matchers, in the order of the index.
+  std::vector<DataDescriptorMatcher const*> mMatchers;
+  /// Positions of the matchers accepting a given origin, description and
+  /// subspecification, sorted.
+  std::unordered_map<Key, std::vector<size_t>, KeyHash> mExact;
+  /// Positions of the matchers accepting a given origin and description, with
+  /// any subspecification, sorted.
+  std::unordered_map<Key, std::vector<size_t>, KeyHash> mTypes;
+  /// Positions of the matchers which have to be tried for every header, sorted.
+  std::vector<size_t> mFallbacks;
+};
+
+} // namespace o2::framework::data_matcher
+
+#endif // O2_FRAMEWORK_DATADESCRIPTORLOOKUP_H_
@@ -27,6 +27,7 @@
 #include "Framework/Tracing.h"
 #include "Framework/RunningWorkflowInfo.h"
 #include "Framework/ObjectCache.h"
+#include "Framework/TaskStreamPool.h"
 
 #include <fairmq/FairMQDevice.h>
 #include <fairmq/FairMQParts.h>
@@ -66,6 +67,23 @@ struct DeviceContext {
   uv_timer_t* gracePeriodTimer = nullptr;
   int expectedRegionCallbacks = 0;
   int exitTransitionTimeout = 0;
+  /// Whether to report when each timeslice was processed, for the
+  /// critical path analysis done by the driver.
+  bool reportTimeslicePath = false;
+};
+
+/// Resources owned by a given processing stream. The services of kind
+/// Stream (e.g. the message contexts and the TimingInfo) have a separate
+/// instance in @a registry, all the others are shared with the device.
+struct StreamContext {
+  StreamContext(ServiceRegistry const& parent, DataAllocator::AllowedOutputRoutes const& outputs)
+    : registry{parent},
+      allocator{&registry, outputs}
+  {
+  }
+
+  ServiceRegistry registry;
+  DataAllocator allocator;
 };
 
 struct DataProcessorContext {
@@ -95,10 +113,15 @@ struct DataProcessorContext {
   bool isSink = false;
 
   std::function<void(o2::framework::RuntimeErrorRef e, InputRecord& record)>* errorHandling = nullptr;
-};
 
-struct TaskStreamRef {
-  int index = -1;
+  /// The pool of threads processing the data, if any. When not set,
+  /// everything is processed on the calling thread.
+  TaskStreamPool* streams = nullptr;
+  /// One context per thread of the pool
+  std::vector<std::unique_ptr<StreamContext>>* streamContexts = nullptr;
+  /// Serialises what the streams share (e.g. sending) between themselves
+  /// and with the main thread.
+  std::mutex* streamMutex = nullptr;
 };
 
 struct TaskStreamInfo {
@@ -146,6 +169,8 @@ class DataProcessingDevice : public FairMQDevice
   void initPollers();
   void startPollers();
   void stopPollers();
+  /// Write the events recorded so far to the trace file of this device
+  void dumpTrace();
   DeviceContext mDeviceContext;
   /// The specification used to create the initial state of this device
   DeviceSpec const& mSpec;
@@ -177,6 +202,10 @@ class DataProcessingDevice : public FairMQDevice
   std::vector<uv_work_t> mHandles;                               /// Handles to use to schedule work.
   std::vector<TaskStreamInfo> mStreams;                          /// Information about the task running in the associated mHandle.
   ComputingQuotaEvaluator& mQuotaEvaluator;                      /// The component which evaluates if the offer can be used to run a task
+  std::unique_ptr<TaskStreamPool> mStreamPool;                   /// The threads processing the data, when dpl-processing-threads > 0
+  std::vector<std::unique_ptr<StreamContext>> mStreamContexts;   /// The resources of each thread in mStreamPool
+  std::mutex mStreamMutex;                                       /// Serialises the non reentrant parts of the processing
+  std::string mTracePrefix;                                      /// Where to dump the trace of the events, if not empty
   /// Handle to wake up the main loop from other threads
   /// e.g. when FairMQ notifies some callback in an asynchronous way
   uv_async_t* mAwakeHandle = nullptr;
@@ -39,6 +39,9 @@ struct DataProcessingStats {
   std::atomic<int> totalSigusr1 = 0;
   std::atomic<int> consumedTimeframes = 0;
   std::atomic<uint64_t> availableManagedShm = 0; /// Available shared memory in bytes.
+  std::atomic<uint64_t> arenaMessages = 0;       /// Messages carved from the output arena
+  std::atomic<uint64_t> arenaAllocatedBytes = 0; /// Bytes allocated from the output arena
+  std::atomic<uint64_t> arenaFallbacks = 0;      /// Allocations which did not fit in the output arena
 
   std::atomic<uint64_t> lastSlowMetricSentTimestamp = 0; /// The timestamp of the last time we sent slow metrics
   std::atomic<uint64_t> lastVerySlowMetricSentTimestamp = 0; /// The timestamp of the last time we sent very slow metrics
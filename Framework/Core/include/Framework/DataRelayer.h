@@ -14,6 +14,7 @@
 #include "Framework/RootSerializationSupport.h"
 #include "Framework/InputRoute.h"
 #include "Framework/DataDescriptorMatcher.h"
+#include "Framework/DataDescriptorLookup.h"
 #include "Framework/ForwardRoute.h"
 #include "Framework/CompletionPolicy.h"
 #include "Framework/MessageSet.h"
@@ -139,6 +140,11 @@ class DataRelayer
   /// Mark a given slot as done so that the GUI
   /// can reflect that.
   void updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStatus, CacheEntryStatus newStatus);
+  /// Keep the timeslice of @a slot among the possible outputs while its
+  /// inputs, consumed by the caller, are processed asynchronously.
+  void beginProcessing(TimesliceSlot slot);
+  /// The processing of @a timeslice is over and its outputs were sent.
+  void endProcessing(TimesliceId timeslice);
   /// Get the firstTFOrbit associate to a given slot.
   uint32_t getFirstTFOrbitForSlot(TimesliceSlot slot);
   /// Get the firstTFCounter associate to a given slot.
@@ -171,8 +177,12 @@ class DataRelayer
   std::vector<size_t> mDistinctRoutesIndex;
   std::vector<InputSpec> mInputs;
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
+  /// mInputMatchers of the distinct routes, compiled for faster matching.
+  data_matcher::DataDescriptorLookup mInputLookup;
   std::vector<data_matcher::VariableContext> mVariableContextes;
   std::vector<CacheEntryStatus> mCachedStateMetrics;
+  /// The slots to be checked by getReadyToProcess, kept to reuse the allocation.
+  std::vector<TimesliceSlot> mDirtySlots;
   size_t mMaxLanes;
 
   static std::vector<std::string> sMetricsNames;
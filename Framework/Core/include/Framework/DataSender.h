@@ -33,10 +33,22 @@ class DataSender
  public:
   DataSender(ServiceRegistry& registry,
              SendingPolicy const& policy);
+  /// Send @a parts to the given channel, or keep them to be sent
+  /// together with the others for the same channel, depending on the
+  /// coalescing of the policy.
   void send(FairMQParts&, ChannelIndex index);
+  /// To be invoked once all the outputs of a timeslice were passed to send.
+  void endOfTimeslice();
+  /// Send whatever is being kept.
+  void flush();
   std::unique_ptr<FairMQMessage> create(RouteIndex index);
 
  private:
+  /// Actually send @a parts, followed by the oldest possible timeslice
+  void doSend(FairMQParts& parts, ChannelIndex index);
+  /// Evaluate the coalescing for each channel, once the channels are known
+  void initCoalescing();
+
   FairMQDeviceProxy& mProxy;
   ServiceRegistry& mRegistry;
   DeviceSpec const& mSpec;
@@ -48,6 +60,13 @@ class DataSender
   std::vector<std::string> mVariablesMetricsNames;
   std::vector<std::string> mQueriesMetricsNames;
 
+  /// Per output channel, for how many timeslices parts can be kept
+  std::vector<int> mCoalescing;
+  /// Per output channel, the parts not yet sent and how many timeslices
+  /// they span
+  std::vector<FairMQParts> mPending;
+  std::vector<int> mPendingTimeslices;
+
   TracyLockableN(std::recursive_mutex, mMutex, "data relayer mutex");
 };
 
@@ -0,0 +1,103 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_DESERIALIZATIONCACHE_H_
+#define O2_FRAMEWORK_DESERIALIZATIONCACHE_H_
+
+#include "Framework/TypeIdHelpers.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// A cache for the objects deserialised from ROOT serialized inputs, so that
+/// an input which is accessed more than once, or which does not change from
+/// one timeslice to the next (e.g. condition objects), is deserialised only
+/// once. Entries are keyed on the input and validated against the size and a
+/// checksum of the payload, since buffers are reused across timeslices.
+///
+/// The objects are owned by the cache: an object stays valid until a
+/// different payload is received for the same input, or until it is evicted
+/// because more than @a capacity inputs are cached, and in any case until the
+/// end of the processing of the timeslice in which it was returned. Since the
+/// timeslices can be processed concurrently, a replaced object is destroyed
+/// only once all the timeslices it was returned to are done.
+struct DeserializationCache {
+  struct Entry {
+    uint32_t type = 0;
+    size_t size = 0;
+    uint64_t checksum = 0;
+    std::shared_ptr<void const> object;
+    size_t lastUsed = 0;
+    /// The most recent timeslice the object was returned to
+    size_t lastTimeslice = 0;
+  };
+
+  /// How many inputs to keep deserialised, 0 disables the cache.
+  size_t capacity = 0;
+  size_t hits = 0;
+  size_t misses = 0;
+
+  /// @return the object deserialised from @a payload for the input @a key,
+  /// invoking @a deserialize only if the payload changed since the last time.
+  /// @a deserialize must return a std::unique_ptr<T>. The object is used
+  /// while processing @a timeslice, which must be released afterwards.
+  template <typename T, typename F>
+  T const* get(std::string const& key, size_t timeslice, char const* payload, size_t size, F&& deserialize)
+  {
+    constexpr auto type = TypeIdHelpers::uniqueId<T>();
+    auto sum = checksum(payload, size);
+    std::lock_guard<std::mutex> lock{mMutex};
+    mInUse.insert(timeslice);
+    if (auto object = find(key, type, size, sum, timeslice)) {
+      return reinterpret_cast<T const*>(object);
+    }
+    std::shared_ptr<T const> object{deserialize().release()};
+    insert(key, Entry{type, size, sum, object, 0, timeslice});
+    return object.get();
+  }
+
+  /// A fast, non cryptographic, checksum of the payload.
+  static uint64_t checksum(char const* payload, size_t size);
+
+  /// To be invoked once the processing of @a timeslice is over. Destroys the
+  /// objects replaced or evicted so far which were returned only to
+  /// timeslices older than the ones still being processed.
+  void release(size_t timeslice);
+
+ private:
+  struct Retired {
+    size_t lastTimeslice;
+    std::shared_ptr<void const> object;
+  };
+
+  void const* find(std::string const& key, uint32_t type, size_t size, uint64_t sum, size_t timeslice);
+  void insert(std::string const& key, Entry&& entry);
+
+  std::mutex mMutex;
+  std::unordered_map<std::string, Entry> mEntries;
+  /// Objects no longer in the cache, but possibly still in use
+  std::vector<Retired> mRetired;
+  /// The timeslices being processed which got objects from the cache
+  std::set<size_t> mInUse;
+  size_t mTick = 0;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_DESERIALIZATIONCACHE_H_
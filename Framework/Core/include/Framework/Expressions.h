@@ -49,6 +49,11 @@ using Selection = std::shared_ptr<gandiva::SelectionVector>;
 using FilterPtr = std::shared_ptr<gandiva::Filter>;
 } // namespace gandiva
 
+namespace o2::framework::expressions
+{
+struct NativeFilter;
+}
+
 using atype = arrow::Type;
 struct ExpressionInfo {
   int argumentIndex;
@@ -59,6 +64,7 @@ struct ExpressionInfo {
   gandiva::FilterPtr filter;
   gandiva::Selection selection;
   bool resetSelection = false;
+  std::shared_ptr<o2::framework::expressions::NativeFilter> native;
 };
 
 namespace o2::framework::expressions
@@ -493,6 +499,17 @@ std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
 /// Function to create gandiva filter from operation sequence
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               Operations const& opSpecs);
+/// Function to create a filter evaluated natively on the columns, without gandiva,
+/// from operation sequence. Only comparisons, logical and/or, floating point
+/// arithmetic and abs of numeric columns and literals are supported, nullptr
+/// is returned otherwise.
+std::shared_ptr<NativeFilter> createNativeFilter(Operations const& opSpecs);
+/// Function to add operation sequence to a native filter with logical 'and', false if not supported
+bool addToNativeFilter(NativeFilter& filter, Operations const& opSpecs);
+/// Function for creating gandiva selection with a native filter, nullptr if the
+/// columns of the table cannot be read natively or a block needs gandiva, for NaN
+/// comparisons or divisions by zero
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, NativeFilter const& filter);
 /// Function to create gandiva projector from operation sequence
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Operations const& opSpecs,
@@ -501,6 +518,13 @@ std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Sc
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Projector&& p,
                                                     gandiva::FieldPtr result);
+/// Function to create gandiva projector from gandiva projecting expressions
+std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
+                                                    gandiva::ExpressionVector const& expressions);
+
+/// Function to get the time spent by this process compiling gandiva filters
+/// and projectors, in microseconds. Creating again the same one is not counted.
+uint64_t getCompilationTimeUs();
 /// Function for attaching gandiva filters to to compatible task inputs
 void updateExpressionInfos(expressions::Filter const& filter, std::vector<ExpressionInfo>& eInfos);
 /// Function to create gandiva condition expression from generic gandiva expression tree
@@ -513,20 +537,13 @@ void updatePlaceholders(Filter& filter, InitContext& context);
 template <typename... C>
 std::shared_ptr<gandiva::Projector> createProjectors(framework::pack<C...>, gandiva::SchemaPtr schema)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(
+  return createProjector(
     schema,
     {makeExpression(
       framework::expressions::createExpressionTree(
         framework::expressions::createOperations(C::Projector()),
         schema),
-      C::asArrowField())...},
-    &projector);
-  if (s.ok()) {
-    return projector;
-  } else {
-    throw o2::framework::runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
+      C::asArrowField())...});
 }
 } // namespace o2::framework::expressions
 
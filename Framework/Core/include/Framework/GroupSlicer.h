@@ -14,6 +14,7 @@
 
 #include "Framework/Pack.h"
 #include "Framework/Kernels.h"
+#include "Framework/ArrowTableSlicingCache.h"
 
 #include <arrow/util/key_value_metadata.h>
 #include <type_traits>
@@ -25,9 +26,9 @@ namespace o2::framework
 template <typename G, typename... A>
 struct GroupSlicer {
   using grouping_t = std::decay_t<G>;
-  GroupSlicer(G& gt, std::tuple<A...>& at)
+  GroupSlicer(G& gt, std::tuple<A...>& at, ArrowTableSlicingCache* cache = nullptr)
     : max{gt.size()},
-      mBegin{GroupSlicerIterator(gt, at)}
+      mBegin{GroupSlicerIterator(gt, at, cache)}
   {
   }
 
@@ -68,7 +69,7 @@ struct GroupSlicer {
     }
 
     template <typename T>
-    auto splittingFunction(T&& table)
+    auto splittingFunction(T&& table, ArrowTableSlicingCache* cache)
     {
       constexpr auto index = framework::has_type_at_v<std::decay_t<T>>(associated_pack_t{});
       if constexpr (relatedByIndex<std::decay_t<G>, std::decay_t<T>>()) {
@@ -77,30 +78,21 @@ struct GroupSlicer {
           if (table.size() == 0) {
             return;
           }
-          // use presorted splitting approach
-          auto result = o2::framework::sliceByColumn(mIndexColumnName.c_str(),
-                                                     name.c_str(),
-                                                     table.asArrowTable(),
-                                                     static_cast<int32_t>(mGt->tableSize()),
-                                                     &groups[index],
-                                                     &offsets[index],
-                                                     &sizes[index]);
-          if (result.ok() == false) {
-            throw runtime_error("Cannot split collection");
-          }
-          if (groups[index].size() > mGt->tableSize()) {
-            throw runtime_error_f("Splitting collection %s resulted in a larger group number (%d) than there is rows in the grouping table (%d).", name.c_str(), groups[index].size(), mGt->tableSize());
-          };
         } else {
           if (table.tableSize() == 0) {
             return;
           }
-          // use generic splitting approach
-          o2::framework::sliceByColumnGeneric(mIndexColumnName.c_str(),
-                                              name.c_str(),
-                                              table.asArrowTable(),
-                                              static_cast<int32_t>(mGt->tableSize()),
-                                              &filterGroups[index]);
+        }
+        auto groupingSize = static_cast<int32_t>(mGt->tableSize());
+        if (cache != nullptr) {
+          sliceInfos[index] = cache->getCacheFor(mIndexColumnName.c_str(), name.c_str(), table.asArrowTable(), groupingSize);
+        } else {
+          sliceInfos[index] = ArrowTableSlicingCache::computeSlices(mIndexColumnName.c_str(), name.c_str(), table.asArrowTable(), groupingSize);
+        }
+        if constexpr (!framework::is_specialization_v<std::decay_t<T>, soa::SmallGroups>) {
+          if (sliceInfos[index]->sorted == false) {
+            throw runtime_error_f("Table %s index %s is not sorted, it can only be grouped as soa::SmallGroups<>", name.c_str(), mIndexColumnName.c_str());
+          }
         }
       }
     }
@@ -112,11 +104,10 @@ struct GroupSlicer {
         constexpr auto index = framework::has_type_at_v<std::decay_t<T>>(associated_pack_t{});
         selections[index] = &table.getSelectedRows();
         starts[index] = selections[index]->begin();
-        offsets[index].push_back(table.tableSize());
       }
     }
 
-    GroupSlicerIterator(G& gt, std::tuple<A...>& at)
+    GroupSlicerIterator(G& gt, std::tuple<A...>& at, ArrowTableSlicingCache* cache)
       : mIndexColumnName{std::string("fIndex") + getLabelFromType<G>()},
         mGt{&gt},
         mAt{&at},
@@ -132,7 +123,7 @@ struct GroupSlicer {
       ///
       std::apply(
         [&](auto&&... x) -> void {
-          (splittingFunction(x), ...);
+          (splittingFunction(x, cache), ...);
         },
         at);
       /// extract selections from filtered associated tables
@@ -284,25 +275,26 @@ struct GroupSlicer {
             return originalTable;
           }
           // optimized split
+          auto slice = sliceInfos[index]->getSliceFor(pos);
+          auto offset = slice.first;
+          auto size = slice.second;
+          auto groupedElementsTable = originalTable.asArrowTable()->Slice(offset, size);
           if constexpr (soa::is_soa_filtered_t<std::decay_t<A1>>::value) {
-            auto groupedElementsTable = arrow::util::get<std::shared_ptr<arrow::Table>>(((groups[index])[pos]).value);
-
             // for each grouping element we need to slice the selection vector
-            auto start_iterator = std::lower_bound(starts[index], selections[index]->end(), (offsets[index])[pos]);
-            auto stop_iterator = std::lower_bound(start_iterator, selections[index]->end(), (offsets[index])[pos] + (sizes[index])[pos]);
+            auto start_iterator = std::lower_bound(starts[index], selections[index]->end(), offset);
+            auto stop_iterator = std::lower_bound(start_iterator, selections[index]->end(), offset + size);
             starts[index] = stop_iterator;
             soa::SelectionVector slicedSelection{start_iterator, stop_iterator};
             std::transform(slicedSelection.begin(), slicedSelection.end(), slicedSelection.begin(),
                            [&](int64_t idx) {
-                             return idx - static_cast<int64_t>((offsets[index])[pos]);
+                             return idx - static_cast<int64_t>(offset);
                            });
 
-            std::decay_t<A1> typedTable{{groupedElementsTable}, std::move(slicedSelection), (offsets[index])[pos]};
+            std::decay_t<A1> typedTable{{groupedElementsTable}, std::move(slicedSelection), offset};
             typedTable.bindInternalIndicesTo(&originalTable);
             return typedTable;
           } else {
-            auto groupedElementsTable = arrow::util::get<std::shared_ptr<arrow::Table>>(((groups[index])[pos]).value);
-            std::decay_t<A1> typedTable{{groupedElementsTable}, (offsets[index])[pos]};
+            std::decay_t<A1> typedTable{{groupedElementsTable}, offset};
             typedTable.bindInternalIndicesTo(&originalTable);
             return typedTable;
           }
@@ -313,11 +305,12 @@ struct GroupSlicer {
               return originalTable;
             }
             // intersect selections
+            auto groupRows = sliceInfos[index]->getRowsFor(pos);
             o2::soa::SelectionVector s;
             if (selections[index]->empty()) {
-              std::copy((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), std::back_inserter(s));
+              s = std::move(groupRows);
             } else {
-              std::set_intersection((filterGroups[index])[pos].begin(), (filterGroups[index])[pos].end(), selections[index]->begin(), selections[index]->end(), std::back_inserter(s));
+              std::set_intersection(groupRows.begin(), groupRows.end(), selections[index]->begin(), selections[index]->end(), std::back_inserter(s));
             }
             std::decay_t<A1> typedTable{{originalTable.asArrowTable()}, std::move(s)};
             typedTable.bindInternalIndicesTo(&originalTable);
@@ -337,10 +330,7 @@ struct GroupSlicer {
     typename grouping_t::iterator mGroupingElement;
     uint64_t position = 0;
     gsl::span<int64_t const> groupSelection;
-    std::array<std::vector<arrow::Datum>, sizeof...(A)> groups;
-    std::array<ListVector, sizeof...(A)> filterGroups;
-    std::array<std::vector<uint64_t>, sizeof...(A)> offsets;
-    std::array<std::vector<int>, sizeof...(A)> sizes;
+    std::array<std::shared_ptr<SliceInfo const>, sizeof...(A)> sliceInfos;
     std::array<gsl::span<int64_t const> const*, sizeof...(A)> selections;
     std::array<gsl::span<int64_t const>::iterator, sizeof...(A)> starts;
   };
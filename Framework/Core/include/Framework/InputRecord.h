@@ -20,6 +20,8 @@
 #include "Framework/RuntimeError.h"
 #include "Framework/Logger.h"
 #include "Framework/ObjectCache.h"
+#include "Framework/DeserializationCache.h"
+#include "Framework/TimingInfo.h"
 #include "Framework/CallbackService.h"
 
 #include "Headers/DataHeader.h"
@@ -395,13 +397,9 @@ class InputRecord
         // This supports the common case of retrieving a root object and getting pointer.
         // Notice that this will return a copy of the actual contents of the buffer, because
         // the buffer is actually serialised, for this reason we return a unique_ptr<T>.
-        // FIXME: does it make more sense to keep ownership of all the deserialised
-        // objects in a single place so that we can avoid duplicate deserializations?
-        // explicitely specify serialization method to ROOT-serialized because type T
-        // is messageable and a different method would be deduced in DataRefUtils
-        // return type with owning Deleter instance, forwarding to default_deleter
-        std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<ROOTSerialized<ValueT>>(ref).release());
-        return result;
+        // If the deserialization cache is enabled, the object is owned by the
+        // cache and shared with any other access to the same payload.
+        return getROOTSerialized<ValueT>(ref);
       } else if (method == o2::header::gSerializationMethodCCDB) {
         // This is to support deserialising objects from CCDB. Contrary to what happens for
         // other objects, those objects are most likely long lived, so we
@@ -464,11 +462,7 @@ class InputRecord
           "Type mismatch: attempt to extract a non-messagable object "
           "from message with unserialized data");
       } else if (method == o2::header::gSerializationMethodROOT) {
-        // explicitely specify serialization method to ROOT-serialized because type T
-        // is messageable and a different method would be deduced in DataRefUtils
-        // return type with owning Deleter instance, forwarding to default_deleter
-        std::unique_ptr<T const, Deleter<T const>> result(DataRefUtils::as<ROOTSerialized<T>>(ref).release());
-        return result;
+        return getROOTSerialized<T>(ref);
       } else {
         throw runtime_error("Attempt to extract object from message with unsupported serialization type");
       }
@@ -688,6 +682,28 @@ class InputRecord
   }
 
  private:
+  /// Deserialise the ROOT serialized object in @a ref, or reuse the one in
+  /// the DeserializationCache if the payload did not change.
+  template <typename T>
+  std::unique_ptr<T const, Deleter<T const>> getROOTSerialized(DataRef const& ref) const
+  {
+    if (mRegistry.active<DeserializationCache>() && mRegistry.get<DeserializationCache>().capacity > 0) {
+      auto& cache = mRegistry.get<DeserializationCache>();
+      auto header = DataRefUtils::getHeader<header::DataHeader*>(ref);
+      ConcreteDataMatcher matcher{header->dataOrigin, header->dataDescription, header->subSpecification};
+      auto key = fmt::format("{}/{}/{}", ref.spec ? ref.spec->binding : "", DataSpecUtils::describe(matcher), header->splitPayloadIndex);
+      auto object = cache.get<T>(key, mRegistry.get<TimingInfo>().timeslice, ref.payload, DataRefUtils::getPayloadSize(ref), [&ref]() {
+        return DataRefUtils::as<ROOTSerialized<T>>(ref);
+      });
+      // return type with non-owning Deleter instance, the cache owns the object
+      return std::unique_ptr<T const, Deleter<T const>>(object, Deleter<T const>(false));
+    }
+    // explicitely specify serialization method to ROOT-serialized because type T
+    // is messageable and a different method would be deduced in DataRefUtils
+    // return type with owning Deleter instance, forwarding to default_deleter
+    return std::unique_ptr<T const, Deleter<T const>>(DataRefUtils::as<ROOTSerialized<T>>(ref).release());
+  }
+
   ServiceRegistry& mRegistry;
   std::vector<InputRoute> const& mInputsSchema;
   InputSpan& mSpan;
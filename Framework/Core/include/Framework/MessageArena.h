@@ -0,0 +1,85 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_MESSAGEARENA_H_
+#define O2_FRAMEWORK_MESSAGEARENA_H_
+
+#include "Framework/ArenaAllocator.h"
+#include "MemoryResources/MemoryResources.h"
+
+#include <fairmq/FwdDecls.h>
+#include <fairmq/FairMQUnmanagedRegion.h>
+
+#include <unordered_map>
+
+namespace o2::framework
+{
+
+struct DataProcessingStats;
+
+/// A memory resource which carves the payloads from a single shared memory
+/// region, sending them as messages pointing to the region. This avoids
+/// one allocation in the shared memory segment per output, which is
+/// expensive for devices producing many small outputs. Payloads which do
+/// not fit are allocated from @a transport, as usual.
+///
+/// The region is split in blocks, see ArenaAllocator. Calling rotate()
+/// once per timeslice makes sure that a block is only used by a few
+/// timeslices and can be reused as soon as they have been consumed.
+class MessageArena : public pmr::FairMQMemoryResource
+{
+ public:
+  constexpr static size_t DefaultBlocks = 16;
+
+  MessageArena(FairMQTransportFactory* transport, size_t size, size_t nBlocks, DataProcessingStats* stats);
+  ~MessageArena() override;
+
+  /// @return the size of each of @a nContexts arenas sharing
+  /// @a totalSize bytes, rounded down to the arena granularity.
+  static size_t sizePerContext(size_t totalSize, size_t nContexts)
+  {
+    constexpr size_t granularity = DefaultBlocks * ArenaAllocator::Alignment;
+    return nContexts ? totalSize / nContexts / granularity * granularity : 0;
+  }
+
+  /// Create a message of @a size bytes
+  FairMQMessagePtr createMessage(size_t size);
+  /// Start a new timeslice
+  void rotate() { mAllocator.rotate(); }
+
+  FairMQMessagePtr getMessage(void* p) override;
+  void* setMessage(FairMQMessagePtr message) override;
+  FairMQTransportFactory* getTransportFactory() noexcept override { return mTransport; }
+  size_t getNumberOfMessages() const noexcept override { return mAllocated.size(); }
+
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  bool do_is_equal(const memory_resource& other) const noexcept override
+  {
+    return this == &other;
+  }
+
+ private:
+  bool inRegion(void* p) const;
+
+  FairMQTransportFactory* mTransport = nullptr;
+  pmr::FairMQMemoryResource* mUpstream = nullptr;
+  ArenaAllocator mAllocator;
+  FairMQUnmanagedRegionPtr mRegion;
+  char* mBase = nullptr;
+  /// Allocations from the region which were not yet turned into a message
+  std::unordered_map<void*, size_t> mAllocated;
+  DataProcessingStats* mStats = nullptr;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_MESSAGEARENA_H_
@@ -13,6 +13,7 @@
 
 #include "Framework/DispatchControl.h"
 #include "Framework/FairMQDeviceProxy.h"
+#include "Framework/MessageArena.h"
 #include "Framework/OutputRoute.h"
 #include "Framework/RouteState.h"
 #include "Framework/RoutingIndices.h"
@@ -30,6 +31,7 @@
 
 #include <cassert>
 #include <functional>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -41,6 +43,7 @@ namespace o2::framework
 {
 
 struct Output;
+struct DataProcessingStats;
 
 class MessageContext
 {
@@ -251,7 +254,7 @@ class MessageContext
         // the transport factory
         mFactory{context->proxy().getOutputTransport(routeIndex)},
         // the memory resource takes ownership of the message
-        mResource{mFactory ? AlignedMemoryResource(mFactory->GetMemoryResource()) : AlignedMemoryResource(nullptr)},
+        mResource{mFactory ? AlignedMemoryResource(context->getMemoryResource(routeIndex)) : AlignedMemoryResource(nullptr)},
         // create the vector with apropriate underlying memory resource for the message
         mData{std::forward<Args>(args)..., pmr::polymorphic_allocator<value_type>(&mResource)}
     {
@@ -541,6 +544,9 @@ class MessageContext
       assert(m->empty());
     }
     mMessages.clear();
+    for (auto& [transport, arena] : mArenas) {
+      arena->rotate();
+    }
   }
 
   FairMQDeviceProxy& proxy()
@@ -563,6 +569,13 @@ class MessageContext
   FairMQMessagePtr createMessage(RouteIndex routeIndex, int index, size_t size);
   FairMQMessagePtr createMessage(RouteIndex routeIndex, int index, void* data, size_t size, fairmq_free_fn* ffn, void* hint);
 
+  /// Allocate the payloads of the shared memory outputs of each timeslice
+  /// from a region of @a size bytes, rather than one by one. This is
+  /// meant for devices producing many small outputs.
+  void enableArena(size_t size, DataProcessingStats* stats);
+  /// @return the memory resource to use for the payloads of @a routeIndex
+  pmr::FairMQMemoryResource* getMemoryResource(RouteIndex routeIndex);
+
   /// return the headers of the 1st (from the end) matching message checking first in mMessages then in mScheduledMessages
   o2::header::DataHeader* findMessageHeader(const Output& spec);
   o2::header::Stack* findMessageHeaderStack(const Output& spec);
@@ -578,6 +591,13 @@ class MessageContext
   DispatchControl mDispatchControl;
   /// Cached messages, in case we want to reuse them.
   std::unordered_map<int64_t, std::unique_ptr<FairMQMessage>> mMessageCache;
+  /// Size of the output arena, 0 when disabled
+  size_t mArenaSize = 0;
+  DataProcessingStats* mArenaStats = nullptr;
+  /// One arena per shared memory transport, created on first use
+  std::unordered_map<FairMQTransportFactory*, std::unique_ptr<MessageArena>> mArenas;
+
+  MessageArena* getArena(FairMQTransportFactory* transport);
 };
 } // namespace o2::framework
 #endif // O2_FRAMEWORK_MESSAGECONTEXT_H_
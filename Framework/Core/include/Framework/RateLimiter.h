@@ -13,19 +13,95 @@
 #define O2_FRAMERWORK_CORE_RATELIMITER_H
 
 #include "Framework/ProcessingContext.h"
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 
 namespace o2::framework
 {
+
+/// Online estimate of what a timeframe in flight costs to the workflow,
+/// learned from the free shared memory and from the feedback of the
+/// consumers. It is used to decide whether a new timeframe can be injected
+/// without going below the requested amount of free SHM, and at which pace,
+/// rather than injecting until a threshold is hit and then stalling.
+struct RateLimiterModel {
+  /// Weight of a new sample in the moving averages
+  static constexpr double Smoothing = 0.2;
+
+  /// SHM bytes used by each timeframe in flight
+  double footprint = 0;
+  /// Seconds between the publishing of a timeframe and its consumption
+  double latency = 0;
+  /// Free SHM when no timeframe is in flight
+  uint64_t baseline = 0;
+
+  /// Account for @a freeSHM bytes being free while @a inFlight timeframes
+  /// are being processed.
+  void observeMemory(uint64_t freeSHM, int64_t inFlight)
+  {
+    if (inFlight <= 0 || freeSHM > baseline) {
+      baseline = freeSHM;
+      return;
+    }
+    average(footprint, double(baseline - freeSHM) / inFlight);
+  }
+
+  /// Account for a timeframe which was consumed @a seconds after being sent.
+  void observeLatency(double seconds)
+  {
+    average(latency, seconds);
+  }
+
+  /// Whether a new timeframe fits in @a freeSHM while keeping at least
+  /// @a minSHM bytes free. Until a footprint is learned, or when nothing is
+  /// in flight (i.e. waiting would not free anything), only the threshold
+  /// is checked.
+  bool canInject(uint64_t freeSHM, size_t minSHM, int64_t inFlight) const
+  {
+    if (inFlight <= 0) {
+      return freeSHM > minSHM;
+    }
+    return freeSHM > minSHM + footprint;
+  }
+
+  /// The interval between two injections which keeps @a maxInFlight
+  /// timeframes in flight, given the observed latency.
+  std::chrono::duration<double> pacing(int maxInFlight) const
+  {
+    if (maxInFlight <= 0) {
+      return std::chrono::duration<double>{0};
+    }
+    return std::chrono::duration<double>{latency / maxInFlight};
+  }
+
+ private:
+  static void average(double& value, double sample)
+  {
+    value = value == 0 ? sample : value + Smoothing * (sample - value);
+  }
+};
+
 class RateLimiter
 {
  public:
   void check(ProcessingContext& ctx, int maxInFlight, size_t minSHM);
 
+  RateLimiterModel const& model() const { return mModel; }
+
  private:
+  /// Read the number of consumed timeframes from the metric-feedback
+  /// channel, waiting at most @a timeout ms. Returns false if nothing was
+  /// received.
+  bool receiveFeedback(ProcessingContext& ctx, int timeout);
+
   int64_t mConsumedTimeframes = 0;
   int64_t mSentTimeframes = 0;
+  RateLimiterModel mModel;
+  /// When the timeframes not yet consumed were sent
+  std::deque<std::chrono::steady_clock::time_point> mSendTimes;
+  std::chrono::steady_clock::time_point mLastSent;
 };
 } // namespace o2::framework
 
@@ -25,9 +25,17 @@ class FairMQDeviceProxy;
 
 struct SendingPolicy {
   using SendingCallback = std::function<void(FairMQDeviceProxy&, FairMQParts&, ChannelIndex channelIndex)>;
+  /// For how many timeslices the parts for the output channel with the given
+  /// name can be kept, before being sent together in a single multipart
+  /// message. 0 sends the parts as soon as they are produced, 1 sends all
+  /// the parts produced while processing a timeslice at once. Channels
+  /// carrying Timeframe data never go beyond 1.
+  using CoalescingCallback = std::function<int(std::string const& channel)>;
   std::string name = "invalid";
   DeviceMatcher matcher = nullptr;
   SendingCallback send = nullptr;
+  /// When not set, the parts are grouped per timeslice.
+  CoalescingCallback coalescing = nullptr;
   static std::vector<SendingPolicy> createDefaultPolicies();
 };
 
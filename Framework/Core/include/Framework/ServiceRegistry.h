@@ -157,17 +157,22 @@ struct ServiceRegistry {
   /// Invoke callbacks on exit.
   void preExitCallbacks();
 
-  /// Declare a service by its ServiceSpec. If of type Global
-  /// / Serial it will be immediately registered for tid 0,
-  /// so that subsequent gets will ultimately use it.
-  /// If it is of kind "Stream" we will create the Service only
-  /// when requested by a given thread. This function is not
-  /// thread safe.
+  /// Declare a service by its ServiceSpec. It will be immediately
+  /// registered for tid 0, so that subsequent gets will ultimately use it.
+  /// If it is of kind "Stream", additional instances are created
+  /// for each processing stream by declareStreamServices. This
+  /// function is not thread safe.
   void declareService(ServiceSpec const& spec, DeviceState& state, fair::mq::ProgOptions& options);
 
   /// Bind the callbacks of a service spec to a given service.
   void bindService(ServiceSpec const& spec, void* service);
 
+  /// Populate this registry, which is expected to be a copy of @a parent,
+  /// for a new processing stream. The services of kind Stream get a new
+  /// instance, specific to the stream, while the other ones are shared with
+  /// @a parent, including their callbacks. This function is not thread safe.
+  void declareStreamServices(ServiceRegistry const& parent, DeviceState& state, fair::mq::ProgOptions& options);
+
   /// Type erased service registration. @a typeHash is the
   /// hash used to identify the service, @a service is
   /// a type erased pointer to the service itself.
@@ -123,12 +123,20 @@ class TreeToTable
  public:
   TreeToTable(arrow::MemoryPool* pool = arrow::default_memory_pool());
   void setLabel(const char* label);
+  /// Size in bytes of the TTreeCache used to read the columns, 0 to keep the
+  /// default of the tree. To be set before adding the columns.
+  void setCacheSize(Long64_t size);
+  /// Decode the columns in parallel on the ROOT implicit multithreading
+  /// pool, when enabled.
+  void setParallel(bool parallel);
   void addAllColumns(TTree* tree, std::vector<std::string>&& names = {});
   void fill(TTree*);
   std::shared_ptr<arrow::Table> finalize();
 
  private:
   arrow::MemoryPool* mArrowMemoryPool;
+  Long64_t mCacheSize = 0;
+  bool mParallel = false;
   std::vector<std::unique_ptr<BranchToColumn>> mBranchReaders;
   std::string mTableLabel;
   std::shared_ptr<arrow::Table> mTable;
@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_TASKSTREAMPOOL_H_
+#define O2_FRAMEWORK_TASKSTREAMPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace o2::framework
+{
+
+struct TaskStreamRef {
+  int index = -1;
+};
+
+/// A pool of threads, one per stream, executing tasks in parallel.
+/// Every stream has its own queue, which is fed in a round robin manner.
+/// A stream which runs out of work steals tasks from the others, so
+/// that the load is balanced even if the tasks have very different
+/// durations. The tasks are executed in the order they were pushed,
+/// modulo the parallelism.
+///
+/// Only one thread is supposed to push tasks and wait for them.
+class TaskStreamPool
+{
+ public:
+  /// A task receives the stream which executes it, so that it can use
+  /// the resources specific to that stream.
+  using Task = std::function<void(TaskStreamRef)>;
+
+  explicit TaskStreamPool(int nStreams);
+  TaskStreamPool(TaskStreamPool const&) = delete;
+  TaskStreamPool& operator=(TaskStreamPool const&) = delete;
+  ~TaskStreamPool();
+
+  /// Queue a new task. Rethrows the first exception thrown by a task, if any.
+  void push(Task&& task);
+  /// Block until all the tasks are done. Rethrows the first exception
+  /// thrown by a task, if any.
+  void waitIdle();
+  /// Stop the threads once the pending tasks are done
+  void stop();
+  /// @return the number of tasks queued or being executed
+  [[nodiscard]] size_t pending() const { return mPending.load(); }
+  [[nodiscard]] int size() const { return mStreams.size(); }
+
+ private:
+  struct Stream {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+    std::thread thread;
+  };
+
+  /// Get the next task for stream @a si, from its own queue or stolen
+  /// from the other ones.
+  bool tryPop(int si, Task& task);
+  void run(int si);
+  void rethrowError();
+
+  std::vector<std::unique_ptr<Stream>> mStreams;
+  std::mutex mMutex;
+  std::condition_variable mWakeUp;
+  std::condition_variable mIdle;
+  std::atomic<size_t> mQueued = 0;
+  std::atomic<size_t> mPending = 0;
+  std::exception_ptr mError;
+  size_t mNext = 0;
+  bool mStop = false;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_TASKSTREAMPOOL_H_
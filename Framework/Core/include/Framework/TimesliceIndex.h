@@ -89,6 +89,11 @@ class TimesliceIndex
   inline void markAsInvalid(TimesliceSlot slot);
   /// Mark all the cachelines as invalid, e.g. due to an out of band event
   inline void rescan();
+  /// Fill @a slots with the slots which were marked as dirty since the
+  /// previous call, in decreasing order of their index. This allows to check
+  /// only the cachelines which were touched rather than all of them. The
+  /// caller is expected to mark them as not dirty once they are processed.
+  inline void collectDirtySlots(std::vector<TimesliceSlot>& slots);
   /// Publish a slot to be sent via metrics.
   inline void publishSlot(TimesliceSlot slot);
 
@@ -129,6 +134,12 @@ class TimesliceIndex
   [[nodiscard]] inline OldestOutputInfo getOldestPossibleOutput() const;
   inline OldestOutputInfo updateOldestPossibleOutput();
 
+  /// Keep @a timeslice among the possible outputs until markAsProcessed
+  /// is called, even if its slot was already invalidated, e.g. because the
+  /// consumed inputs are still being processed asynchronously.
+  inline void markAsInFlight(TimesliceId timeslice);
+  inline void markAsProcessed(TimesliceId timeslice);
+
  private:
   /// @return the oldest slot possible so that we can eventually override it.
   /// This is the timeslices for all the in flight parts.
@@ -143,6 +154,10 @@ class TimesliceIndex
   /// This keeps track whether or not something was relayed
   /// since last time we called getReadyToProcess()
   std::vector<bool> mDirty;
+  /// The slots which became dirty since the last collectDirtySlots(). It can
+  /// contain duplicates and slots which are not dirty anymore, which are
+  /// filtered out when collected.
+  std::vector<TimesliceSlot> mDirtySlots;
 
   /// This is the oldest possible timeslice for any given channel
   /// The cardinality of this vector is the number of input channels
@@ -151,6 +166,9 @@ class TimesliceIndex
   /// By default we use -1, which means that we don't have any.
   OldestInputInfo mOldestPossibleInput = {};
   OldestOutputInfo mOldestPossibleOutput = {};
+  /// The timeslices whose inputs were consumed but whose outputs
+  /// might still be sent.
+  std::vector<TimesliceId> mInFlight;
 
   /// What to do in case of backpressure
   BackpressureOp mBackpressurePolicy = BackpressureOp::Wait;
@@ -0,0 +1,84 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/ArenaAllocator.h"
+#include "Framework/RuntimeError.h"
+
+namespace o2::framework
+{
+
+ArenaAllocator::ArenaAllocator(size_t blockSize, size_t nBlocks)
+  : mBlockSize{blockSize - blockSize % Alignment},
+    mNBlocks{nBlocks},
+    mAllocations{new std::atomic<int>[nBlocks]}
+{
+  if (mBlockSize == 0 || mNBlocks == 0) {
+    throw runtime_error_f("Invalid arena of %zu blocks of %zu bytes", nBlocks, blockSize);
+  }
+  for (size_t bi = 0; bi < mNBlocks; ++bi) {
+    mAllocations[bi] = 0;
+  }
+}
+
+int64_t ArenaAllocator::allocate(size_t size)
+{
+  size_t aligned = (size + Alignment - 1) / Alignment * Alignment;
+  if (aligned == 0 || aligned > mBlockSize) {
+    return -1;
+  }
+  if (mCurrent == -1 || mOffset + aligned > mBlockSize) {
+    // Look for a block without live allocations, starting from the one
+    // after the current, so that the blocks are used in a round robin
+    // manner.
+    int64_t next = -1;
+    for (size_t i = 1; i <= mNBlocks; ++i) {
+      auto bi = (mCurrent + i) % mNBlocks;
+      if (mAllocations[bi].load() == 0) {
+        next = bi;
+        break;
+      }
+    }
+    if (next == -1) {
+      return -1;
+    }
+    mCurrent = next;
+    mOffset = 0;
+  }
+  mAllocations[mCurrent]++;
+  int64_t offset = mCurrent * mBlockSize + mOffset;
+  mOffset += aligned;
+  return offset;
+}
+
+void ArenaAllocator::release(size_t offset)
+{
+  auto bi = offset / mBlockSize;
+  if (bi >= mNBlocks) {
+    throw runtime_error_f("Offset %zu is outside of the arena", offset);
+  }
+  mAllocations[bi]--;
+}
+
+void ArenaAllocator::rotate()
+{
+  // The current block is then reused only once it is empty.
+  mOffset = mBlockSize;
+}
+
+size_t ArenaAllocator::usedBlocks() const
+{
+  size_t count = 0;
+  for (size_t bi = 0; bi < mNBlocks; ++bi) {
+    count += mAllocations[bi].load() != 0;
+  }
+  return count;
+}
+
+} // namespace o2::framework
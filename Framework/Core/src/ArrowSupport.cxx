@@ -12,6 +12,7 @@
 
 #include "Framework/AODReaderHelpers.h"
 #include "Framework/ArrowContext.h"
+#include "Framework/ArrowTableSlicingCache.h"
 #include "Framework/DataProcessor.h"
 #include "Framework/ServiceRegistry.h"
 #include "Framework/ConfigContext.h"
@@ -23,6 +24,7 @@
 #include "Framework/DeviceMetricsHelper.h"
 #include "Framework/DeviceInfo.h"
 #include "Framework/DevicesManager.h"
+#include "Framework/Expressions.h"
 #include "WorkflowHelpers.h"
 #include "Framework/WorkflowSpecNode.h"
 
@@ -106,7 +108,16 @@ o2::framework::ServiceSpec ArrowSupport::arrowBackendSpec()
 
   return ServiceSpec{
     .name = "arrow-backend",
-    .init = CommonMessageBackendsHelpers<ArrowContext>::createCallback(),
+    .init = [](ServiceRegistry& services, DeviceState&, fair::mq::ProgOptions&) -> ServiceHandle {
+      auto& proxy = services.get<FairMQDeviceProxy>();
+      // The context of a processing stream is created from a copy of the
+      // registry of the device, it shares the accounting of the device one.
+      if (services.active<ArrowContext>()) {
+        auto& device = services.get<ArrowContext>();
+        return ServiceHandle{TypeIdHelpers::uniqueId<ArrowContext>(), new ArrowContext(proxy, device.accounting())};
+      }
+      return ServiceHandle{TypeIdHelpers::uniqueId<ArrowContext>(), new ArrowContext(proxy)};
+    },
     .configure = CommonServices::noConfiguration(),
     .preProcessing = CommonMessageBackendsHelpers<ArrowContext>::clearContext(),
     .postProcessing = CommonMessageBackendsHelpers<ArrowContext>::sendCallback(),
@@ -388,6 +399,13 @@ o2::framework::ServiceSpec ArrowSupport::arrowBackendSpec()
                        auto& monitoring = ctx.services().get<Monitoring>();
                        monitoring.send(Metric{(uint64_t)arrow->bytesDestroyed(), "arrow-bytes-destroyed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
                        monitoring.send(Metric{(uint64_t)arrow->messagesDestroyed(), "arrow-messages-destroyed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                       // Filters and projectors are compiled on the first timeframes only.
+                       static uint64_t lastCompilationTimeUs = 0;
+                       auto compilationTimeUs = expressions::getCompilationTimeUs();
+                       if (compilationTimeUs != lastCompilationTimeUs) {
+                         lastCompilationTimeUs = compilationTimeUs;
+                         monitoring.send(Metric{compilationTimeUs, "expressions-compile-time-us"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+                       }
                        monitoring.flushBuffer(); },
     .driverInit = [](ServiceRegistry& registry, boost::program_options::variables_map const& vm) {
                        auto config = new RateLimitConfig{};
@@ -530,7 +548,21 @@ o2::framework::ServiceSpec ArrowSupport::arrowBackendSpec()
           outputsInputsAOD.emplace_back(InputSpec{"tfn", "TFN", "TFNumber"});
           workflow.push_back(CommonDataProcessors::getGlobalAODSink(dod, outputsInputsAOD));
         } },
-    .kind = ServiceKind::Global};
+    .kind = ServiceKind::Stream};
+}
+
+o2::framework::ServiceSpec ArrowSupport::arrowTableSlicingCacheSpec()
+{
+  return ServiceSpec{
+    .name = "arrow-slicing-cache",
+    .init = [](ServiceRegistry&, DeviceState&, fair::mq::ProgOptions&) -> ServiceHandle {
+      return ServiceHandle{TypeIdHelpers::uniqueId<ArrowTableSlicingCache>(), new ArrowTableSlicingCache()};
+    },
+    .configure = CommonServices::noConfiguration(),
+    .postProcessing = [](ProcessingContext&, void* service) {
+      auto* cache = reinterpret_cast<ArrowTableSlicingCache*>(service);
+      cache->reset(); },
+    .kind = ServiceKind::Stream};
 }
 
 } // namespace o2::framework
@@ -21,6 +21,8 @@ namespace o2::framework
 struct ArrowSupport {
   // Create spec for backend used to send Arrow messages
   static ServiceSpec arrowBackendSpec();
+  // Create spec for the cache of the slices of the grouped tables
+  static ServiceSpec arrowTableSlicingCacheSpec();
 };
 
 } // namespace o2::framework
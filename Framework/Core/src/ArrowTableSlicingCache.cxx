@@ -0,0 +1,129 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/ArrowTableSlicingCache.h"
+#include "Framework/RuntimeError.h"
+
+#include <arrow/array/array_primitive.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace o2::framework
+{
+
+std::vector<int64_t> SliceInfo::getRowsFor(int value) const
+{
+  std::vector<int64_t> rows(sizes[value]);
+  if (sorted) {
+    std::iota(rows.begin(), rows.end(), offsets[value]);
+  } else {
+    std::copy(permutation.begin() + offsets[value], permutation.begin() + offsets[value] + sizes[value], rows.begin());
+  }
+  return rows;
+}
+
+std::shared_ptr<SliceInfo> ArrowTableSlicingCache::computeSlices(char const* key, char const* target, std::shared_ptr<arrow::Table> const& table, int32_t groupingSize)
+{
+  auto column = table->GetColumnByName(key);
+  if (column == nullptr) {
+    throw runtime_error_f("Table %s has no index column %s", target, key);
+  }
+  auto info = std::make_shared<SliceInfo>();
+  info->offsets.resize(groupingSize, 0);
+  info->sizes.resize(groupingSize, 0);
+
+  // Count the rows of each group, and check whether they are contiguous.
+  int64_t row = 0;
+  int32_t prev = -1;
+  int32_t lastPos = -1;
+  for (auto ci = 0; ci < column->num_chunks(); ++ci) {
+    auto chunk = static_cast<arrow::NumericArray<arrow::Int32Type>>(column->chunk(ci)->data());
+    for (auto e = 0; e < chunk.length(); ++e, ++row) {
+      auto v = chunk.Value(e);
+      if (v >= 0) {
+        if (v >= groupingSize) {
+          throw runtime_error_f("Table %s has an entry with index (%d) that is larger than the grouping table size (%d)", target, v, groupingSize);
+        }
+        if (v < lastPos || (v == lastPos && prev != v)) {
+          info->sorted = false;
+        }
+        if (info->sizes[v] == 0) {
+          info->offsets[v] = row;
+        }
+        info->sizes[v]++;
+        lastPos = v;
+      }
+      prev = v;
+    }
+  }
+
+  if (info->sorted) {
+    // Empty groups start where the next one does.
+    uint64_t next = row;
+    for (auto gi = groupingSize - 1; gi >= 0; --gi) {
+      if (info->sizes[gi] == 0) {
+        info->offsets[gi] = next;
+      }
+      next = info->offsets[gi];
+    }
+    return info;
+  }
+
+  // Counting sort of the rows by index.
+  uint64_t offset = 0;
+  for (auto gi = 0; gi < groupingSize; ++gi) {
+    info->offsets[gi] = offset;
+    offset += info->sizes[gi];
+  }
+  info->permutation.resize(offset);
+  auto cursors = info->offsets;
+  row = 0;
+  for (auto ci = 0; ci < column->num_chunks(); ++ci) {
+    auto chunk = static_cast<arrow::NumericArray<arrow::Int32Type>>(column->chunk(ci)->data());
+    for (auto e = 0; e < chunk.length(); ++e, ++row) {
+      auto v = chunk.Value(e);
+      if (v >= 0) {
+        info->permutation[cursors[v]++] = row;
+      }
+    }
+  }
+  return info;
+}
+
+std::shared_ptr<SliceInfo const> ArrowTableSlicingCache::getCacheFor(char const* key, char const* target, std::shared_ptr<arrow::Table> const& table, int32_t groupingSize)
+{
+  auto column = table->GetColumnByName(key);
+  std::shared_ptr<arrow::Buffer> buffer;
+  if (column != nullptr && column->num_chunks() > 0 && column->chunk(0)->data()->buffers.size() > 1) {
+    buffer = column->chunk(0)->data()->buffers[1];
+  }
+  if (buffer == nullptr) {
+    return computeSlices(key, target, table, groupingSize);
+  }
+  void const* values = buffer->data() + column->chunk(0)->offset() * sizeof(int32_t);
+  for (auto& entry : mEntries) {
+    if (entry.values == values && entry.length == column->length() && entry.groupingSize == groupingSize && entry.key == key) {
+      hits++;
+      return entry.info;
+    }
+  }
+  misses++;
+  auto info = computeSlices(key, target, table, groupingSize);
+  mEntries.push_back(Entry{key, std::move(buffer), values, column->length(), groupingSize, info});
+  return info;
+}
+
+void ArrowTableSlicingCache::reset()
+{
+  mEntries.clear();
+}
+
+} // namespace o2::framework
@@ -21,6 +21,7 @@
 #include "Framework/Tracing.h"
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceInfo.h"
+#include "Framework/DataProcessingStats.h"
 
 #include "CommonMessageBackendsHelpers.h"
 
@@ -65,14 +66,24 @@ o2::framework::ServiceSpec CommonMessageBackends::fairMQBackendSpec()
 {
   return ServiceSpec{
     .name = "fairmq-backend",
-    .init = [](ServiceRegistry& services, DeviceState&, fair::mq::ProgOptions&) -> ServiceHandle {
+    .init = [](ServiceRegistry& services, DeviceState&, fair::mq::ProgOptions& options) -> ServiceHandle {
       auto& proxy = services.get<FairMQDeviceProxy>();
       auto context = new MessageContext(proxy);
+      // Each processing stream has its own MessageContext, the arena is
+      // split among them and the one of the device.
+      size_t arenaSize = MessageArena::sizePerContext(std::stoul(options.GetPropertyAsString("dpl-output-arena-size")) * 1024 * 1024,
+                                                      1 + std::stoul(options.GetPropertyAsString("dpl-processing-threads")));
+      if (arenaSize) {
+        context->enableArena(arenaSize, &services.get<DataProcessingStats>());
+      }
       auto& spec = services.get<DeviceSpec const>();
       auto& dataSender = services.get<DataSender>();
 
+      // Dispatching when ready is about not waiting for the end of the
+      // processing, so nothing is kept.
       auto dispatcher = [&dataSender](FairMQParts&& parts, ChannelIndex channelIndex, unsigned int) {
         dataSender.send(parts, channelIndex);
+        dataSender.flush();
       };
 
       auto matcher = [policy = spec.dispatchPolicy](o2::header::DataHeader const& header) {
@@ -92,7 +103,7 @@ o2::framework::ServiceSpec CommonMessageBackends::fairMQBackendSpec()
     .postProcessing = CommonMessageBackendsHelpers<MessageContext>::sendCallback(),
     .preEOS = CommonMessageBackendsHelpers<MessageContext>::clearContextEOS(),
     .postEOS = CommonMessageBackendsHelpers<MessageContext>::sendCallbackEOS(),
-    .kind = ServiceKind::Serial};
+    .kind = ServiceKind::Stream};
 }
 
 o2::framework::ServiceSpec CommonMessageBackends::stringBackendSpec()
@@ -105,7 +116,7 @@ o2::framework::ServiceSpec CommonMessageBackends::stringBackendSpec()
     .postProcessing = CommonMessageBackendsHelpers<StringContext>::sendCallback(),
     .preEOS = CommonMessageBackendsHelpers<StringContext>::clearContextEOS(),
     .postEOS = CommonMessageBackendsHelpers<StringContext>::sendCallbackEOS(),
-    .kind = ServiceKind::Serial};
+    .kind = ServiceKind::Stream};
 }
 
 o2::framework::ServiceSpec CommonMessageBackends::rawBufferBackendSpec()
@@ -118,7 +129,7 @@ o2::framework::ServiceSpec CommonMessageBackends::rawBufferBackendSpec()
     .postProcessing = CommonMessageBackendsHelpers<RawBufferContext>::sendCallback(),
     .preEOS = CommonMessageBackendsHelpers<RawBufferContext>::clearContextEOS(),
     .postEOS = CommonMessageBackendsHelpers<RawBufferContext>::sendCallbackEOS(),
-    .kind = ServiceKind::Serial};
+    .kind = ServiceKind::Stream};
 }
 
 } // namespace o2::framework
@@ -23,6 +23,7 @@
 #include "Framework/DataRelayer.h"
 #include "Framework/Signpost.h"
 #include "Framework/DataProcessingStats.h"
+#include "Framework/DeserializationCache.h"
 #include "Framework/CommonMessageBackends.h"
 #include "Framework/DanglingContext.h"
 #include "InputRouteHelpers.h"
@@ -120,16 +121,15 @@ o2::framework::ServiceSpec CommonServices::monitoringSpec()
     .kind = ServiceKind::Serial};
 }
 
-// Make it a service so that it can be used easily from the analysis
-// FIXME: Moreover, it makes sense that this will be duplicated on a per thread
-// basis when we get to it.
+// Make it a service so that it can be used easily from the analysis.
+// Every processing stream has its own copy.
 o2::framework::ServiceSpec CommonServices::timingInfoSpec()
 {
   return ServiceSpec{
     .name = "timing-info",
     .init = simpleServiceInit<TimingInfo, TimingInfo>(),
     .configure = noConfiguration(),
-    .kind = ServiceKind::Serial};
+    .kind = ServiceKind::Stream};
 }
 
 o2::framework::ServiceSpec CommonServices::datatakingContextSpec()
@@ -631,6 +631,12 @@ auto sendRelayerMetrics(ServiceRegistry& registry, DataProcessingStats& stats) -
     monitoring.send(Metric{(uint64_t)stats.consumedTimeframes, "consumed-timeframes"}.addTag(Key::Subsystem, Value::DPL));
   }
 
+  if (stats.arenaMessages || stats.arenaFallbacks) {
+    monitoring.send(Metric{(uint64_t)stats.arenaMessages, "output_arena/messages"}.addTag(Key::Subsystem, Value::DPL));
+    monitoring.send(Metric{(uint64_t)stats.arenaAllocatedBytes, "output_arena/allocated_bytes"}.addTag(Key::Subsystem, Value::DPL));
+    monitoring.send(Metric{(uint64_t)stats.arenaFallbacks, "output_arena/fallbacks"}.addTag(Key::Subsystem, Value::DPL));
+  }
+
   stats.lastSlowMetricSentTimestamp.store(stats.beginIterationTimestamp.load());
   stats.lastReportedPerformedComputations.store(stats.performedComputations.load());
   O2_SIGNPOST_END(MonitoringStatus::ID, MonitoringStatus::SEND, 0, 0, O2_SIGNPOST_BLUE);
@@ -732,6 +738,27 @@ o2::framework::ServiceSpec CommonServices::objectCache()
     .kind = ServiceKind::Serial};
 }
 
+o2::framework::ServiceSpec CommonServices::deserializationCache()
+{
+  return ServiceSpec{
+    .name = "deserialization-cache",
+    .init = [](ServiceRegistry&, DeviceState&, fair::mq::ProgOptions& options) -> ServiceHandle {
+      auto* cache = new DeserializationCache();
+      auto capacity = options.GetPropertyAsString("dpl-deserialization-cache");
+      cache->capacity = capacity.empty() ? 0 : std::stoul(capacity);
+      return ServiceHandle{TypeIdHelpers::uniqueId<DeserializationCache>(), cache};
+    },
+    .configure = noConfiguration(),
+    .postProcessing = [](ProcessingContext& ctx, void* service) {
+      auto* cache = reinterpret_cast<DeserializationCache*>(service);
+      cache->release(ctx.services().get<TimingInfo>().timeslice); },
+    // Also invoked when the processing failed, releasing twice is harmless.
+    .postDispatching = [](ProcessingContext& ctx, void* service) {
+      auto* cache = reinterpret_cast<DeserializationCache*>(service);
+      cache->release(ctx.services().get<TimingInfo>().timeslice); },
+    .kind = ServiceKind::Serial};
+}
+
 std::vector<ServiceSpec> CommonServices::defaultServices(int numThreads)
 {
   std::vector<ServiceSpec> specs{
@@ -752,9 +779,11 @@ std::vector<ServiceSpec> CommonServices::defaultServices(int numThreads)
     dataSender(),
     dataProcessingStats(),
     objectCache(),
+    deserializationCache(),
     ccdbSupportSpec(),
     CommonMessageBackends::fairMQBackendSpec(),
     ArrowSupport::arrowBackendSpec(),
+    ArrowSupport::arrowTableSlicingCacheSpec(),
     CommonMessageBackends::stringBackendSpec(),
     CommonMessageBackends::rawBufferBackendSpec()};
   if (numThreads) {
@@ -9,6 +9,12 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include "ComputingResourceHelpers.h"
+#include "Framework/RuntimeError.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 #include <unistd.h>
 #include <sstream>
@@ -52,4 +58,63 @@ std::vector<ComputingResource> ComputingResourceHelpers::parseResources(std::str
   return resources;
 }
 
+std::vector<int> ComputingResourceHelpers::parseCpuList(std::string const& cpuList)
+{
+  std::vector<int> cpus;
+  std::istringstream str{cpuList};
+  std::string range;
+  while (std::getline(str, range, ',')) {
+    if (range.find_first_not_of(" \t\n") == std::string::npos) {
+      continue;
+    }
+    char* end = nullptr;
+    long first = strtol(range.c_str(), &end, 10);
+    long last = first;
+    if (*end == '-') {
+      last = strtol(end + 1, &end, 10);
+    }
+    while (isspace(*end)) {
+      ++end;
+    }
+    if (end == range.c_str() || *end != '\0' || first < 0 || last < first) {
+      throw runtime_error_f("Malformed cpu list %s", cpuList.c_str());
+    }
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<NumaNodeInfo> ComputingResourceHelpers::getLocalNumaNodes()
+{
+  std::vector<NumaNodeInfo> nodes;
+  std::error_code ec;
+  for (auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+    auto name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0 || name.find_first_not_of("0123456789", 4) != std::string::npos || name.size() == 4) {
+      continue;
+    }
+    std::ifstream in{entry.path() / "cpulist"};
+    std::string cpuList;
+    if (!std::getline(in, cpuList)) {
+      continue;
+    }
+    NumaNodeInfo node{std::stoi(name.substr(4)), parseCpuList(cpuList)};
+    // Nodes with memory only are not useful to place devices.
+    if (!node.cpus.empty()) {
+      nodes.push_back(node);
+    }
+  }
+  if (nodes.empty()) {
+    NumaNodeInfo node{0, {}};
+    for (int cpu = 0; cpu < (int)std::thread::hardware_concurrency(); ++cpu) {
+      node.cpus.push_back(cpu);
+    }
+    nodes.push_back(node);
+  }
+  std::sort(nodes.begin(), nodes.end(), [](auto const& a, auto const& b) { return a.id < b.id; });
+  return nodes;
+}
+
 } // namespace o2::framework
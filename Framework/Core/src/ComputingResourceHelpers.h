@@ -19,6 +19,12 @@
 
 namespace o2::framework
 {
+/// A NUMA node of the local machine
+struct NumaNodeInfo {
+  int id = 0;
+  std::vector<int> cpus;
+};
+
 struct ComputingResourceHelpers {
   /// This will create a ComputingResource which matches what offered by localhost.
   /// Notice that the port range will always be [22000, 23000) since in any case we will
@@ -29,6 +35,13 @@ struct ComputingResourceHelpers {
   ///
   /// <hostname>:<cpu cores>:<memory in MB>:<start port>:<last port>
   static std::vector<ComputingResource> parseResources(std::string const& resourceString);
+
+  /// Parse a list of cores in the format used by the kernel, e.g. "0-3,8,10-11".
+  static std::vector<int> parseCpuList(std::string const& cpuList);
+
+  /// The NUMA nodes of the local machine and their cores. If the topology
+  /// is not available, a single node with all the cores.
+  static std::vector<NumaNodeInfo> getLocalNumaNodes();
 };
 } // namespace o2::framework
 
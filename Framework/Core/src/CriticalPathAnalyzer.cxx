@@ -0,0 +1,260 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "CriticalPathAnalyzer.h"
+#include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsInfo.h"
+#include "Framework/DeviceSpec.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include <unordered_map>
+
+namespace o2::framework
+{
+
+namespace
+{
+/// Above this fraction of the time a data processor is considered saturated,
+/// and therefore the one limiting the rate of the sources.
+constexpr double SaturatedUtilization = 0.9;
+
+double average(uint64_t total, size_t count)
+{
+  return count ? (double)total / count : 0.;
+}
+} // namespace
+
+std::string CriticalPathAnalyzer::formatSample(TimeslicePathSample const& sample)
+{
+  return fmt::format("{}:{}:{}", sample.timeslice, sample.start, sample.end);
+}
+
+bool CriticalPathAnalyzer::parseSample(char const* s, TimeslicePathSample& sample)
+{
+  int consumed = 0;
+  auto matched = sscanf(s, "%" SCNu64 ":%" SCNu64 ":%" SCNu64 "%n", &sample.timeslice, &sample.start, &sample.end, &consumed);
+  return matched == 3 && s[consumed] == '\0';
+}
+
+std::vector<CriticalPathAnalyzer::Node> CriticalPathAnalyzer::topologyFrom(std::vector<DeviceSpec> const& specs)
+{
+  std::unordered_map<std::string, size_t> senders;
+  for (size_t di = 0; di < specs.size(); ++di) {
+    for (auto& channel : specs[di].outputChannels) {
+      senders[channel.name] = di;
+    }
+  }
+  std::vector<Node> topology;
+  for (auto& spec : specs) {
+    Node node{spec.name, std::max<size_t>(spec.maxInputTimeslices, 1), {}};
+    for (auto& channel : spec.inputChannels) {
+      auto sender = senders.find(channel.name);
+      if (sender != senders.end()) {
+        node.upstream.push_back(sender->second);
+      }
+    }
+    topology.push_back(node);
+  }
+  return topology;
+}
+
+CriticalPathAnalyzer::CriticalPathAnalyzer(std::vector<Node> topology, size_t window)
+  : mTopology{std::move(topology)},
+    mWindow{window},
+    mConsumed(mTopology.size(), 0)
+{
+}
+
+void CriticalPathAnalyzer::update(std::vector<DeviceMetricsInfo> const& metrics)
+{
+  for (size_t di = 0; di < std::min(metrics.size(), mTopology.size()); ++di) {
+    auto& deviceMetrics = metrics[di];
+    auto mi = DeviceMetricsHelper::metricIdxByName(MetricName, deviceMetrics);
+    if (mi >= deviceMetrics.metrics.size() || deviceMetrics.metrics[mi].type != MetricType::String) {
+      continue;
+    }
+    auto& info = deviceMetrics.metrics[mi];
+    auto& store = deviceMetrics.stringMetrics[info.storeIdx];
+    auto available = info.filledMetrics - mConsumed[di];
+    // Only the last few strings are kept, the older ones are lost.
+    if (available > store.size()) {
+      mLostSamples += available - store.size();
+      available = store.size();
+    }
+    for (size_t back = available; back > 0; --back) {
+      TimeslicePathSample sample;
+      if (parseSample(store[(info.pos + store.size() - back) % store.size()].data, sample)) {
+        addSample(di, sample);
+      }
+    }
+    mConsumed[di] = info.filledMetrics;
+  }
+}
+
+void CriticalPathAnalyzer::addSample(size_t device, TimeslicePathSample const& sample)
+{
+  if (device >= mTopology.size()) {
+    return;
+  }
+  mPending[sample.timeslice].emplace_back(device, sample);
+  while (mPending.size() > mWindow) {
+    analyse(mPending.begin()->second);
+    mPending.erase(mPending.begin());
+  }
+}
+
+void CriticalPathAnalyzer::analyse(Samples const& samples)
+{
+  if (samples.empty()) {
+    return;
+  }
+  std::vector<int> sampleOf(mTopology.size(), -1);
+  for (size_t si = 0; si < samples.size(); ++si) {
+    sampleOf[samples[si].first] = si;
+  }
+  // For each device, the upstream one which finished last, i.e. the one
+  // whose data the device was waiting for.
+  std::vector<int> critical(samples.size(), -1);
+  for (size_t si = 0; si < samples.size(); ++si) {
+    auto& [device, sample] = samples[si];
+    auto& node = mTopology[device];
+    auto& stats = mProcessors[node.processor];
+    auto processing = sample.end > sample.start ? sample.end - sample.start : 0;
+    stats.multiplicity = node.multiplicity;
+    stats.isSource &= node.upstream.empty();
+    stats.timeslices++;
+    stats.totalProcessing += processing;
+    stats.maxProcessing = std::max(stats.maxProcessing, processing);
+
+    for (auto upstream : node.upstream) {
+      auto ui = sampleOf[upstream];
+      if (ui < 0) {
+        continue;
+      }
+      auto& from = samples[ui].second;
+      auto wait = sample.start > from.end ? sample.start - from.end : 0;
+      auto& edge = mEdges[{mTopology[upstream].processor, node.processor}];
+      edge.timeslices++;
+      edge.totalWait += wait;
+      edge.maxWait = std::max(edge.maxWait, wait);
+      if (critical[si] < 0 || from.end > samples[critical[si]].second.end) {
+        critical[si] = ui;
+      }
+    }
+  }
+
+  // The timeslice is done when the last device is, walk back from there.
+  auto last = std::max_element(samples.begin(), samples.end(), [](auto const& a, auto const& b) {
+    return a.second.end < b.second.end;
+  });
+  std::vector<std::string> path;
+  int si = last - samples.begin();
+  int first = si;
+  for (size_t steps = 0; si >= 0 && steps < samples.size(); ++steps) {
+    auto& processor = mTopology[samples[si].first].processor;
+    path.push_back(processor);
+    mProcessors[processor].onCriticalPath++;
+    first = si;
+    si = critical[si];
+    if (si >= 0) {
+      mEdges[{mTopology[samples[si].first].processor, processor}].onCriticalPath++;
+    }
+  }
+  std::reverse(path.begin(), path.end());
+  mCriticalPaths[path]++;
+
+  auto start = samples[first].second.start;
+  auto latency = last->second.end > start ? last->second.end - start : 0;
+  mTimeslices++;
+  mTotalLatency += latency;
+  mMaxLatency = std::max(mMaxLatency, latency);
+  mFirstStart = std::min(mFirstStart, start);
+  mLastStart = std::max(mLastStart, start);
+}
+
+void CriticalPathAnalyzer::writeReport(std::ostream& out)
+{
+  for (auto& [timeslice, samples] : mPending) {
+    analyse(samples);
+  }
+  mPending.clear();
+
+  // The average time between two timeslices entering the topology.
+  double period = mTimeslices > 1 ? (double)(mLastStart - mFirstStart) / (mTimeslices - 1) : 0.;
+
+  out << "{\n";
+  out << fmt::format(R"(  "timeslices": {},)", mTimeslices) << "\n";
+  out << fmt::format(R"(  "lostSamples": {},)", mLostSamples) << "\n";
+  out << fmt::format(R"(  "periodUs": {:.1f},)", period) << "\n";
+  out << fmt::format(R"(  "averageLatencyUs": {:.1f},)", average(mTotalLatency, mTimeslices)) << "\n";
+  out << fmt::format(R"(  "maxLatencyUs": {},)", mMaxLatency) << "\n";
+
+  std::vector<std::string> suggestions;
+  out << R"(  "processors": [)";
+  bool first = true;
+  for (auto& [name, stats] : mProcessors) {
+    auto processing = average(stats.totalProcessing, stats.timeslices);
+    // A data processor keeps up when it can process a timeslice per period
+    // with its multiplicity. If it is saturated, it is probably what limits
+    // the sources, so the measured period is not the one which could be
+    // achieved and it needs at least one more instance.
+    double utilization = period > 0 ? processing / (period * stats.multiplicity) : 0.;
+    size_t suggested = stats.multiplicity;
+    if (stats.isSource == false && period > 0) {
+      suggested = std::max<size_t>(suggested, std::ceil(processing / period));
+      if (utilization > SaturatedUtilization) {
+        suggested = std::max(suggested, stats.multiplicity + 1);
+      }
+    }
+    if (suggested != stats.multiplicity) {
+      suggestions.push_back(fmt::format("{}:{}", name, suggested));
+    }
+    out << (first ? "\n" : ",\n");
+    out << fmt::format(R"(    {{"name": "{}", "multiplicity": {}, "suggestedMultiplicity": {}, "timeslices": {}, )"
+                       R"("averageProcessingUs": {:.1f}, "maxProcessingUs": {}, "utilization": {:.3f}, "onCriticalPath": {}}})",
+                       name, stats.multiplicity, suggested, stats.timeslices,
+                       processing, stats.maxProcessing, utilization, stats.onCriticalPath);
+    first = false;
+  }
+  out << "\n  ],\n";
+
+  out << R"(  "edges": [)";
+  first = true;
+  for (auto& [names, stats] : mEdges) {
+    out << (first ? "\n" : ",\n");
+    out << fmt::format(R"(    {{"from": "{}", "to": "{}", "timeslices": {}, "averageQueueingUs": {:.1f}, "maxQueueingUs": {}, "onCriticalPath": {}}})",
+                       names.first, names.second, stats.timeslices, average(stats.totalWait, stats.timeslices), stats.maxWait, stats.onCriticalPath);
+    first = false;
+  }
+  out << "\n  ],\n";
+
+  // The path which most often determined when a timeslice was done.
+  auto critical = std::max_element(mCriticalPaths.begin(), mCriticalPaths.end(), [](auto const& a, auto const& b) {
+    return a.second < b.second;
+  });
+  out << R"(  "criticalPath": [)";
+  if (critical != mCriticalPaths.end()) {
+    for (size_t pi = 0; pi < critical->first.size(); ++pi) {
+      out << (pi ? ", \"" : "\"") << critical->first[pi] << "\"";
+    }
+  }
+  out << "],\n";
+  out << fmt::format(R"(  "criticalPathTimeslices": {},)", critical != mCriticalPaths.end() ? critical->second : 0) << "\n";
+  out << fmt::format(R"(  "suggestedPipeline": "{}")", fmt::join(suggestions, ",")) << "\n";
+  out << "}\n";
+}
+
+} // namespace o2::framework
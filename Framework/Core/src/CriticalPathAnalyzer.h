@@ -0,0 +1,116 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_CRITICALPATHANALYZER_H_
+#define O2_FRAMEWORK_CRITICALPATHANALYZER_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::framework
+{
+
+struct DeviceSpec;
+struct DeviceMetricsInfo;
+
+/// When a device processed a given timeslice. Times are in us of the
+/// monotonic clock, which is shared by all the devices of a machine.
+struct TimeslicePathSample {
+  uint64_t timeslice = 0;
+  uint64_t start = 0;
+  uint64_t end = 0;
+};
+
+/// Reconstructs the path of each timeslice through the topology from the
+/// samples reported by the devices and summarises where the time goes: the
+/// processing time of each data processor, the time spent between the end
+/// of a device and the start of the next one (transport and queueing), the
+/// critical path, i.e. the chain of devices which determined when the
+/// timeslice was done, and the --pipeline multiplicities which would allow
+/// each data processor to keep up with the rate of the sources.
+class CriticalPathAnalyzer
+{
+ public:
+  /// The metric used by the devices to report a TimeslicePathSample
+  static constexpr char const* MetricName = "timeslice-path";
+
+  /// A device of the topology.
+  struct Node {
+    /// The name of the associated data processor
+    std::string processor;
+    /// The --pipeline multiplicity of the data processor
+    size_t multiplicity = 1;
+    /// The devices sending data to this one
+    std::vector<size_t> upstream;
+  };
+
+  static std::string formatSample(TimeslicePathSample const& sample);
+  static bool parseSample(char const* s, TimeslicePathSample& sample);
+  /// Connect the devices which share a channel.
+  static std::vector<Node> topologyFrom(std::vector<DeviceSpec> const& specs);
+
+  /// At most @a window timeslices are kept waiting for the samples of all
+  /// the devices, the older ones are analysed with what is available.
+  CriticalPathAnalyzer(std::vector<Node> topology, size_t window = 1024);
+
+  /// Pick up the samples reported since the last invocation. @a metrics
+  /// are indexed like the topology.
+  void update(std::vector<DeviceMetricsInfo> const& metrics);
+  void addSample(size_t device, TimeslicePathSample const& sample);
+
+  /// Analyse the pending timeslices and write the summary as JSON.
+  void writeReport(std::ostream& out);
+
+ private:
+  struct ProcessorStats {
+    size_t multiplicity = 1;
+    bool isSource = true;
+    size_t timeslices = 0;
+    uint64_t totalProcessing = 0;
+    uint64_t maxProcessing = 0;
+    size_t onCriticalPath = 0;
+  };
+
+  struct EdgeStats {
+    size_t timeslices = 0;
+    uint64_t totalWait = 0;
+    uint64_t maxWait = 0;
+    size_t onCriticalPath = 0;
+  };
+
+  using Samples = std::vector<std::pair<size_t, TimeslicePathSample>>;
+  void analyse(Samples const& samples);
+
+  std::vector<Node> mTopology;
+  size_t mWindow;
+  /// How many samples were already read from the metrics of each device
+  std::vector<size_t> mConsumed;
+  /// Samples of the timeslices not analysed yet
+  std::map<uint64_t, Samples> mPending;
+
+  std::map<std::string, ProcessorStats> mProcessors;
+  std::map<std::pair<std::string, std::string>, EdgeStats> mEdges;
+  std::map<std::vector<std::string>, size_t> mCriticalPaths;
+  size_t mTimeslices = 0;
+  size_t mLostSamples = 0;
+  uint64_t mTotalLatency = 0;
+  uint64_t mMaxLatency = 0;
+  /// When the first and last analysed timeslices entered the topology
+  uint64_t mFirstStart = -1;
+  uint64_t mLastStart = 0;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_CRITICALPATHANALYZER_H_
@@ -265,11 +265,11 @@ void DataAllocator::adopt(const Output& spec, std::shared_ptr<arrow::Table> ptr)
 void DataAllocator::snapshot(const Output& spec, const char* payload, size_t payloadSize,
                              o2::header::SerializationMethod serializationMethod)
 {
-  auto& proxy = mRegistry->get<FairMQDeviceProxy>();
+  auto& context = mRegistry->get<MessageContext>();
   auto& timingInfo = mRegistry->get<TimingInfo>();
 
   RouteIndex routeIndex = matchDataHeader(spec, timingInfo.timeslice);
-  FairMQMessagePtr payloadMessage(proxy.createOutputMessage(routeIndex, payloadSize));
+  FairMQMessagePtr payloadMessage(context.createMessage(routeIndex, 0, payloadSize));
   memcpy(payloadMessage->GetData(), payload, payloadSize);
 
   addPartToContext(std::move(payloadMessage), spec, serializationMethod);
@@ -0,0 +1,168 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/DataDescriptorLookup.h"
+#include "Headers/Stack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+
+namespace o2::framework::data_matcher
+{
+
+namespace
+{
+/// The constant values a matcher requires, if any.
+struct Constraints {
+  std::optional<std::string> origin;
+  std::optional<std::string> description;
+  std::optional<header::DataHeader::SubSpecificationType> subSpec;
+};
+
+template <typename T, typename HOLDER>
+void constantOf(HOLDER const& holder, std::optional<T>& result)
+{
+  if (result) {
+    return;
+  }
+  holder.visit([&result](auto const& value) {
+    if constexpr (std::is_same_v<std::decay_t<decltype(value)>, T>) {
+      result = value;
+    }
+  });
+}
+
+/// Only the leaves reachable through And clauses are conditions
+/// which every accepted header must satisfy.
+void collectConstraints(DataDescriptorMatcher const& matcher, Constraints& constraints)
+{
+  auto collect = [&constraints](Node const& node) {
+    if (auto pval = std::get_if<OriginValueMatcher>(&node)) {
+      constantOf(*pval, constraints.origin);
+    } else if (auto pval = std::get_if<DescriptionValueMatcher>(&node)) {
+      constantOf(*pval, constraints.description);
+    } else if (auto pval = std::get_if<SubSpecificationTypeValueMatcher>(&node)) {
+      constantOf(*pval, constraints.subSpec);
+    } else if (auto pval = std::get_if<std::unique_ptr<DataDescriptorMatcher>>(&node)) {
+      collectConstraints(**pval, constraints);
+    }
+  };
+  switch (matcher.getOp()) {
+    case DataDescriptorMatcher::Op::And:
+      collect(matcher.getLeft());
+      collect(matcher.getRight());
+      break;
+    case DataDescriptorMatcher::Op::Just:
+      collect(matcher.getLeft());
+      break;
+    default:
+      break;
+  }
+}
+
+/// Where the next candidate in @a positions starting from @a cursor is, or
+/// INVALID if there are no more.
+size_t peek(std::vector<size_t> const* positions, size_t cursor)
+{
+  if (positions == nullptr || cursor >= positions->size()) {
+    return DataDescriptorLookup::INVALID;
+  }
+  return (*positions)[cursor];
+}
+} // namespace
+
+DataDescriptorLookup::Key DataDescriptorLookup::makeKey(char const* origin, char const* description, header::DataHeader::SubSpecificationType subSpec)
+{
+  // Like the matchers, only compare up to the first null character.
+  char bytes[sizeof(Key::words)] = {0};
+  memcpy(bytes, origin, strnlen(origin, header::DataOrigin::size));
+  memcpy(bytes + header::DataOrigin::size, &subSpec, sizeof(subSpec));
+  memcpy(bytes + header::DataOrigin::size + sizeof(subSpec), description, strnlen(description, header::DataDescription::size));
+  Key key;
+  memcpy(key.words, bytes, sizeof(bytes));
+  return key;
+}
+
+DataDescriptorLookup::Key DataDescriptorLookup::typeOf(Key key)
+{
+  char bytes[sizeof(Key::words)];
+  memcpy(bytes, key.words, sizeof(bytes));
+  memset(bytes + header::DataOrigin::size, 0, sizeof(header::DataHeader::SubSpecificationType));
+  memcpy(key.words, bytes, sizeof(bytes));
+  return key;
+}
+
+DataDescriptorLookup::DataDescriptorLookup(std::vector<DataDescriptorMatcher> const& matchers, std::vector<size_t> const& index)
+{
+  for (size_t ri = 0; ri < index.size(); ++ri) {
+    auto& matcher = matchers[index[ri]];
+    mMatchers.push_back(&matcher);
+
+    Constraints constraints;
+    collectConstraints(matcher, constraints);
+    if (!constraints.origin || !constraints.description) {
+      mFallbacks.push_back(ri);
+      continue;
+    }
+    auto key = makeKey(constraints.origin->c_str(), constraints.description->c_str(), constraints.subSpec.value_or(0));
+    if (constraints.subSpec) {
+      mExact[key].push_back(ri);
+    } else {
+      mTypes[typeOf(key)].push_back(ri);
+    }
+  }
+}
+
+size_t DataDescriptorLookup::match(char const* data, VariableContext& context) const
+{
+  std::vector<size_t> const* exact = nullptr;
+  std::vector<size_t> const* types = nullptr;
+  std::vector<size_t> const* fallbacks = &mFallbacks;
+  std::vector<size_t> all;
+
+  auto dh = o2::header::get<header::DataHeader*>(data);
+  if (dh != nullptr) {
+    auto key = makeKey(dh->dataOrigin.str, dh->dataDescription.str, dh->subSpecification);
+    if (auto it = mExact.find(key); it != mExact.end()) {
+      exact = &it->second;
+    }
+    if (auto it = mTypes.find(typeOf(key)); it != mTypes.end()) {
+      types = &it->second;
+    }
+  } else {
+    // Without a DataHeader let the matchers themselves decide what to do.
+    for (size_t ri = 0; ri < mMatchers.size(); ++ri) {
+      all.push_back(ri);
+    }
+    fallbacks = &all;
+  }
+
+  // Try the candidates in the order of the index, so that the first
+  // matcher accepting the header wins, like when trying all of them.
+  size_t ei = 0, ti = 0, fi = 0;
+  while (true) {
+    auto next = std::min({peek(exact, ei), peek(types, ti), peek(fallbacks, fi)});
+    if (next == INVALID) {
+      return INVALID;
+    }
+    ei += peek(exact, ei) == next;
+    ti += peek(types, ti) == next;
+    fi += peek(fallbacks, fi) == next;
+    if (mMatchers[next]->match(data, context)) {
+      context.commit();
+      return next;
+    }
+    context.discard();
+  }
+}
+
+} // namespace o2::framework::data_matcher
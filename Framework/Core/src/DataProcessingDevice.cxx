@@ -18,6 +18,7 @@
 #include "Framework/ComputingQuotaEvaluator.h"
 #include "Framework/DataProcessingHeader.h"
 #include "Framework/DataProcessor.h"
+#include "Framework/DataSender.h"
 #include "Framework/DataSpecUtils.h"
 #include "Framework/DeviceState.h"
 #include "Framework/DispatchPolicy.h"
@@ -35,11 +36,14 @@
 #include "Framework/InputSpan.h"
 #include "Framework/Signpost.h"
 #include "Framework/SourceInfoHeader.h"
+#include "Framework/TraceRecorder.h"
+#include "Framework/VariableContextHelpers.h"
 #include "Framework/Logger.h"
 #include "Framework/DriverClient.h"
 #include "Framework/Monitoring.h"
 #include "PropertyTreeHelpers.h"
 #include "DataProcessingStatus.h"
+#include "CriticalPathAnalyzer.h"
 #include "Framework/DataProcessingHelpers.h"
 #include "DataRelayerHelpers.h"
 #include "ProcessingPoliciesHelpers.h"
@@ -65,6 +69,7 @@
 #include <unordered_map>
 #include <uv.h>
 #include <execinfo.h>
+#include <fstream>
 #include <sstream>
 #include <boost/property_tree/json_parser.hpp>
 
@@ -611,6 +616,21 @@ void DataProcessingDevice::InitTask()
   mDeviceContext.expectedRegionCallbacks = std::stoi(fConfig->GetValue<std::string>("expected-region-callbacks"));
   mDeviceContext.exitTransitionTimeout = std::stoi(fConfig->GetValue<std::string>("exit-transition-timeout"));
 
+  // Processing streams, each one with its own copy of the stream services,
+  // so that the allocations of the different streams do not clash.
+  int processingThreads = std::stoi(fConfig->GetValue<std::string>("dpl-processing-threads"));
+  mStreamPool.reset();
+  mStreamContexts.clear();
+  if (processingThreads > 0) {
+    LOGP(info, "Processing data with {} threads", processingThreads);
+    for (int si = 0; si < processingThreads; ++si) {
+      auto stream = std::make_unique<StreamContext>(mServiceRegistry, mSpec.outputs);
+      stream->registry.declareStreamServices(mServiceRegistry, mState, *fConfig);
+      mStreamContexts.emplace_back(std::move(stream));
+    }
+    mStreamPool = std::make_unique<TaskStreamPool>(processingThreads);
+  }
+
   for (auto& channel : fChannels) {
     channel.second.at(0).Transport()->SubscribeToRegionEvents([&context = mDeviceContext,
                                                                &registry = mServiceRegistry,
@@ -638,6 +658,21 @@ void DataProcessingDevice::InitTask()
   sigusr1Handle->data = &mDeviceContext;
   uv_signal_start(sigusr1Handle, on_signal_callback, SIGUSR1);
 
+  // The driver does the critical path analysis, if requested.
+  mDeviceContext.reportTimeslicePath = fConfig->GetValue<std::string>("dpl-critical-path").empty() == false;
+
+  // Timeline of the last events of each thread, dumped at the end of the
+  // run and whenever SIGUSR2 is received.
+  mTracePrefix = fConfig->GetValue<std::string>("dpl-trace");
+  if (mTracePrefix.empty() == false) {
+    TraceRecorder::instance().enable();
+    uv_signal_t* sigusr2Handle = (uv_signal_t*)malloc(sizeof(uv_signal_t));
+    uv_signal_init(mState.loop, sigusr2Handle);
+    sigusr2Handle->data = this;
+    uv_signal_start(
+      sigusr2Handle, [](uv_signal_t* handle, int) { ((DataProcessingDevice*)handle->data)->dumpTrace(); }, SIGUSR2);
+  }
+
   /// Initialise the pollers
   DataProcessingDevice::initPollers();
 
@@ -698,6 +733,9 @@ void DataProcessingDevice::fillContext(DataProcessorContext& context, DeviceCont
   context.deviceContext = &deviceContext;
   /// Callback for the error handling
   context.errorHandling = &mErrorHandling;
+  context.streams = mStreamPool.get();
+  context.streamContexts = &mStreamContexts;
+  context.streamMutex = &mStreamMutex;
   /// We must make sure there is no optional
   /// if we want to optimize the forwarding
   context.canForwardEarly = (mSpec.forwards.empty() == false) && mProcessingPolicies.earlyForward != EarlyForwardPolicy::NEVER;
@@ -734,8 +772,28 @@ void DataProcessingDevice::PreRun()
 void DataProcessingDevice::PostRun()
 {
   stopPollers();
+  if (mStreamPool) {
+    mStreamPool->waitIdle();
+  }
+  mServiceRegistry.get<DataSender>().flush();
   mServiceRegistry.get<CallbackService>()(CallbackService::Id::Stop);
   mServiceRegistry.postStopCallbacks();
+  if (mTracePrefix.empty() == false) {
+    dumpTrace();
+  }
+}
+
+void DataProcessingDevice::dumpTrace()
+{
+  // The driver merges the traces of all the devices using the same naming.
+  auto filename = fmt::format("{}-{}.json", mTracePrefix, mSpec.id);
+  std::ofstream out(filename);
+  if (out.is_open() == false) {
+    LOGP(warning, "Could not write trace to {}", filename);
+    return;
+  }
+  TraceRecorder::instance().dumpChromeTrace(out, getpid(), mSpec.id);
+  LOGP(info, "Trace of the last processed events written to {}", filename);
 }
 
 void DataProcessingDevice::Reset()
@@ -1005,6 +1063,18 @@ void DataProcessingDevice::doPrepare(DataProcessorContext& context)
   }
 }
 
+namespace
+{
+/// Take the lock shared with the processing streams, if any.
+std::unique_lock<std::mutex> lockStreams(DataProcessorContext& context)
+{
+  if (context.streams == nullptr) {
+    return {};
+  }
+  return std::unique_lock<std::mutex>(*context.streamMutex);
+}
+} // namespace
+
 void DataProcessingDevice::doRun(DataProcessorContext& context)
 {
   auto switchState = [&registry = context.registry,
@@ -1024,9 +1094,12 @@ void DataProcessingDevice::doRun(DataProcessorContext& context)
   *context.wasActive |= DataProcessingDevice::tryDispatchComputation(context, *context.completed);
   DanglingContext danglingContext{*context.registry};
 
-  context.registry->preDanglingCallbacks(danglingContext);
-  if (*context.wasActive == false) {
-    context.registry->get<CallbackService>()(CallbackService::Id::Idle);
+  {
+    auto lock = lockStreams(context);
+    context.registry->preDanglingCallbacks(danglingContext);
+    if (*context.wasActive == false) {
+      context.registry->get<CallbackService>()(CallbackService::Id::Idle);
+    }
   }
   auto activity = context.relayer->processDanglingInputs(*context.expirationHandlers, *context.registry, true);
   *context.wasActive |= activity.expiredSlots > 0;
@@ -1034,7 +1107,10 @@ void DataProcessingDevice::doRun(DataProcessorContext& context)
   context.completed->clear();
   *context.wasActive |= DataProcessingDevice::tryDispatchComputation(context, *context.completed);
 
-  context.registry->postDanglingCallbacks(danglingContext);
+  {
+    auto lock = lockStreams(context);
+    context.registry->postDanglingCallbacks(danglingContext);
+  }
 
   // If we got notified that all the sources are done, we call the EndOfStream
   // callback and return false. Notice that what happens next is actually
@@ -1057,11 +1133,16 @@ void DataProcessingDevice::doRun(DataProcessorContext& context)
     while (DataProcessingDevice::tryDispatchComputation(context, *context.completed) && hasOnlyGenerated == false) {
       context.relayer->processDanglingInputs(*context.expirationHandlers, *context.registry, false);
     }
+    // The end of stream must follow whatever is still being processed.
+    if (context.streams) {
+      context.streams->waitIdle();
+    }
     EndOfStreamContext eosContext{*context.registry, *context.allocator};
 
     context.registry->preEOSCallbacks(eosContext);
     context.registry->get<CallbackService>()(CallbackService::Id::EndOfStream, eosContext);
     context.registry->postEOSCallbacks(eosContext);
+    context.registry->get<DataSender>().flush();
 
     for (auto& channel : context.deviceContext->spec->outputChannels) {
       DataProcessingHelpers::sendEndOfStream(*context.deviceContext->device, channel);
@@ -1093,6 +1174,9 @@ void DataProcessingDevice::doRun(DataProcessorContext& context)
 
 void DataProcessingDevice::ResetTask()
 {
+  if (mStreamPool) {
+    mStreamPool->waitIdle();
+  }
   mRelayer->clear();
 }
 
@@ -1249,6 +1333,12 @@ void DataProcessingDevice::handleData(DataProcessorContext& context, InputChanne
             nPayloadsPerHeader = 1;
             ii += (nMessages / 2) - 1;
           }
+          TraceScope relayScope{TraceCategory::Relay, "relay"};
+          // Walking the header stack for the timeslice is only worth it when tracing.
+          if (TraceRecorder::instance().enabled()) {
+            auto dph = o2::header::get<DataProcessingHeader*>(parts.At(headerIndex)->GetData());
+            relayScope.setTimeslice(dph ? dph->startTime : -1);
+          }
           auto relayed = relayer.relay(parts.At(headerIndex)->GetData(),
                                        &parts.At(headerIndex),
                                        nMessages,
@@ -1328,12 +1418,16 @@ void DataProcessingDevice::handleData(DataProcessorContext& context, InputChanne
     return;
   }
   if (oldestPossibleTimeslice != (size_t)-1) {
+    // The processing streams send and update the oldest possible output as well.
+    auto lock = lockStreams(context);
     TimesliceIndex& timesliceIndex = context.registry->get<TimesliceIndex>();
     auto r = timesliceIndex.setOldestPossibleInput({oldestPossibleTimeslice}, info.id);
     timesliceIndex.updateOldestPossibleOutput();
     auto& proxy = context.registry->get<FairMQDeviceProxy>();
     auto oldestPossibleOutput = context.relayer->getOldestPossibleOutput();
     LOGP(detail, "Broadcasting possible output {}", oldestPossibleOutput.timeslice.value);
+    // Outputs still being kept must not arrive after the new oldest possible timeslice.
+    context.registry->get<DataSender>().flush();
     context.registry->get<CallbackService>()(CallbackService::Id::DomainInfoUpdated, *(context.registry), (size_t)oldestPossibleOutput.timeslice.value);
     DataProcessingHelpers::broadcastOldestPossibleTimeslice(proxy, oldestPossibleOutput.timeslice.value);
   }
@@ -1380,6 +1474,150 @@ void update_maximum(std::atomic<T>& maximum_value, T const& value) noexcept
          !maximum_value.compare_exchange_weak(prev_value, value)) {
   }
 }
+
+InputSpan makeInputSpan(std::vector<MessageSet>& inputs)
+{
+  auto getter = [&inputs](size_t i, size_t partindex) -> DataRef {
+    if (inputs[i].getNumberOfPairs() > partindex) {
+      const char* headerptr = nullptr;
+      const char* payloadptr = nullptr;
+      size_t payloadSize = 0;
+      // - each input can have multiple parts
+      // - "part" denotes a sequence of messages belonging together, the first message of the
+      //   sequence is the header message
+      // - each part has one or more payload messages
+      // - InputRecord provides all payloads as header-payload pairs
+      auto const& headerMsg = inputs[i].associatedHeader(partindex);
+      auto const& payloadMsg = inputs[i].associatedPayload(partindex);
+      headerptr = static_cast<char const*>(headerMsg->GetData());
+      payloadptr = payloadMsg ? static_cast<char const*>(payloadMsg->GetData()) : nullptr;
+      payloadSize = payloadMsg ? payloadMsg->GetSize() : 0;
+      return DataRef{nullptr, headerptr, payloadptr, payloadSize};
+    }
+    return DataRef{};
+  };
+  auto nofPartsGetter = [&inputs](size_t i) -> size_t {
+    return inputs[i].getNumberOfPairs();
+  };
+  return InputSpan{getter, nofPartsGetter, inputs.size()};
+}
+
+void preUpdateStats(DataProcessingStats& stats, DataRelayer::RecordAction const& action, InputRecord const& record)
+{
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t ai = 0; ai != record.size(); ai++) {
+    auto cacheId = action.slot.index * record.size() + ai;
+    auto state = record.isValid(ai) ? 2 : 0;
+    update_maximum(stats.statesSize, cacheId + 1);
+    assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
+    stats.relayerState[cacheId].store(state);
+  }
+}
+
+void postUpdateStats(DataProcessingStats& stats, DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t tStart)
+{
+  std::atomic_thread_fence(std::memory_order_release);
+  for (size_t ai = 0; ai != record.size(); ai++) {
+    auto cacheId = action.slot.index * record.size() + ai;
+    auto state = record.isValid(ai) ? 3 : 0;
+    update_maximum(stats.statesSize, cacheId + 1);
+    assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
+    stats.relayerState[cacheId].store(state);
+  }
+  uint64_t tEnd = uv_hrtime();
+  stats.lastElapsedTimeMs = tEnd - tStart;
+  stats.lastProcessedSize = calculateTotalInputRecordSize(record);
+  stats.totalProcessedSize += stats.lastProcessedSize;
+  stats.lastLatency = calculateInputRecordLatency(record, tStart);
+}
+
+/// Tell the driver when a timeslice was processed, so that it can
+/// reconstruct its path through the topology.
+void reportTimeslicePath(DataProcessorContext& context, ServiceRegistry& registry, uint64_t timeslice, uint64_t tStart)
+{
+  using o2::monitoring::Metric;
+  using o2::monitoring::Monitoring;
+  using o2::monitoring::tags::Key;
+  using o2::monitoring::tags::Value;
+
+  if (context.deviceContext->reportTimeslicePath == false) {
+    return;
+  }
+  TimeslicePathSample sample{timeslice, tStart / 1000, uv_hrtime() / 1000};
+  registry.get<Monitoring>().send(Metric{CriticalPathAnalyzer::formatSample(sample), CriticalPathAnalyzer::MetricName}.addTag(Key::Subsystem, Value::DPL));
+}
+
+/// Process a set of inputs which was already consumed from the relayer
+/// using the resources of @a stream. Only the user callback runs
+/// concurrently with the other streams, everything which touches shared
+/// services is serialised via the stream mutex.
+void processInStream(DataProcessorContext& context, StreamContext& stream,
+                     DataRelayer::RecordAction const& action, std::vector<MessageSet>& inputs,
+                     TimingInfo const& timingInfo)
+{
+  ZoneScopedN("DataProcessingDevice::processInStream");
+  auto& registry = stream.registry;
+  auto& stats = context.registry->get<DataProcessingStats>();
+  registry.get<TimingInfo>() = timingInfo;
+  InputSpan span = makeInputSpan(inputs);
+  InputRecord record{context.deviceContext->spec->inputs, span, registry};
+  ProcessingContext processContext{record, registry, stream.allocator};
+  uint64_t tStart = uv_hrtime();
+
+  static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
+
+  auto runNoCatch = [&]() {
+    if (context.deviceContext->state->quitRequested) {
+      return;
+    }
+    {
+      std::scoped_lock<std::mutex> lock(*context.streamMutex);
+      preUpdateStats(stats, action, record);
+      registry.preProcessingCallbacks(processContext);
+      registry.get<CallbackService>()(CallbackService::Id::PreProcessing, registry, (int)action.op);
+    }
+    TraceScope processScope{TraceCategory::Processing, "process", timingInfo.timeslice};
+    if (*context.statefulProcess) {
+      ZoneScopedN("statefull process");
+      (*context.statefulProcess)(processContext);
+    } else if (*context.statelessProcess) {
+      ZoneScopedN("stateless process");
+      (*context.statelessProcess)(processContext);
+    }
+    // Notify the sink we just consumed some timeframe data
+    if (context.isSink) {
+      stream.allocator.make<int>(OutputRef{"dpl-summary", compile_time_hash(context.deviceContext->spec->name.c_str())}, 1);
+    }
+    std::scoped_lock<std::mutex> lock(*context.streamMutex);
+    registry.get<CallbackService>()(CallbackService::Id::PostProcessing, registry, (int)action.op);
+    registry.postProcessingCallbacks(processContext);
+    registry.get<DataSender>().endOfTimeslice();
+  };
+
+  if (noCatch) {
+    runNoCatch();
+  } else {
+    try {
+      runNoCatch();
+    } catch (std::exception& ex) {
+      ZoneScopedN("error handling");
+      std::scoped_lock<std::mutex> lock(*context.streamMutex);
+      auto e = runtime_error(ex.what());
+      (*context.errorHandling)(e, record);
+    } catch (o2::framework::RuntimeErrorRef e) {
+      ZoneScopedN("error handling");
+      std::scoped_lock<std::mutex> lock(*context.streamMutex);
+      (*context.errorHandling)(e, record);
+    }
+  }
+
+  std::scoped_lock<std::mutex> lock(*context.streamMutex);
+  context.relayer->endProcessing(TimesliceId{timingInfo.timeslice});
+  postUpdateStats(stats, action, record, tStart);
+  reportTimeslicePath(context, registry, timingInfo.timeslice, tStart);
+  registry.postDispatchingCallbacks(processContext);
+  registry.get<CallbackService>()(CallbackService::Id::DataConsumed, registry);
+}
 } // namespace
 
 bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context, std::vector<DataRelayer::RecordAction>& completed)
@@ -1426,29 +1664,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     } else {
       currentSetOfInputs = relayer->consumeExistingInputsForTimeslice(slot);
     }
-    auto getter = [&currentSetOfInputs](size_t i, size_t partindex) -> DataRef {
-      if (currentSetOfInputs[i].getNumberOfPairs() > partindex) {
-        const char* headerptr = nullptr;
-        const char* payloadptr = nullptr;
-        size_t payloadSize = 0;
-        // - each input can have multiple parts
-        // - "part" denotes a sequence of messages belonging together, the first message of the
-        //   sequence is the header message
-        // - each part has one or more payload messages
-        // - InputRecord provides all payloads as header-payload pairs
-        auto const& headerMsg = currentSetOfInputs[i].associatedHeader(partindex);
-        auto const& payloadMsg = currentSetOfInputs[i].associatedPayload(partindex);
-        headerptr = static_cast<char const*>(headerMsg->GetData());
-        payloadptr = payloadMsg ? static_cast<char const*>(payloadMsg->GetData()) : nullptr;
-        payloadSize = payloadMsg ? payloadMsg->GetSize() : 0;
-        return DataRef{nullptr, headerptr, payloadptr, payloadSize};
-      }
-      return DataRef{};
-    };
-    auto nofPartsGetter = [&currentSetOfInputs](size_t i) -> size_t {
-      return currentSetOfInputs[i].getNumberOfPairs();
-    };
-    return InputSpan{getter, nofPartsGetter, currentSetOfInputs.size()};
+    return makeInputSpan(currentSetOfInputs);
   };
 
   auto markInputsAsDone = [&relayer = context.relayer](TimesliceSlot slot) -> void {
@@ -1644,7 +1860,10 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       }
       auto& channel = device->GetChannel(spec->forwards[fi].channel, 0);
       // in DPL we are using subchannel 0 only
-      channel.Send(forwardedParts[fi]);
+      {
+        TraceScope sendScope{TraceCategory::Sending, "forward", VariableContextHelpers::getTimeslice(timesliceIndex.getVariablesForSlot(slot)).value};
+        channel.Send(forwardedParts[fi]);
+      }
 
       // The oldest possible timeslice for a forwarded message
       // is conservatively the one of the device doing the forwarding.
@@ -1667,31 +1886,34 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     return false;
   }
 
-  auto postUpdateStats = [&stats = context.registry->get<DataProcessingStats>()](DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t tStart) {
-    std::atomic_thread_fence(std::memory_order_release);
-    for (size_t ai = 0; ai != record.size(); ai++) {
-      auto cacheId = action.slot.index * record.size() + ai;
-      auto state = record.isValid(ai) ? 3 : 0;
-      update_maximum(stats.statesSize, cacheId + 1);
-      assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
-      stats.relayerState[cacheId].store(state);
-    }
-    uint64_t tEnd = uv_hrtime();
-    stats.lastElapsedTimeMs = tEnd - tStart;
-    stats.lastProcessedSize = calculateTotalInputRecordSize(record);
-    stats.totalProcessedSize += stats.lastProcessedSize;
-    stats.lastLatency = calculateInputRecordLatency(record, tStart);
-  };
+  auto& stats = context.registry->get<DataProcessingStats>();
 
-  auto preUpdateStats = [&stats = context.registry->get<DataProcessingStats>()](DataRelayer::RecordAction const& action, InputRecord const& record, uint64_t) {
-    std::atomic_thread_fence(std::memory_order_release);
-    for (size_t ai = 0; ai != record.size(); ai++) {
-      auto cacheId = action.slot.index * record.size() + ai;
-      auto state = record.isValid(ai) ? 2 : 0;
-      update_maximum(stats.statesSize, cacheId + 1);
-      assert(cacheId < DataProcessingStats::MAX_RELAYER_STATES);
-      stats.relayerState[cacheId].store(state);
+  // Consume the inputs on this thread and hand them over to a processing
+  // stream. Forwarding happens here, before the processing, so that it
+  // stays in order.
+  auto dispatchToStream = [&context, &currentSetOfInputs, &getInputSpan,
+                           &forwardInputs, &markInputsAsDone,
+                           &prepareAllocatorForCurrentTimeSlice](DataRelayer::RecordAction const& action) {
+    ZoneScopedN("DataProcessingDevice::dispatchToStream");
+    prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
+    // The slot is invalidated by the consumption, but the timeslice
+    // must still hold back the oldest possible output until the
+    // stream has sent its outputs.
+    context.relayer->beginProcessing(action.slot);
+    InputSpan span = getInputSpan(action.slot, true);
+    if (context.deviceContext->spec->forwards.empty() == false) {
+      InputRecord record{context.deviceContext->spec->inputs, span, *context.registry};
+      auto lock = lockStreams(context);
+      forwardInputs(action.slot, record, true, true);
     }
+    // Once consumed the slot can be given to a new timeslice while the
+    // stream is processing, so its status is updated here rather than
+    // when the stream is done.
+    markInputsAsDone(action.slot);
+    auto inputs = std::make_shared<std::vector<MessageSet>>(std::move(currentSetOfInputs));
+    context.streams->push([&context, action, inputs, timingInfo = *context.timingInfo](TaskStreamRef ref) {
+      processInStream(context, *context.streamContexts->at(ref.index), action, *inputs, timingInfo);
+    });
   };
 
   // This is the main dispatching loop
@@ -1702,6 +1924,24 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       LOGP(debug, "  - Action is to Wait");
       continue;
     }
+    TraceScope dispatchScope{TraceCategory::Dispatch, "dispatch"};
+    // Looking up the timeslice takes the relayer lock, only pay for it when tracing.
+    if (TraceRecorder::instance().enabled()) {
+      dispatchScope.setTimeslice(context.relayer->getTimesliceForSlot(action.slot).value);
+    }
+    // Only consuming a complete set of inputs can be done in parallel.
+    // Anything else needs the streams to be done with the previous
+    // timeslices and is processed inline.
+    if (context.streams != nullptr) {
+      bool hasForwards = context.deviceContext->spec->forwards.empty() == false;
+      bool hasProcess = *context.statefulProcess || *context.statelessProcess;
+      if (action.op == CompletionPolicy::CompletionOp::Consume && hasProcess && (context.canForwardEarly || hasForwards == false)) {
+        LOGP(debug, "  - Dispatching to processing stream");
+        dispatchToStream(action);
+        continue;
+      }
+      context.streams->waitIdle();
+    }
 
     prepareAllocatorForCurrentTimeSlice(TimesliceSlot{action.slot});
     bool shouldConsume = action.op == CompletionPolicy::CompletionOp::Consume ||
@@ -1737,7 +1977,7 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
     markInputsAsDone(action.slot);
 
     uint64_t tStart = uv_hrtime();
-    preUpdateStats(action, record, tStart);
+    preUpdateStats(stats, action, record);
 
     static bool noCatch = getenv("O2_NO_CATCHALL_EXCEPTIONS") && strcmp(getenv("O2_NO_CATCHALL_EXCEPTIONS"), "0");
 
@@ -1752,9 +1992,11 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
         }
         if (*context.statefulProcess) {
           ZoneScopedN("statefull process");
+          TraceScope processScope{TraceCategory::Processing, "process", context.timingInfo->timeslice};
           (*context.statefulProcess)(processContext);
         } else if (*context.statelessProcess) {
           ZoneScopedN("stateless process");
+          TraceScope processScope{TraceCategory::Processing, "process", context.timingInfo->timeslice};
           (*context.statelessProcess)(processContext);
         } else {
           context.deviceContext->state->streaming = StreamingState::Idle;
@@ -1769,6 +2011,8 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
           ZoneScopedN("service post processing");
           context.registry->get<CallbackService>()(CallbackService::Id::PostProcessing, *(context.registry), (int)action.op);
           context.registry->postProcessingCallbacks(processContext);
+          // All the outputs were handed over, send them together.
+          context.registry->get<DataSender>().endOfTimeslice();
         }
       }
     };
@@ -1799,7 +2043,10 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
       context.deviceContext->state->severityStack.pop_back();
     }
 
-    postUpdateStats(action, record, tStart);
+    postUpdateStats(stats, action, record, tStart);
+    if (action.op == CompletionPolicy::CompletionOp::Consume) {
+      reportTimeslicePath(context, *context.registry, context.timingInfo->timeslice, tStart);
+    }
     // We forward inputs only when we consume them. If we simply Process them,
     // we keep them for next message arriving.
     if (action.op == CompletionPolicy::CompletionOp::Consume) {
@@ -1821,6 +2068,10 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   // We now broadcast the end of stream if it was requested
   if (context.deviceContext->state->streaming == StreamingState::EndOfStreaming) {
     LOGP(debug, "Broadcasting end of stream");
+    if (context.streams) {
+      context.streams->waitIdle();
+    }
+    context.registry->get<DataSender>().flush();
     for (auto& channel : context.deviceContext->spec->outputChannels) {
       DataProcessingHelpers::sendEndOfStream(*context.deviceContext->device, channel);
     }
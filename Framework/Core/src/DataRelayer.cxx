@@ -65,6 +65,7 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
     mCompletionPolicy{policy},
     mDistinctRoutesIndex{DataRelayerHelpers::createDistinctRouteIndex(routes)},
     mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)},
+    mInputLookup{mInputMatchers, mDistinctRoutesIndex},
     mMaxLanes{InputRouteHelpers::maxLanes(routes)}
 {
   std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
@@ -215,26 +216,6 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
   return activity;
 }
 
-/// This does the mapping between a route and a InputSpec. The
-/// reason why these might diffent is that when you have timepipelining
-/// you have one route per timeslice, even if the type is the same.
-size_t matchToContext(void const* data,
-                      std::vector<DataDescriptorMatcher> const& matchers,
-                      std::vector<size_t> const& index,
-                      VariableContext& context)
-{
-  for (size_t ri = 0, re = index.size(); ri < re; ++ri) {
-    auto& matcher = matchers[index[ri]];
-
-    if (matcher.match(reinterpret_cast<char const*>(data), context)) {
-      context.commit();
-      return ri;
-    }
-    context.discard();
-  }
-  return INVALID_INPUT;
-}
-
 /// Send the contents of a context as metrics, so that we can examine them in
 /// the GUI.
 void sendVariableContextMetrics(VariableContext& context, TimesliceSlot slot,
@@ -313,21 +294,23 @@ DataRelayer::RelayChoice
 
   // IMPLEMENTATION DETAILS
   //
-  // This returns true if a given slot is available for the current number of lanes
-  auto isSlotInLane = [currentLane = dph->startTime, maxLanes = mMaxLanes](TimesliceSlot slot) {
-    return (slot.index % maxLanes) == (currentLane % maxLanes);
-  };
+  // The slots are sharded by lane, a given slot being available only for the
+  // timeslices of its lane, i.e. slot.index % maxLanes == startTime % maxLanes.
+  // Therefore we only need to look at every maxLanes-th slot.
+  const size_t firstSlotInLane = dph->startTime % mMaxLanes;
   // This returns the identifier for the given input. We use a separate
   // function because while it's trivial now, the actual matchmaking will
   // become more complicated when we will start supporting ranges.
-  auto getInputTimeslice = [&matchers = mInputMatchers,
-                            &distinctRoutes = mDistinctRoutesIndex,
+  auto getInputTimeslice = [&lookup = mInputLookup,
                             &rawHeader,
                             &index](VariableContext& context)
     -> std::tuple<int, TimesliceId> {
     /// FIXME: for the moment we only use the first context and reset
     /// between one invokation and the other.
-    auto input = matchToContext(rawHeader, matchers, distinctRoutes, context);
+    /// Notice the lookup only considers the distinct routes: with
+    /// timepipelining there is one route per timeslice, even if the
+    /// type is the same.
+    auto input = lookup.match(reinterpret_cast<char const*>(rawHeader), context);
 
     if (input == INVALID_INPUT) {
       return {
@@ -422,11 +405,8 @@ DataRelayer::RelayChoice
   bool needsCleaning = false;
   // First look for matching slots which already have some
   // partial match.
-  for (size_t ci = 0; ci < index.size(); ++ci) {
+  for (size_t ci = firstSlotInLane; ci < index.size(); ci += mMaxLanes) {
     slot = TimesliceSlot{ci};
-    if (!isSlotInLane(slot)) {
-      continue;
-    }
     if (index.isValid(slot) == false) {
       continue;
     }
@@ -439,14 +419,11 @@ DataRelayer::RelayChoice
   // If we did not find anything, look for slots which
   // are invalid.
   if (input == INVALID_INPUT) {
-    for (size_t ci = 0; ci < index.size(); ++ci) {
+    for (size_t ci = firstSlotInLane; ci < index.size(); ci += mMaxLanes) {
       slot = TimesliceSlot{ci};
       if (index.isValid(slot) == true) {
         continue;
       }
-      if (!isSlotInLane(slot)) {
-        continue;
-      }
       std::tie(input, timeslice) = getInputTimeslice(index.getVariablesForSlot(slot));
       if (input != INVALID_INPUT) {
         needsCleaning = true;
@@ -595,17 +572,16 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   int countProcess = 0;
   int countDiscard = 0;
   int countWait = 0;
-  int notDirty = 0;
-
-  for (int li = cacheLines - 1; li >= 0; --li) {
-    TimesliceSlot slot{(size_t)li};
-    // We only check the cachelines which have been updated by an incoming
-    // message.
-    if (mTimesliceIndex.isDirty(slot) == false) {
-      notDirty++;
-      continue;
-    }
-    auto partial = getPartialRecord(li);
+
+  // We only check the cachelines which have been updated by an incoming
+  // message, as recorded by the index, rather than scanning all of them.
+  auto& dirtySlots = mDirtySlots;
+  mTimesliceIndex.collectDirtySlots(dirtySlots);
+  int notDirty = cacheLines - dirtySlots.size();
+
+  for (size_t di = 0; di < dirtySlots.size(); ++di) {
+    TimesliceSlot slot = dirtySlots[di];
+    auto partial = getPartialRecord(slot.index);
     // TODO: get the data ref from message model
     auto getter = [&partial](size_t idx, size_t part) {
       if (partial[idx].size() > 0 && partial[idx].header(part).get()) {
@@ -641,6 +617,12 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
         action = CompletionPolicy::CompletionOp::Consume;
         updateCompletionResults(slot, action);
         mTimesliceIndex.rescan();
+        // All the slots below the current one need to be checked in this pass
+        // as well, the ones above will be picked up by the next call.
+        dirtySlots.resize(di + 1);
+        for (size_t li = slot.index; li-- > 0;) {
+          dirtySlots.push_back(TimesliceSlot{li});
+        }
         break;
       case CompletionPolicy::CompletionOp::ConsumeExisting:
         countConsumeExisting++;
@@ -686,6 +668,19 @@ void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStat
   }
 }
 
+void DataRelayer::beginProcessing(TimesliceSlot slot)
+{
+  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  mTimesliceIndex.markAsInFlight(VariableContextHelpers::getTimeslice(mTimesliceIndex.getVariablesForSlot(slot)));
+}
+
+void DataRelayer::endProcessing(TimesliceId timeslice)
+{
+  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  mTimesliceIndex.markAsProcessed(timeslice);
+  mTimesliceIndex.updateOldestPossibleOutput();
+}
+
 std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice(TimesliceSlot slot)
 {
   std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
@@ -19,11 +19,17 @@
 #include "Framework/LifetimeHelpers.h"
 #include "Framework/TimesliceIndex.h"
 #include "Framework/DomainInfoHeader.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Framework/TraceRecorder.h"
+
+#include "Headers/DataHeader.h"
 
 #include <fairmq/Device.h>
 
 #include <fmt/ostream.h>
 
+#include <algorithm>
+
 using namespace o2::monitoring;
 
 namespace o2::framework
@@ -76,9 +82,83 @@ std::unique_ptr<FairMQMessage> DataSender::create(RouteIndex routeIndex)
   return mProxy.getOutputTransport(routeIndex)->CreateMessage();
 }
 
+void DataSender::initCoalescing()
+{
+  auto numChannels = mProxy.getNumOutputChannels();
+  mCoalescing.assign(numChannels, 1);
+  mPending.resize(numChannels);
+  mPendingTimeslices.assign(numChannels, 0);
+  for (size_t ci = 0; ci < numChannels; ++ci) {
+    if (mPolicy.coalescing) {
+      mCoalescing[ci] = std::max(mPolicy.coalescing(mProxy.getOutputChannel({(int)ci})->GetName()), 0);
+    }
+  }
+  // Delaying Timeframe data to a later timeslice would make it arrive
+  // after the oldest possible timeslice was moved past it.
+  for (size_t ri = 0; ri < mSpec.outputs.size(); ++ri) {
+    auto ci = mProxy.getOutputChannelIndex(RouteIndex{(int)ri}).value;
+    if (mSpec.outputs[ri].matcher.lifetime == Lifetime::Timeframe) {
+      mCoalescing[ci] = std::min(mCoalescing[ci], 1);
+    }
+  }
+}
+
 void DataSender::send(FairMQParts& parts, ChannelIndex channelIndex)
 {
-  mPolicy.send(mProxy, parts, channelIndex);
+  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  if (mCoalescing.size() != mProxy.getNumOutputChannels()) {
+    initCoalescing();
+  }
+  if (mCoalescing[channelIndex.value] == 0) {
+    doSend(parts, channelIndex);
+    return;
+  }
+  auto& pending = mPending[channelIndex.value];
+  for (auto& part : parts) {
+    pending.AddPart(std::move(part));
+  }
+  parts.fParts.clear();
+}
+
+void DataSender::endOfTimeslice()
+{
+  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  for (size_t ci = 0; ci < mPending.size(); ++ci) {
+    if (mPending[ci].Size() == 0) {
+      continue;
+    }
+    if (++mPendingTimeslices[ci] >= mCoalescing[ci]) {
+      doSend(mPending[ci], {(int)ci});
+      mPending[ci].fParts.clear();
+      mPendingTimeslices[ci] = 0;
+    }
+  }
+}
+
+void DataSender::flush()
+{
+  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  for (size_t ci = 0; ci < mPending.size(); ++ci) {
+    if (mPending[ci].Size() == 0) {
+      continue;
+    }
+    doSend(mPending[ci], {(int)ci});
+    mPending[ci].fParts.clear();
+    mPendingTimeslices[ci] = 0;
+  }
+}
+
+void DataSender::doSend(FairMQParts& parts, ChannelIndex channelIndex)
+{
+  {
+    TraceScope sendScope{TraceCategory::Sending, "send"};
+    // Walking the header stack for the timeslice is only worth it when tracing.
+    if (TraceRecorder::instance().enabled() && parts.Size()) {
+      auto dph = o2::header::get<DataProcessingHeader*>(parts.At(0)->GetData());
+      sendScope.setTimeslice(dph ? dph->startTime : -1);
+    }
+    mPolicy.send(mProxy, parts, channelIndex);
+  }
 
   /// We also always propagate the information about what is the oldest possible
   /// timeslice that can be sent from this device.
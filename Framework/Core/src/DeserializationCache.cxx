@@ -0,0 +1,96 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/DeserializationCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace o2::framework
+{
+
+namespace
+{
+inline uint64_t mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDull;
+  h ^= h >> 33;
+  return h;
+}
+} // namespace
+
+uint64_t DeserializationCache::checksum(char const* payload, size_t size)
+{
+  // Four independent lanes of 8 bytes, so that the loop is not bound by the
+  // latency of the multiplications.
+  uint64_t lanes[4] = {0x9E3779B97F4A7C15ull, 0xBF58476D1CE4E5B9ull, 0x94D049BB133111EBull, size};
+  size_t pos = 0;
+  for (; pos + 32 <= size; pos += 32) {
+    for (int li = 0; li < 4; ++li) {
+      uint64_t word;
+      memcpy(&word, payload + pos + li * 8, 8);
+      lanes[li] = (lanes[li] ^ word) * 0x9FB21C651E98DF25ull;
+      lanes[li] ^= lanes[li] >> 29;
+    }
+  }
+  uint64_t tail[4] = {0, 0, 0, 0};
+  memcpy(tail, payload + pos, size - pos);
+  uint64_t h = 0;
+  for (int li = 0; li < 4; ++li) {
+    h = mix(h ^ lanes[li] ^ mix(tail[li] + li));
+  }
+  return h;
+}
+
+void const* DeserializationCache::find(std::string const& key, uint32_t type, size_t size, uint64_t sum, size_t timeslice)
+{
+  auto entry = mEntries.find(key);
+  if (entry == mEntries.end() || entry->second.type != type || entry->second.size != size || entry->second.checksum != sum) {
+    misses++;
+    return nullptr;
+  }
+  hits++;
+  entry->second.lastUsed = ++mTick;
+  entry->second.lastTimeslice = std::max(entry->second.lastTimeslice, timeslice);
+  return entry->second.object.get();
+}
+
+void DeserializationCache::insert(std::string const& key, Entry&& entry)
+{
+  entry.lastUsed = ++mTick;
+  auto& slot = mEntries[key];
+  if (slot.object) {
+    mRetired.push_back({slot.lastTimeslice, std::move(slot.object)});
+  }
+  slot = std::move(entry);
+  while (mEntries.size() > std::max<size_t>(capacity, 1)) {
+    auto oldest = std::min_element(mEntries.begin(), mEntries.end(), [](auto const& a, auto const& b) {
+      return a.second.lastUsed < b.second.lastUsed;
+    });
+    mRetired.push_back({oldest->second.lastTimeslice, std::move(oldest->second.object)});
+    mEntries.erase(oldest);
+  }
+}
+
+void DeserializationCache::release(size_t timeslice)
+{
+  std::lock_guard<std::mutex> lock{mMutex};
+  mInUse.erase(timeslice);
+  // Whoever got a retired object is at most as recent as its last timeslice.
+  auto oldestInUse = mInUse.empty() ? std::numeric_limits<size_t>::max() : *mInUse.begin();
+  mRetired.erase(std::remove_if(mRetired.begin(), mRetired.end(), [oldestInUse](Retired const& retired) {
+                   return retired.lastTimeslice < oldestInUse;
+                 }),
+                 mRetired.end());
+}
+
+} // namespace o2::framework
@@ -0,0 +1,267 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "DevicePlacementHelpers.h"
+#include "Framework/DeviceSpec.h"
+#include "Framework/Logger.h"
+#include "Framework/RuntimeError.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#if defined(__linux__) && __has_include(<sched.h>)
+#include <sched.h>
+#endif
+#if defined(__linux__) && __has_include(<linux/mempolicy.h>)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace o2::framework
+{
+
+namespace
+{
+constexpr size_t UNASSIGNED = -1;
+
+/// How much more a Timeframe route weighs than a sporadic one.
+constexpr size_t TimeframeRouteWeight = 16;
+
+double relativeLoad(size_t load, size_t capacity)
+{
+  return capacity ? (double)load / capacity : (double)load;
+}
+
+size_t routeWeight(Lifetime lifetime, size_t maxTimeslices)
+{
+  if (lifetime != Lifetime::Timeframe) {
+    return 1;
+  }
+  return std::max<size_t>(TimeframeRouteWeight / std::max<size_t>(maxTimeslices, 1), 1);
+}
+} // namespace
+
+DevicePlacementHelpers::Weights DevicePlacementHelpers::communicationWeights(std::vector<DeviceSpec> const& devices)
+{
+  std::unordered_map<std::string, size_t> receivers;
+  for (size_t di = 0; di < devices.size(); ++di) {
+    for (auto& channel : devices[di].inputChannels) {
+      receivers[channel.name] = di;
+    }
+  }
+  Weights weights;
+  auto connect = [&receivers, &weights](size_t from, std::string const& channel, size_t weight) {
+    auto receiver = receivers.find(channel);
+    if (receiver == receivers.end() || receiver->second == from) {
+      return;
+    }
+    weights[std::minmax(from, receiver->second)] += weight;
+  };
+  for (size_t di = 0; di < devices.size(); ++di) {
+    for (auto& route : devices[di].outputs) {
+      connect(di, route.channel, routeWeight(route.matcher.lifetime, route.maxTimeslices));
+    }
+    for (auto& route : devices[di].forwards) {
+      connect(di, route.channel, routeWeight(route.matcher.lifetime, route.maxTimeslices));
+    }
+  }
+  return weights;
+}
+
+size_t DevicePlacementHelpers::cpuDemand(DeviceSpec const& device)
+{
+  std::string_view prefix = CpuDemandLabelPrefix;
+  for (auto& label : device.labels) {
+    if (label.value.rfind(prefix, 0) == 0) {
+      try {
+        return std::stoul(label.value.substr(prefix.size()));
+      } catch (...) {
+        throw runtime_error_f("Invalid label %s for device %s", label.value.c_str(), device.id.c_str());
+      }
+    }
+  }
+  return 0;
+}
+
+std::vector<size_t> DevicePlacementHelpers::partition(std::vector<size_t> const& demand,
+                                                      Weights const& weights,
+                                                      std::vector<size_t> const& capacity)
+{
+  std::vector<size_t> result(demand.size(), UNASSIGNED);
+  if (capacity.empty()) {
+    return result;
+  }
+  std::vector<std::vector<std::pair<size_t, size_t>>> neighbours(demand.size());
+  std::vector<size_t> totalWeight(demand.size(), 0);
+  for (auto& [devices, weight] : weights) {
+    neighbours[devices.first].emplace_back(devices.second, weight);
+    neighbours[devices.second].emplace_back(devices.first, weight);
+    totalWeight[devices.first] += weight;
+    totalWeight[devices.second] += weight;
+  }
+
+  std::vector<size_t> load(capacity.size(), 0);
+  for (size_t step = 0; step < demand.size(); ++step) {
+    // Grow the placed set along the heaviest connections, so that a device
+    // is placed when most of its peers already are.
+    size_t next = UNASSIGNED;
+    size_t nextConnection = 0;
+    for (size_t di = 0; di < demand.size(); ++di) {
+      if (result[di] != UNASSIGNED) {
+        continue;
+      }
+      size_t connection = 0;
+      for (auto& [peer, weight] : neighbours[di]) {
+        connection += result[peer] != UNASSIGNED ? weight : 0;
+      }
+      if (next == UNASSIGNED || connection > nextConnection ||
+          (connection == nextConnection && totalWeight[di] > totalWeight[next])) {
+        next = di;
+        nextConnection = connection;
+      }
+    }
+
+    std::vector<size_t> affinity(capacity.size(), 0);
+    for (auto& [peer, weight] : neighbours[next]) {
+      if (result[peer] != UNASSIGNED) {
+        affinity[result[peer]] += weight;
+      }
+    }
+    size_t best = UNASSIGNED;
+    for (size_t ni = 0; ni < capacity.size(); ++ni) {
+      if (load[ni] + demand[next] > capacity[ni]) {
+        continue;
+      }
+      if (best == UNASSIGNED || affinity[ni] > affinity[best] ||
+          (affinity[ni] == affinity[best] && relativeLoad(load[ni], capacity[ni]) < relativeLoad(load[best], capacity[best]))) {
+        best = ni;
+      }
+    }
+    // Oversubscribed, spread the rest evenly.
+    if (best == UNASSIGNED) {
+      best = 0;
+      for (size_t ni = 1; ni < capacity.size(); ++ni) {
+        if (relativeLoad(load[ni] + demand[next], capacity[ni]) < relativeLoad(load[best] + demand[next], capacity[best])) {
+          best = ni;
+        }
+      }
+    }
+    result[next] = best;
+    load[best] += demand[next];
+  }
+  return result;
+}
+
+std::vector<DevicePlacement> DevicePlacementHelpers::place(std::vector<DeviceSpec> const& devices,
+                                                           std::vector<NumaNodeInfo> const& nodes)
+{
+  // Without an explicit demand, a device counts as one core when
+  // balancing the nodes, but it can use all of them.
+  std::vector<size_t> explicitDemand;
+  std::vector<size_t> demand;
+  for (auto& device : devices) {
+    explicitDemand.push_back(cpuDemand(device));
+    demand.push_back(std::max<size_t>(explicitDemand.back(), 1));
+  }
+  std::vector<size_t> capacity;
+  for (auto& node : nodes) {
+    capacity.push_back(node.cpus.size());
+  }
+  auto assignment = partition(demand, communicationWeights(devices), capacity);
+
+  std::vector<DevicePlacement> placements(devices.size());
+  for (size_t ni = 0; ni < nodes.size(); ++ni) {
+    auto& cpus = nodes[ni].cpus;
+    size_t reserved = 0;
+    for (size_t di = 0; di < devices.size(); ++di) {
+      if (assignment[di] == ni) {
+        reserved += explicitDemand[di];
+      }
+    }
+    // The explicit demands are honoured only if they all fit.
+    bool split = reserved > 0 && reserved <= cpus.size();
+    size_t first = 0;
+    for (size_t di = 0; di < devices.size(); ++di) {
+      if (assignment[di] != ni || explicitDemand[di] == 0) {
+        continue;
+      }
+      placements[di].numaNode = nodes[ni].id;
+      if (split) {
+        placements[di].cpus.assign(cpus.begin() + first, cpus.begin() + first + explicitDemand[di]);
+        first += explicitDemand[di];
+      } else {
+        placements[di].cpus = cpus;
+      }
+    }
+    for (size_t di = 0; di < devices.size(); ++di) {
+      if (assignment[di] != ni || explicitDemand[di] != 0) {
+        continue;
+      }
+      placements[di].numaNode = nodes[ni].id;
+      if (split && first < cpus.size()) {
+        placements[di].cpus.assign(cpus.begin() + first, cpus.end());
+      } else {
+        placements[di].cpus = cpus;
+      }
+    }
+  }
+  return placements;
+}
+
+void DevicePlacementHelpers::report(std::vector<DeviceSpec> const& devices,
+                                    std::vector<DevicePlacement> const& placements)
+{
+  for (size_t di = 0; di < std::min(devices.size(), placements.size()); ++di) {
+    LOGP(info, "Device {} placed on NUMA node {}, cpus {}", devices[di].id, placements[di].numaNode, fmt::join(placements[di].cpus, ","));
+  }
+  size_t total = 0;
+  size_t local = 0;
+  for (auto& [pair, weight] : communicationWeights(devices)) {
+    total += weight;
+    if (placements[pair.first].numaNode == placements[pair.second].numaNode) {
+      local += weight;
+    }
+  }
+  LOGP(info, "{} out of {} of the estimated data between devices stays within a NUMA node", local, total);
+}
+
+void DevicePlacementHelpers::bind(ComputingResource const& resource)
+{
+#if defined(__linux__) && __has_include(<sched.h>)
+  if (resource.cpus.empty() == false) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : resource.cpus) {
+      CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+      LOGP(warning, "Unable to bind to cpus {}: {}", fmt::join(resource.cpus, ","), strerror(errno));
+    }
+  }
+#endif
+#if defined(__linux__) && __has_include(<linux/mempolicy.h>)
+  constexpr int bitsPerWord = sizeof(unsigned long) * 8;
+  unsigned long mask[16] = {0};
+  if (resource.numaNode >= 0 && resource.numaNode < bitsPerWord * 16) {
+    mask[resource.numaNode / bitsPerWord] = 1ul << (resource.numaNode % bitsPerWord);
+    if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, bitsPerWord * 16) != 0) {
+      LOGP(warning, "Unable to prefer the memory of NUMA node {}: {}", resource.numaNode, strerror(errno));
+    }
+  }
+#endif
+}
+
+} // namespace o2::framework
@@ -0,0 +1,80 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_DEVICEPLACEMENTHELPERS_H_
+#define O2_FRAMEWORK_DEVICEPLACEMENTHELPERS_H_
+
+#include "ComputingResourceHelpers.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace o2::framework
+{
+
+struct DeviceSpec;
+
+/// Where a device should run on the local machine.
+struct DevicePlacement {
+  int numaNode = -1;
+  std::vector<int> cpus;
+};
+
+/// Helpers to place the devices of a topology running on a single machine
+/// on its NUMA nodes, so that the devices exchanging data share the same
+/// memory and caches as much as possible.
+struct DevicePlacementHelpers {
+  /// Estimated amount of data exchanged by each pair of devices (i, j), with i < j.
+  using Weights = std::map<std::pair<size_t, size_t>, size_t>;
+
+  /// Devices labeled with this prefix followed by a number of cores, e.g.
+  /// "placement-cpus-4", get that many cores of their node for themselves.
+  static constexpr char const* CpuDemandLabelPrefix = "placement-cpus-";
+
+  /// The routes between the devices, matched by channel name. The actual
+  /// data volume is not known in advance, so each route is weighted by its
+  /// lifetime: Timeframe data, sent for every timeslice, outweighs the
+  /// sporadic one and is split among the time pipelined receivers.
+  static Weights communicationWeights(std::vector<DeviceSpec> const& devices);
+
+  /// @return the cores requested by @a device via its labels, 0 if none.
+  static size_t cpuDemand(DeviceSpec const& device);
+
+  /// Assign each device to one of the nodes, trying to keep the heavily
+  /// connected devices on the same node without exceeding its @a capacity.
+  /// A device contributes @a demand to the load of its node. When no node
+  /// has enough capacity left, the least loaded one is used.
+  /// @return the node index of each device
+  static std::vector<size_t> partition(std::vector<size_t> const& demand,
+                                       Weights const& weights,
+                                       std::vector<size_t> const& capacity);
+
+  /// Place @a devices on @a nodes. Each device is bound to all the cores of
+  /// its node, except for the devices with an explicit cpuDemand(), which get
+  /// a slice of the node for themselves when there are enough cores for all
+  /// of them. The other devices of the node then use the remaining cores.
+  static std::vector<DevicePlacement> place(std::vector<DeviceSpec> const& devices,
+                                            std::vector<NumaNodeInfo> const& nodes);
+
+  /// Log where each device goes and how much of the data stays within a node.
+  static void report(std::vector<DeviceSpec> const& devices,
+                     std::vector<DevicePlacement> const& placements);
+
+  /// Bind the calling process to the cores and prefer the memory of the node
+  /// specified in @a resource. Shared memory pages are allocated on the node
+  /// of the process touching them first, so this also places the segments
+  /// created by the device. Does nothing where not supported.
+  static void bind(ComputingResource const& resource);
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_DEVICEPLACEMENTHELPERS_H_
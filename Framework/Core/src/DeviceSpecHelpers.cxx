@@ -1308,6 +1308,11 @@ void DeviceSpecHelpers::prepareArguments(bool defaultQuiet, bool defaultStopped,
         realOdesc.add_options()("exit-transition-timeout", bpo::value<std::string>());
         realOdesc.add_options()("expected-region-callbacks", bpo::value<std::string>());
         realOdesc.add_options()("timeframes-rate-limit", bpo::value<std::string>());
+        realOdesc.add_options()("dpl-processing-threads", bpo::value<std::string>());
+        realOdesc.add_options()("dpl-output-arena-size", bpo::value<std::string>());
+        realOdesc.add_options()("dpl-trace", bpo::value<std::string>());
+        realOdesc.add_options()("dpl-critical-path", bpo::value<std::string>());
+        realOdesc.add_options()("dpl-deserialization-cache", bpo::value<std::string>());
         realOdesc.add_options()("environment", bpo::value<std::string>());
         realOdesc.add_options()("stacktrace-on-signal", bpo::value<std::string>());
         realOdesc.add_options()("post-fork-command", bpo::value<std::string>());
@@ -1468,6 +1473,11 @@ boost::program_options::options_description DeviceSpecHelpers::getForwardedDevic
     ("exit-transition-timeout", bpo::value<std::string>(), "timeout before switching to READY state")                                                                //
     ("expected-region-callbacks", bpo::value<std::string>(), "region callbacks to expect before starting")                                                           //
     ("timeframes-rate-limit", bpo::value<std::string>()->default_value("0"), "how many timeframes can be in fly")                                                    //
+    ("dpl-processing-threads", bpo::value<std::string>(), "threads processing timeslices in parallel")                                                                //
+    ("dpl-output-arena-size", bpo::value<std::string>(), "MB of shared memory to carve the outputs from, split among the processing threads")                         //
+    ("dpl-trace", bpo::value<std::string>(), "prefix of the Chrome trace files of the processing events")                                                            //
+    ("dpl-critical-path", bpo::value<std::string>(), "file where the driver writes the critical path report")                                                        //
+    ("dpl-deserialization-cache", bpo::value<std::string>(), "how many ROOT serialized inputs to keep deserialized")                                                 //
     ("shm-monitor", bpo::value<std::string>(), "whether to use the shared memory monitor")                                                                           //
     ("channel-prefix", bpo::value<std::string>()->default_value(""), "prefix to use for multiplexing multiple workflows in the same session")                        //
     ("shm-segment-size", bpo::value<std::string>(), "size of the shared memory segment in bytes")                                                                    //
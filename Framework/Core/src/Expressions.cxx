@@ -21,6 +21,12 @@
 #include <unordered_map>
 #include <set>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <cmath>
+#include <type_traits>
 
 using namespace o2::framework;
 
@@ -376,43 +382,80 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
   return gandiva::TreeExprBuilder::MakeExpression(std::move(node), std::move(result));
 }
 
+namespace
+{
+/// Time spent in gandiva compiling the filters and projectors. Only the
+/// first creation of each of them is counted: the following ones are served
+/// by the gandiva cache.
+std::atomic<uint64_t> compilationTimeUs = 0;
+/// The time of the first creation of each filter and projector, by their
+/// schema and expressions
+std::unordered_map<std::string, uint64_t> compilations;
+std::mutex compilationsMutex;
+
+template <typename F>
+auto timed(std::string const& key, F&& make)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto result = make();
+  uint64_t elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+  std::lock_guard<std::mutex> lock{compilationsMutex};
+  if (compilations.emplace(key, elapsed).second) {
+    compilationTimeUs += elapsed;
+  }
+  return result;
+}
+} // namespace
+
+uint64_t getCompilationTimeUs()
+{
+  return compilationTimeUs.load();
+}
+
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 std::move(condition),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return timed("filter " + Schema->ToString() + " " + condition->ToString(), [&Schema, &condition]() {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(Schema,
+                                   condition,
+                                   &filter);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+    }
+    return filter;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+  return createProjector(Schema, {makeExpression(createExpressionTree(opSpecs, Schema), std::move(result))});
+}
+
+std::shared_ptr<gandiva::Projector>
+  createProjector(gandiva::SchemaPtr const& Schema, gandiva::ExpressionVector const& expressions)
+{
+  auto key = "projector " + Schema->ToString();
+  for (auto& expression : expressions) {
+    key += " " + expression->ToString();
   }
-  return projector;
+  return timed(key, [&Schema, &expressions]() {
+    std::shared_ptr<gandiva::Projector> projector;
+    auto s = gandiva::Projector::Make(Schema,
+                                      expressions,
+                                      &projector);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+    }
+    return projector;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
@@ -452,10 +495,480 @@ gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, s
   return selection;
 }
 
+/// The program of a native filter: the operations in evaluation order, each
+/// storing its result in a register of a block of rows.
+struct NativeFilter {
+  enum struct Type { Bool,
+                     Int,
+                     Float,
+                     Double };
+
+  struct Operand {
+    enum struct Source { Register,
+                         Column,
+                         Literal };
+    Source source = Source::Literal;
+    /// the type of the column, literal or register
+    atype::type type = atype::NA;
+    size_t index = 0;
+    std::string column;
+    LiteralNode::var_t literal;
+  };
+
+  struct Instruction {
+    BasicOp op;
+    /// the type in which the operands are read
+    Type type;
+    size_t result;
+    Operand left;
+    Operand right;
+    bool unary = false;
+  };
+
+  std::vector<Instruction> program;
+  std::vector<Type> registers;
+  size_t root = 0;
+};
+
+namespace
+{
+/// Integers are widened to 64 bits, which is exact for all but uint64
+std::optional<NativeFilter::Type> nativeType(atype::type type)
+{
+  switch (type) {
+    case atype::BOOL:
+      return NativeFilter::Type::Bool;
+    case atype::UINT8:
+    case atype::INT8:
+    case atype::UINT16:
+    case atype::INT16:
+    case atype::UINT32:
+    case atype::INT32:
+    case atype::INT64:
+      return NativeFilter::Type::Int;
+    case atype::FLOAT:
+      return NativeFilter::Type::Float;
+    case atype::DOUBLE:
+      return NativeFilter::Type::Double;
+    default:
+      return std::nullopt;
+  }
+}
+
+/// Translate the operations into instructions of @a filter, anded with the
+/// ones it already has. @return false, leaving @a filter untouched, if some
+/// operation cannot be evaluated natively.
+bool appendOperations(NativeFilter& filter, Operations const& opSpecs)
+{
+  using Type = NativeFilter::Type;
+  using Source = NativeFilter::Operand::Source;
+  if (opSpecs.empty()) {
+    return false;
+  }
+  auto base = filter.registers.size();
+  auto registers = filter.registers;
+  registers.resize(base + opSpecs.size(), Type::Bool);
+  std::vector<NativeFilter::Instruction> program;
+
+  auto operand = [base](DatumSpec const& spec, NativeFilter::Operand& result) {
+    switch (spec.datum.index()) {
+      case 1:
+        result.source = Source::Register;
+        result.index = base + std::get<size_t>(spec.datum);
+        break;
+      case 2:
+        result.source = Source::Literal;
+        result.literal = std::get<LiteralNode::var_t>(spec.datum);
+        break;
+      case 3:
+        result.source = Source::Column;
+        result.column = std::get<std::string>(spec.datum);
+        break;
+      default:
+        return false;
+    }
+    result.type = spec.type;
+    auto type = nativeType(spec.type);
+    // boolean columns are bitmaps
+    return type.has_value() && (result.source == Source::Register || *type != Type::Bool);
+  };
+
+  for (auto it = opSpecs.rbegin(); it != opSpecs.rend(); ++it) {
+    NativeFilter::Instruction instruction{it->op, Type::Bool, base + std::get<size_t>(it->result.datum), {}, {}, it->right.datum.index() == 0};
+    if (!operand(it->left, instruction.left) || (!instruction.unary && !operand(it->right, instruction.right))) {
+      return false;
+    }
+    auto left = *nativeType(it->left.type);
+    auto right = instruction.unary ? left : *nativeType(it->right.type);
+    auto result = Type::Bool;
+    switch (it->op) {
+      case BasicOp::LogicalAnd:
+      case BasicOp::LogicalOr:
+        if (left != Type::Bool || right != Type::Bool) {
+          return false;
+        }
+        break;
+      case BasicOp::LessThan:
+      case BasicOp::LessThanOrEqual:
+      case BasicOp::GreaterThan:
+      case BasicOp::GreaterThanOrEqual:
+        // as in createExpressionTree, the operands are not converted
+        if (it->left.type != it->right.type || left == Type::Bool) {
+          return false;
+        }
+        instruction.type = left;
+        break;
+      case BasicOp::Equal:
+      case BasicOp::NotEqual:
+        // as in createExpressionTree, the operands are converted to the larger type
+        if (left == Type::Bool || right == Type::Bool) {
+          return false;
+        }
+        instruction.type = *nativeType(std::max(it->left.type, it->right.type));
+        break;
+      case BasicOp::Addition:
+      case BasicOp::Subtraction:
+      case BasicOp::Multiplication:
+      case BasicOp::Division:
+      case BasicOp::Abs: {
+        // integer arithmetic would have to wrap and divide as gandiva does
+        auto type = nativeType(it->type);
+        if (!type.has_value() || (*type != Type::Float && *type != Type::Double) || left == Type::Bool || right == Type::Bool) {
+          return false;
+        }
+        instruction.type = *type;
+        result = *type;
+        break;
+      }
+      default:
+        return false;
+    }
+    registers[instruction.result] = result;
+    program.push_back(std::move(instruction));
+  }
+  if (registers[base] != Type::Bool) {
+    return false;
+  }
+
+  auto root = base;
+  if (!filter.program.empty()) {
+    root = registers.size();
+    registers.push_back(Type::Bool);
+    NativeFilter::Instruction conjunction{BasicOp::LogicalAnd, Type::Bool, root, {}, {}, false};
+    conjunction.left.source = conjunction.right.source = Source::Register;
+    conjunction.left.type = conjunction.right.type = atype::BOOL;
+    conjunction.left.index = filter.root;
+    conjunction.right.index = base;
+    program.push_back(std::move(conjunction));
+  }
+  filter.program.insert(filter.program.end(), std::make_move_iterator(program.begin()), std::make_move_iterator(program.end()));
+  filter.registers = std::move(registers);
+  filter.root = root;
+  return true;
+}
+
+/// Evaluates a native filter on blocks of rows small enough to stay in the
+/// cache. The kernels are plain loops over contiguous arrays, which the
+/// compiler vectorizes.
+struct NativeEvaluator {
+  static constexpr int64_t BlockSize = 1024;
+
+  explicit NativeEvaluator(NativeFilter const& filter_)
+    : filter{filter_},
+      registers(filter_.registers.size(), std::vector<char>(BlockSize * sizeof(double))),
+      scratch(2, std::vector<char>(BlockSize * sizeof(double)))
+  {
+  }
+
+  template <typename T, typename S>
+  static T const* convert(S const* values, int64_t n, T* scratch)
+  {
+    if constexpr (std::is_same_v<T, S>) {
+      return values;
+    } else {
+      for (auto i = 0; i < n; ++i) {
+        scratch[i] = static_cast<T>(values[i]);
+      }
+      return scratch;
+    }
+  }
+
+  template <typename T>
+  T const* readColumn(arrow::ArrayData const& data, atype::type type, int64_t row, int64_t n, T* scratch)
+  {
+    switch (type) {
+      case atype::UINT8:
+        return convert(data.GetValues<uint8_t>(1) + row, n, scratch);
+      case atype::INT8:
+        return convert(data.GetValues<int8_t>(1) + row, n, scratch);
+      case atype::UINT16:
+        return convert(data.GetValues<uint16_t>(1) + row, n, scratch);
+      case atype::INT16:
+        return convert(data.GetValues<int16_t>(1) + row, n, scratch);
+      case atype::UINT32:
+        return convert(data.GetValues<uint32_t>(1) + row, n, scratch);
+      case atype::INT32:
+        return convert(data.GetValues<int32_t>(1) + row, n, scratch);
+      case atype::INT64:
+        return convert(data.GetValues<int64_t>(1) + row, n, scratch);
+      case atype::FLOAT:
+        return convert(data.GetValues<float>(1) + row, n, scratch);
+      case atype::DOUBLE:
+        return convert(data.GetValues<double>(1) + row, n, scratch);
+      default:
+        throw runtime_error_f("Cannot read a column of type %d natively", type);
+    }
+  }
+
+  template <typename T>
+  T const* readRegister(size_t index, int64_t n, T* scratch)
+  {
+    auto* values = registers[index].data();
+    switch (filter.registers[index]) {
+      case NativeFilter::Type::Bool:
+        return convert(reinterpret_cast<uint8_t const*>(values), n, scratch);
+      case NativeFilter::Type::Int:
+        return convert(reinterpret_cast<int64_t const*>(values), n, scratch);
+      case NativeFilter::Type::Float:
+        return convert(reinterpret_cast<float const*>(values), n, scratch);
+      case NativeFilter::Type::Double:
+        return convert(reinterpret_cast<double const*>(values), n, scratch);
+    }
+    O2_BUILTIN_UNREACHABLE();
+  }
+
+  template <typename T>
+  T const* read(NativeFilter::Operand const& operand, int64_t row, int64_t n, T* scratch)
+  {
+    switch (operand.source) {
+      case NativeFilter::Operand::Source::Register:
+        return readRegister(operand.index, n, scratch);
+      case NativeFilter::Operand::Source::Column:
+        return readColumn(*columns.at(operand.column), operand.type, row, n, scratch);
+      case NativeFilter::Operand::Source::Literal:
+        std::visit([&](auto value) { std::fill_n(scratch, n, static_cast<T>(value)); }, operand.literal);
+        return scratch;
+    }
+    O2_BUILTIN_UNREACHABLE();
+  }
+
+  template <typename T, typename R, typename F>
+  static void kernel(T const* left, T const* right, R* result, int64_t n, F&& f)
+  {
+    for (auto i = 0; i < n; ++i) {
+      result[i] = f(left[i], right[i]);
+    }
+  }
+
+  template <typename T, typename F>
+  static bool any(T const* values, int64_t n, F&& f)
+  {
+    bool result = false;
+    for (auto i = 0; i < n; ++i) {
+      result |= f(values[i]);
+    }
+    return result;
+  }
+
+  template <typename T>
+  static bool hasNaN(T const* values, int64_t n)
+  {
+    if constexpr (std::is_floating_point_v<T>) {
+      return any(values, n, [](T v) { return v != v; });
+    }
+    return false;
+  }
+
+  template <typename T>
+  void execute(NativeFilter::Instruction const& instruction, int64_t row, int64_t n)
+  {
+    auto* left = read(instruction.left, row, n, reinterpret_cast<T*>(scratch[0].data()));
+    auto* right = instruction.unary ? left : read(instruction.right, row, n, reinterpret_cast<T*>(scratch[1].data()));
+    auto* mask = reinterpret_cast<uint8_t*>(registers[instruction.result].data());
+    auto* values = reinterpret_cast<T*>(registers[instruction.result].data());
+    // gandiva fails on divisions by zero and may not follow the IEEE rules
+    // when comparing NaN, such blocks are left to it
+    switch (instruction.op) {
+      case BasicOp::LessThan:
+      case BasicOp::LessThanOrEqual:
+      case BasicOp::GreaterThan:
+      case BasicOp::GreaterThanOrEqual:
+      case BasicOp::Equal:
+      case BasicOp::NotEqual:
+        if (hasNaN(left, n) || hasNaN(right, n)) {
+          needsGandiva = true;
+          return;
+        }
+        break;
+      case BasicOp::Division:
+        if (any(right, n, [](T r) { return r == 0; })) {
+          needsGandiva = true;
+          return;
+        }
+        break;
+      default:
+        break;
+    }
+    switch (instruction.op) {
+      case BasicOp::LogicalAnd:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l && r; });
+      case BasicOp::LogicalOr:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l || r; });
+      case BasicOp::LessThan:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l < r; });
+      case BasicOp::LessThanOrEqual:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l <= r; });
+      case BasicOp::GreaterThan:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l > r; });
+      case BasicOp::GreaterThanOrEqual:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l >= r; });
+      case BasicOp::Equal:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l == r; });
+      case BasicOp::NotEqual:
+        return kernel(left, right, mask, n, [](T l, T r) -> uint8_t { return l != r; });
+      case BasicOp::Addition:
+        return kernel(left, right, values, n, [](T l, T r) -> T { return l + r; });
+      case BasicOp::Subtraction:
+        return kernel(left, right, values, n, [](T l, T r) -> T { return l - r; });
+      case BasicOp::Multiplication:
+        return kernel(left, right, values, n, [](T l, T r) -> T { return l * r; });
+      case BasicOp::Division:
+        return kernel(left, right, values, n, [](T l, T r) -> T { return l / r; });
+      case BasicOp::Abs:
+        return kernel(left, right, values, n, [](T l, T) -> T { return std::abs(l); });
+      default:
+        throw runtime_error_f("Cannot evaluate operation %d natively", instruction.op);
+    }
+  }
+
+  /// @return false if the block has to be evaluated by gandiva
+  bool evaluate(int64_t row, int64_t n)
+  {
+    for (auto& instruction : filter.program) {
+      switch (instruction.type) {
+        case NativeFilter::Type::Bool:
+          execute<uint8_t>(instruction, row, n);
+          break;
+        case NativeFilter::Type::Int:
+          execute<int64_t>(instruction, row, n);
+          break;
+        case NativeFilter::Type::Float:
+          execute<float>(instruction, row, n);
+          break;
+        case NativeFilter::Type::Double:
+          execute<double>(instruction, row, n);
+          break;
+      }
+      if (needsGandiva) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  NativeFilter const& filter;
+  std::vector<std::vector<char>> registers;
+  std::vector<std::vector<char>> scratch;
+  bool needsGandiva = false;
+  /// the columns of the batch being evaluated
+  std::unordered_map<std::string, std::shared_ptr<arrow::ArrayData>> columns;
+};
+} // namespace
+
+std::shared_ptr<NativeFilter> createNativeFilter(Operations const& opSpecs)
+{
+  auto filter = std::make_shared<NativeFilter>();
+  if (!appendOperations(*filter, opSpecs)) {
+    return nullptr;
+  }
+  return filter;
+}
+
+bool addToNativeFilter(NativeFilter& filter, Operations const& opSpecs)
+{
+  return appendOperations(filter, opSpecs);
+}
+
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, NativeFilter const& filter)
+{
+  std::set<std::string> names;
+  for (auto& instruction : filter.program) {
+    for (auto* operand : {&instruction.left, &instruction.right}) {
+      if (operand->source != NativeFilter::Operand::Source::Column) {
+        continue;
+      }
+      auto field = table->schema()->GetFieldByName(operand->column);
+      if (field == nullptr || field->type()->id() != operand->type) {
+        return nullptr;
+      }
+      names.insert(operand->column);
+    }
+  }
+
+  gandiva::Selection selection;
+  auto s = gandiva::SelectionVector::MakeInt64(table->num_rows(),
+                                               arrow::default_memory_pool(),
+                                               &selection);
+  if (!s.ok()) {
+    throw runtime_error_f("Cannot allocate selection vector %s", s.ToString().c_str());
+  }
+  if (table->num_rows() == 0) {
+    return selection;
+  }
+
+  NativeEvaluator evaluator{filter};
+  std::vector<int64_t> rows(NativeEvaluator::BlockSize);
+  int64_t selected = 0;
+  int64_t offset = 0;
+  arrow::TableBatchReader reader(*table);
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (true) {
+    s = reader.ReadNext(&batch);
+    if (!s.ok()) {
+      throw runtime_error_f("Cannot read batches from table %s", s.ToString().c_str());
+    }
+    if (batch == nullptr) {
+      break;
+    }
+    for (auto& name : names) {
+      auto data = batch->column_data(batch->schema()->GetFieldIndex(name));
+      // gandiva does not select rows with null values
+      if (data->GetNullCount() != 0) {
+        return nullptr;
+      }
+      evaluator.columns[name] = data;
+    }
+    for (int64_t row = 0; row < batch->num_rows(); row += NativeEvaluator::BlockSize) {
+      auto n = std::min(NativeEvaluator::BlockSize, batch->num_rows() - row);
+      if (!evaluator.evaluate(row, n)) {
+        return nullptr;
+      }
+      auto* mask = reinterpret_cast<uint8_t const*>(evaluator.registers[filter.root].data());
+      int64_t count = 0;
+      for (auto i = 0; i < n; ++i) {
+        rows[count] = offset + row + i;
+        count += mask[i];
+      }
+      for (auto i = 0; i < count; ++i) {
+        selection->SetIndex(selected++, rows[i]);
+      }
+    }
+    offset += batch->num_rows();
+  }
+  selection->SetNumSlots(selected);
+  return selection;
+}
+
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table,
                                    Filter const& expression)
 {
-  return createSelection(table, createFilter(table->schema(), createOperations(std::move(expression))));
+  auto ops = createOperations(expression);
+  if (auto native = createNativeFilter(ops); native != nullptr) {
+    if (auto selection = createSelection(table, *native); selection != nullptr) {
+      return selection;
+    }
+  }
+  return createSelection(table, createFilter(table->schema(), ops));
 }
 
 auto createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector)
@@ -659,8 +1172,12 @@ void updateExpressionInfos(expressions::Filter const& filter, std::vector<Expres
       /// If the tree is already set, add a new tree to it with logical 'and'
       if (info.tree != nullptr) {
         info.tree = gandiva::TreeExprBuilder::MakeAnd({info.tree, tree});
+        if (info.native != nullptr && !addToNativeFilter(*info.native, ops)) {
+          info.native = nullptr;
+        }
       } else {
         info.tree = tree;
+        info.native = createNativeFilter(ops);
       }
     }
   }
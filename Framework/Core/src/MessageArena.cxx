@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/MessageArena.h"
+#include "Framework/DataProcessingStats.h"
+#include "Framework/RuntimeError.h"
+
+#include <fairmq/FairMQTransportFactory.h>
+
+namespace o2::framework
+{
+
+MessageArena::MessageArena(FairMQTransportFactory* transport, size_t size, size_t nBlocks, DataProcessingStats* stats)
+  : mTransport{transport},
+    mUpstream{transport->GetMemoryResource()},
+    mAllocator{size / nBlocks, nBlocks},
+    mStats{stats}
+{
+  // The receiver frees the messages in bulk, the corresponding
+  // allocations are released from the FairMQ thread.
+  mRegion = mTransport->CreateUnmanagedRegion(mAllocator.size(), FairMQRegionBulkCallback{[this](std::vector<FairMQRegionBlock> const& blocks) {
+                                                for (auto& block : blocks) {
+                                                  mAllocator.release(static_cast<char*>(block.ptr) - mBase);
+                                                }
+                                              }});
+  if (mRegion.get() == nullptr) {
+    throw runtime_error_f("Unable to create a region of %zu bytes for the output arena", mAllocator.size());
+  }
+  mBase = static_cast<char*>(mRegion->GetData());
+}
+
+MessageArena::~MessageArena() = default;
+
+bool MessageArena::inRegion(void* p) const
+{
+  return static_cast<char*>(p) >= mBase && static_cast<char*>(p) < mBase + mAllocator.size();
+}
+
+FairMQMessagePtr MessageArena::createMessage(size_t size)
+{
+  auto offset = mAllocator.allocate(size);
+  if (offset == -1) {
+    if (mStats) {
+      mStats->arenaFallbacks++;
+    }
+    return mTransport->CreateMessage(size, fair::mq::Alignment{ArenaAllocator::Alignment});
+  }
+  if (mStats) {
+    mStats->arenaMessages++;
+    mStats->arenaAllocatedBytes += size;
+  }
+  return mTransport->CreateMessage(mRegion, mBase + offset, size);
+}
+
+FairMQMessagePtr MessageArena::getMessage(void* p)
+{
+  if (inRegion(p) == false) {
+    return mUpstream->getMessage(p);
+  }
+  auto it = mAllocated.find(p);
+  if (it == mAllocated.end()) {
+    return nullptr;
+  }
+  auto size = it->second;
+  mAllocated.erase(it);
+  if (mStats) {
+    mStats->arenaMessages++;
+  }
+  return mTransport->CreateMessage(mRegion, p, size);
+}
+
+void* MessageArena::setMessage(FairMQMessagePtr message)
+{
+  return mUpstream->setMessage(std::move(message));
+}
+
+void* MessageArena::do_allocate(size_t bytes, size_t alignment)
+{
+  auto offset = alignment <= ArenaAllocator::Alignment ? mAllocator.allocate(bytes) : -1;
+  if (offset == -1) {
+    if (mStats) {
+      mStats->arenaFallbacks++;
+    }
+    return mUpstream->allocate(bytes, alignment);
+  }
+  if (mStats) {
+    mStats->arenaAllocatedBytes += bytes;
+  }
+  void* p = mBase + offset;
+  mAllocated[p] = bytes;
+  return p;
+}
+
+void MessageArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+  if (inRegion(p) == false) {
+    mUpstream->deallocate(p, bytes, alignment);
+    return;
+  }
+  // Nothing to do if the memory was already handed over to a message,
+  // it will be released once the message is consumed.
+  auto it = mAllocated.find(p);
+  if (it == mAllocated.end()) {
+    return;
+  }
+  mAllocated.erase(it);
+  mAllocator.release(static_cast<char*>(p) - mBase);
+}
+
+} // namespace o2::framework
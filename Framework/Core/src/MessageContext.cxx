@@ -12,6 +12,7 @@
 #include "Framework/Output.h"
 #include "Framework/MessageContext.h"
 #include "Framework/OutputRoute.h"
+#include "Framework/TraceRecorder.h"
 #include "fairmq/FairMQDevice.h"
 
 namespace o2::framework
@@ -19,10 +20,42 @@ namespace o2::framework
 
 FairMQMessagePtr MessageContext::createMessage(RouteIndex routeIndex, int index, size_t size)
 {
+  TraceScope allocationScope{TraceCategory::Allocation, "allocate", (uint64_t)-1, size};
   auto* transport = mProxy.getOutputTransport(routeIndex);
+  if (auto* arena = getArena(transport)) {
+    return arena->createMessage(size);
+  }
   return transport->CreateMessage(size, fair::mq::Alignment{64});
 }
 
+void MessageContext::enableArena(size_t size, DataProcessingStats* stats)
+{
+  mArenaSize = size;
+  mArenaStats = stats;
+  mArenas.clear();
+}
+
+MessageArena* MessageContext::getArena(FairMQTransportFactory* transport)
+{
+  if (mArenaSize == 0 || transport->GetType() != fair::mq::Transport::SHM) {
+    return nullptr;
+  }
+  auto& arena = mArenas[transport];
+  if (arena.get() == nullptr) {
+    arena = std::make_unique<MessageArena>(transport, mArenaSize, MessageArena::DefaultBlocks, mArenaStats);
+  }
+  return arena.get();
+}
+
+pmr::FairMQMemoryResource* MessageContext::getMemoryResource(RouteIndex routeIndex)
+{
+  auto* transport = mProxy.getOutputTransport(routeIndex);
+  if (auto* arena = getArena(transport)) {
+    return arena;
+  }
+  return transport->GetMemoryResource();
+}
+
 FairMQMessagePtr MessageContext::createMessage(RouteIndex routeIndex, int index, void* data, size_t size, fairmq_free_fn* ffn, void* hint)
 {
   auto* transport = mProxy.getOutputTransport(routeIndex);
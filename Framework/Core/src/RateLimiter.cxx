@@ -16,67 +16,112 @@
 #include <fairmq/FairMQDevice.h>
 #include <fairmq/shmem/Monitor.h>
 #include <fairmq/shmem/Common.h>
+#include <thread>
 
 using namespace o2::framework;
 
+namespace
+{
+uint64_t getFreeSHM(ProcessingContext& ctx, FairMQDevice* device)
+{
+  auto& runningWorkflow = ctx.services().get<RunningWorkflowInfo const>();
+  long freeMemory = -1;
+  try {
+    freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::ShmId{fair::mq::shmem::makeShmIdStr(device->fConfig->GetProperty<uint64_t>("shmid"))}, runningWorkflow.shmSegmentId);
+  } catch (...) {
+  }
+  if (freeMemory == -1) {
+    try {
+      freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::SessionId{device->fConfig->GetProperty<std::string>("session")}, runningWorkflow.shmSegmentId);
+    } catch (...) {
+    }
+  }
+  if (freeMemory == -1) {
+    throw std::runtime_error("Could not obtain free SHM memory");
+  }
+  return freeMemory;
+}
+} // namespace
+
+bool RateLimiter::receiveFeedback(ProcessingContext& ctx, int timeout)
+{
+  auto device = ctx.services().get<RawDeviceService>().device();
+  auto msg = device->NewMessageFor("metric-feedback", 0, 0);
+  auto count = device->Receive(msg, "metric-feedback", 0, timeout);
+  if (count <= 0) {
+    return false;
+  }
+  assert(msg->GetSize() == 8);
+  auto consumed = *(int64_t*)msg->GetData();
+  auto now = std::chrono::steady_clock::now();
+  for (; mConsumedTimeframes < consumed && !mSendTimes.empty(); ++mConsumedTimeframes) {
+    mModel.observeLatency(std::chrono::duration<double>(now - mSendTimes.front()).count());
+    mSendTimes.pop_front();
+  }
+  mConsumedTimeframes = consumed;
+  return true;
+}
+
 void RateLimiter::check(ProcessingContext& ctx, int maxInFlight, size_t minSHM)
 {
   if (!maxInFlight && !minSHM) {
     return;
   }
   auto device = ctx.services().get<RawDeviceService>().device();
-  if (maxInFlight && device->fChannels.count("metric-feedback")) {
+  bool hasFeedback = device->fChannels.count("metric-feedback");
+  // Pick up whatever was consumed since the last call, so that the model
+  // is up to date even when we are not throttling.
+  while (hasFeedback && receiveFeedback(ctx, 0)) {
+  }
+  if (maxInFlight && hasFeedback) {
     int waitMessage = 0;
-    int recvTimeot = 0;
     while ((mSentTimeframes - mConsumedTimeframes) >= maxInFlight) {
-      if (recvTimeot == -1 && waitMessage == 0) {
+      if (waitMessage == 0) {
         LOG(alarm) << "Maximum number of TF in flight reached (" << maxInFlight << ": published " << mSentTimeframes << " - finished " << mConsumedTimeframes << "), waiting";
         waitMessage = 1;
       }
-      auto msg = device->NewMessageFor("metric-feedback", 0, 0);
-
-      auto count = device->Receive(msg, "metric-feedback", 0, recvTimeot);
-      if (count <= 0) {
-        recvTimeot = -1;
-        continue;
-      }
-      assert(msg->GetSize() == 8);
-      mConsumedTimeframes = *(int64_t*)msg->GetData();
+      receiveFeedback(ctx, -1);
     }
     if (waitMessage) {
       LOG(important) << (mSentTimeframes - mConsumedTimeframes) << " / " << maxInFlight << " TF in flight, continuing to publish";
     }
+    // Spread the injections over the time it takes to consume a timeframe,
+    // rather than publishing maxInFlight of them at once and then stalling.
+    if (mSentTimeframes > mConsumedTimeframes) {
+      std::this_thread::sleep_until(mLastSent + std::chrono::duration_cast<std::chrono::steady_clock::duration>(mModel.pacing(maxInFlight)));
+    }
   }
   if (minSHM) {
     int waitMessage = 0;
-    auto& runningWorkflow = ctx.services().get<RunningWorkflowInfo const>();
     while (true) {
-      long freeMemory = -1;
-      try {
-        freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::ShmId{fair::mq::shmem::makeShmIdStr(device->fConfig->GetProperty<uint64_t>("shmid"))}, runningWorkflow.shmSegmentId);
-      } catch (...) {
-      }
-      if (freeMemory == -1) {
-        try {
-          freeMemory = fair::mq::shmem::Monitor::GetFreeMemory(fair::mq::shmem::SessionId{device->fConfig->GetProperty<std::string>("session")}, runningWorkflow.shmSegmentId);
-        } catch (...) {
-        }
+      uint64_t freeSHM = getFreeSHM(ctx, device);
+      auto inFlight = mSentTimeframes - mConsumedTimeframes;
+      // Without feedback we cannot tell how many timeframes hold the memory.
+      if (hasFeedback) {
+        mModel.observeMemory(freeSHM, inFlight);
       }
-      if (freeMemory == -1) {
-        throw std::runtime_error("Could not obtain free SHM memory");
-      }
-      uint64_t freeSHM = freeMemory;
-      if (freeSHM > minSHM) {
+      if (mModel.canInject(freeSHM, minSHM, inFlight)) {
         if (waitMessage) {
-          LOG(important) << "Sufficient SHM memory free (" << freeSHM << " >= " << minSHM << "), continuing to publish";
+          LOG(important) << "Sufficient SHM memory free (" << freeSHM << " >= " << minSHM << " + " << uint64_t(mModel.footprint) << " expected for the next TF), continuing to publish";
         }
         break;
       }
       if (waitMessage == 0) {
-        LOG(alarm) << "Free SHM memory too low: " << freeSHM << " < " << minSHM << ", waiting";
+        LOG(alarm) << "Free SHM memory too low: " << freeSHM << " < " << minSHM << " + " << uint64_t(mModel.footprint) << " expected for the next TF, waiting";
         waitMessage = 1;
       }
+      // Memory is given back when a timeframe is consumed, so wait for that
+      // rather than polling the segment continuously.
+      if (hasFeedback && inFlight > 0) {
+        receiveFeedback(ctx, 10);
+      } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
     }
   }
+  mLastSent = std::chrono::steady_clock::now();
+  if (hasFeedback) {
+    mSendTimes.push_back(mLastSent);
+  }
   mSentTimeframes++;
 }
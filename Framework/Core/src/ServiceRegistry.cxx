@@ -67,10 +67,49 @@ void ServiceRegistry::registerService(hash_type typeHash, void* service, Service
 void ServiceRegistry::declareService(ServiceSpec const& spec, DeviceState& state, fair::mq::ProgOptions& options)
 {
   mSpecs.push_back(spec);
-  // Services which are not stream must have a single instance created upfront.
-  if (spec.kind != ServiceKind::Stream) {
+  // All the services have an instance created upfront, which is the one
+  // used by the main thread. Stream services get an additional instance
+  // per processing stream, see declareStreamServices.
+  ServiceHandle handle = spec.init(*this, state, options);
+  this->registerService(handle.hash, handle.instance, handle.kind, 0, handle.name.c_str());
+  this->bindService(spec, handle.instance);
+}
+
+void ServiceRegistry::declareStreamServices(ServiceRegistry const& parent, DeviceState& state, fair::mq::ProgOptions& options)
+{
+  auto isShared = [](auto const& handle) { return handle.spec.kind != ServiceKind::Stream; };
+  auto copyShared = [&isShared](auto const& from, auto& to) {
+    for (auto& handle : from) {
+      if (isShared(handle)) {
+        to.push_back(handle);
+      }
+    }
+  };
+  copyShared(parent.mPreProcessingHandles, mPreProcessingHandles);
+  copyShared(parent.mPostProcessingHandles, mPostProcessingHandles);
+  copyShared(parent.mPreDanglingHandles, mPreDanglingHandles);
+  copyShared(parent.mPostDanglingHandles, mPostDanglingHandles);
+  copyShared(parent.mPreEOSHandles, mPreEOSHandles);
+  copyShared(parent.mPostEOSHandles, mPostEOSHandles);
+  copyShared(parent.mPostDispatchingHandles, mPostDispatchingHandles);
+
+  for (auto& spec : parent.mSpecs) {
+    if (spec.kind != ServiceKind::Stream) {
+      continue;
+    }
     ServiceHandle handle = spec.init(*this, state, options);
-    this->registerService(handle.hash, handle.instance, handle.kind, 0, handle.name.c_str());
+    // Lookups are done by type only, so every entry for the given type,
+    // whatever thread registered it, must point to the new instance.
+    bool found = false;
+    for (size_t i = 0; i < mServicesKey.size(); ++i) {
+      if (mServicesKey[i].load() == handle.hash) {
+        mServicesValue[i] = handle.instance;
+        found = true;
+      }
+    }
+    if (found == false) {
+      this->registerService(handle.hash, handle.instance, handle.kind, 0, handle.name.c_str());
+    }
     this->bindService(spec, handle.instance);
   }
 }
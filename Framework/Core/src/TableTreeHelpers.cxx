@@ -15,6 +15,11 @@
 #include "arrow/type_traits.h"
 #include <arrow/util/key_value_metadata.h>
 #include <TBufferFile.h>
+#include <TROOT.h>
+#ifdef R__USE_IMT
+#include <ROOT/TSeq.hxx>
+#include <ROOT/TThreadExecutor.hxx>
+#endif
 
 #include <utility>
 namespace TableTreeHelpers
@@ -507,29 +512,42 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
       addReader(bi.ptr, bi.name, bi.mVLA);
     }
   } else {
+    std::string missing;
     for (auto& name : names) {
       auto lookup = std::find_if(branchInfos.begin(), branchInfos.end(), [&](BranchInfo const& bi) {
         return name == bi.name;
       });
       if (lookup != branchInfos.end()) {
         addReader(lookup->ptr, lookup->name, lookup->mVLA);
+      } else {
+        missing += (missing.empty() ? "" : ", ") + name;
       }
     }
-    if (names.size() != mBranchReaders.size()) {
-      LOGF(warn, "Not all requested columns were found in the tree");
+    // Expected for files of an older data model, which are read every
+    // timeframe: not worth a warning.
+    if (!missing.empty()) {
+      LOGP(debug, "Columns not found in the tree {}: {}", tree->GetName(), missing);
     }
   }
   if (mBranchReaders.empty()) {
     throw runtime_error("No columns will be read");
   }
-  //tree->SetCacheSize(50000000);
-  // FIXME: see https://github.com/root-project/root/issues/8962 and enable
-  // again once fixed.
-  //tree->SetClusterPrefetch(true);
-  //for (auto& reader : mBranchReaders) {
-  //  tree->AddBranchToCache(reader->branch());
-  //}
-  //tree->StopCacheLearningPhase();
+  if (mCacheSize > 0) {
+    // Only the columns which are actually read go in the cache, so that
+    // their baskets are fetched with a few large reads.
+    tree->SetCacheSize(mCacheSize);
+    // FIXME: see https://github.com/root-project/root/issues/8962 and enable
+    // again once fixed.
+    //tree->SetClusterPrefetch(true);
+    for (auto& reader : mBranchReaders) {
+      tree->AddBranchToCache(reader->branch());
+      auto sizeBranch = tree->GetBranch((std::string{reader->branch()->GetName()} + TableTreeHelpers::sizeBranchSuffix).c_str());
+      if (sizeBranch != nullptr) {
+        tree->AddBranchToCache(sizeBranch);
+      }
+    }
+    tree->StopCacheLearningPhase();
+  }
 }
 
 void TreeToTable::setLabel(const char* label)
@@ -537,16 +555,41 @@ void TreeToTable::setLabel(const char* label)
   mTableLabel = label;
 }
 
+void TreeToTable::setCacheSize(Long64_t size)
+{
+  mCacheSize = size;
+}
+
+void TreeToTable::setParallel(bool parallel)
+{
+  mParallel = parallel;
+}
+
 void TreeToTable::fill(TTree*)
 {
-  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
-  std::vector<std::shared_ptr<arrow::Field>> fields;
-  static TBufferFile buffer{TBuffer::EMode::kWrite, 4 * 1024 * 1024};
-  for (auto& reader : mBranchReaders) {
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> columns(mBranchReaders.size());
+  std::vector<std::shared_ptr<arrow::Field>> fields(mBranchReaders.size());
+  auto readColumn = [this, &columns, &fields](size_t ci) {
+    thread_local TBufferFile buffer{TBuffer::EMode::kWrite, 4 * 1024 * 1024};
     buffer.Reset();
-    auto arrayAndField = reader->read(&buffer);
-    columns.push_back(arrayAndField.first);
-    fields.push_back(arrayAndField.second);
+    auto arrayAndField = mBranchReaders[ci]->read(&buffer);
+    columns[ci] = arrayAndField.first;
+    fields[ci] = arrayAndField.second;
+  };
+#ifdef R__USE_IMT
+  if (mParallel && mBranchReaders.size() > 1 && ROOT::IsImplicitMTEnabled()) {
+    // Like TTree::GetEntry does with implicit multithreading: each branch
+    // is read and decompressed by a different task, with the locks of the
+    // branch processing enabled.
+    ROOT::Internal::TParBranchProcessingRAII parallelBranches;
+    ROOT::TThreadExecutor pool;
+    pool.Foreach(readColumn, ROOT::TSeqU(mBranchReaders.size()));
+  } else
+#endif
+  {
+    for (size_t ci = 0; ci < mBranchReaders.size(); ++ci) {
+      readColumn(ci);
+    }
   }
 
   auto schema = std::make_shared<arrow::Schema>(fields, std::make_shared<arrow::KeyValueMetadata>(std::vector{std::string{"label"}}, std::vector{mTableLabel}));
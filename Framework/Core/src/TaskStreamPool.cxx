@@ -0,0 +1,133 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/TaskStreamPool.h"
+#include "Framework/RuntimeError.h"
+
+namespace o2::framework
+{
+
+TaskStreamPool::TaskStreamPool(int nStreams)
+{
+  if (nStreams < 1) {
+    throw runtime_error_f("Invalid number of streams %d", nStreams);
+  }
+  for (int si = 0; si < nStreams; ++si) {
+    mStreams.emplace_back(std::make_unique<Stream>());
+  }
+  // Threads are started only once all the queues exist, as they can
+  // steal from each other.
+  for (int si = 0; si < nStreams; ++si) {
+    mStreams[si]->thread = std::thread([this, si]() { run(si); });
+  }
+}
+
+TaskStreamPool::~TaskStreamPool()
+{
+  stop();
+}
+
+void TaskStreamPool::push(Task&& task)
+{
+  rethrowError();
+  {
+    std::scoped_lock<std::mutex> lock(mMutex);
+    mQueued++;
+    mPending++;
+  }
+  auto& stream = *mStreams[mNext++ % mStreams.size()];
+  {
+    std::scoped_lock<std::mutex> lock(stream.mutex);
+    stream.tasks.emplace_back(std::move(task));
+  }
+  mWakeUp.notify_one();
+}
+
+void TaskStreamPool::waitIdle()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdle.wait(lock, [this]() { return mPending.load() == 0; });
+  }
+  rethrowError();
+}
+
+void TaskStreamPool::stop()
+{
+  {
+    std::scoped_lock<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mWakeUp.notify_all();
+  for (auto& stream : mStreams) {
+    if (stream->thread.joinable()) {
+      stream->thread.join();
+    }
+  }
+}
+
+bool TaskStreamPool::tryPop(int si, Task& task)
+{
+  // Own queue first, then steal the oldest task of the others.
+  for (size_t i = 0; i < mStreams.size(); ++i) {
+    auto& stream = *mStreams[(si + i) % mStreams.size()];
+    std::scoped_lock<std::mutex> lock(stream.mutex);
+    if (stream.tasks.empty() == false) {
+      task = std::move(stream.tasks.front());
+      stream.tasks.pop_front();
+      mQueued--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void TaskStreamPool::run(int si)
+{
+  while (true) {
+    Task task;
+    if (tryPop(si, task)) {
+      try {
+        task(TaskStreamRef{si});
+      } catch (...) {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        if (!mError) {
+          mError = std::current_exception();
+        }
+      }
+      // Release whatever the task holds before declaring it done.
+      task = nullptr;
+      if (--mPending == 0) {
+        std::scoped_lock<std::mutex> lock(mMutex);
+        mIdle.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWakeUp.wait(lock, [this]() { return mStop || mQueued.load() > 0; });
+    if (mStop && mQueued.load() == 0) {
+      return;
+    }
+  }
+}
+
+void TaskStreamPool::rethrowError()
+{
+  std::exception_ptr error;
+  {
+    std::scoped_lock<std::mutex> lock(mMutex);
+    std::swap(error, mError);
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace o2::framework
@@ -128,6 +128,23 @@ std::vector<TopoIndexInfo>
   return S;
 }
 
+namespace
+{
+/// The AOD reader reads only the columns listed as "column:<name>" in the
+/// metadata of the requested tables, so a request which does not list any
+/// asks for all of them.
+InputSpec withAllColumnsIfUnlisted(InputSpec&& input)
+{
+  auto listed = std::any_of(input.metadata.begin(), input.metadata.end(), [](ConfigParamSpec const& param) {
+    return param.name.rfind("column:", 0) == 0;
+  });
+  if (!listed) {
+    input.metadata.emplace_back(ConfigParamSpec{"column:*", VariantType::Bool, true, {"\"\""}});
+  }
+  return std::move(input);
+}
+} // namespace
+
 void WorkflowHelpers::addMissingOutputsToReader(std::vector<OutputSpec> const& providedOutputs,
                                                 std::vector<InputSpec> requestedInputs,
                                                 DataProcessorSpec& publisher)
@@ -150,6 +167,13 @@ void WorkflowHelpers::addMissingOutputsToReader(std::vector<OutputSpec> const& p
                                publisher.outputs.end(),
                                matchingOutputFor(requested));
     if (inList != publisher.outputs.end()) {
+      // Requested under a different binding, the columns are the union.
+      for (auto& param : requested.metadata) {
+        auto& metadata = inList->metadata;
+        if (param.name.rfind("column:", 0) == 0 && std::none_of(metadata.begin(), metadata.end(), [&param](auto const& m) { return m.name == param.name; })) {
+          metadata.push_back(param);
+        }
+      }
       continue;
     }
 
@@ -178,7 +202,7 @@ void WorkflowHelpers::addMissingOutputsToSpawner(std::vector<OutputSpec> const&
         if (j == publisher.inputs.end()) {
           publisher.inputs.push_back(spec);
         }
-        DataSpecUtils::updateInputList(requestedAODs, std::move(spec));
+        DataSpecUtils::updateInputList(requestedAODs, withAllColumnsIfUnlisted(std::move(spec)));
       }
     }
   }
@@ -200,7 +224,7 @@ void WorkflowHelpers::addMissingOutputsToBuilder(std::vector<InputSpec> const& r
           publisher.inputs.push_back(spec);
         }
         if (DataSpecUtils::partialMatch(spec, header::DataOrigin{"AOD"})) {
-          DataSpecUtils::updateInputList(requestedAODs, std::move(spec));
+          DataSpecUtils::updateInputList(requestedAODs, withAllColumnsIfUnlisted(std::move(spec)));
         } else if (DataSpecUtils::partialMatch(spec, header::DataOrigin{"DYN"})) {
           DataSpecUtils::updateInputList(requestedDYNs, std::move(spec));
         }
@@ -284,6 +308,9 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     {ConfigParamSpec{"aod-file", VariantType::String, {"Input AOD file"}},
      ConfigParamSpec{"aod-reader-json", VariantType::String, {"json configuration file"}},
      ConfigParamSpec{"time-limit", VariantType::Int64, 0ll, {"Maximum run time limit in seconds"}},
+     ConfigParamSpec{"aod-reader-cache-size", VariantType::Int64, 0ll, {"Size in bytes of the TTreeCache restricted to the columns read (0 disables)"}},
+     ConfigParamSpec{"aod-reader-threads", VariantType::Int, 0, {"Threads decoding the columns of a table in parallel (0 disables)"}},
+     ConfigParamSpec{"aod-reader-prefetch", VariantType::Bool, false, {"Read the next time frame while the current one is processed"}},
      ConfigParamSpec{"orbit-offset-enumeration", VariantType::Int64, 0ll, {"initial value for the orbit"}},
      ConfigParamSpec{"orbit-multiplier-enumeration", VariantType::Int64, 0ll, {"multiplier to get the orbit from the counter"}},
      ConfigParamSpec{"start-value-enumeration", VariantType::Int64, 0ll, {"initial value for the enumeration"}},
@@ -390,7 +417,7 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
           break;
       }
       if (DataSpecUtils::partialMatch(input, header::DataOrigin{"AOD"})) {
-        DataSpecUtils::updateInputList(requestedAODs, InputSpec{input});
+        DataSpecUtils::updateInputList(requestedAODs, withAllColumnsIfUnlisted(InputSpec{input}));
       }
       if (DataSpecUtils::partialMatch(input, header::DataOrigin{"DYN"})) {
         DataSpecUtils::updateInputList(requestedDYNs, InputSpec{input});
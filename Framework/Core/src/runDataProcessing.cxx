@@ -50,6 +50,7 @@
 #include "Framework/CommandInfo.h"
 #include "Framework/RunningWorkflowInfo.h"
 #include "Framework/TopologyPolicy.h"
+#include "Framework/TraceRecorder.h"
 #include "Framework/WorkflowSpecNode.h"
 #include "ControlServiceHelpers.h"
 #include "ProcessingPoliciesHelpers.h"
@@ -61,6 +62,7 @@
 #include "ComputingResourceHelpers.h"
 #include "DataProcessingStatus.h"
 #include "DDSConfigHelpers.h"
+#include "DevicePlacementHelpers.h"
 #include "O2ControlHelpers.h"
 #include "DeviceSpecHelpers.h"
 #include "GraphvizHelpers.h"
@@ -74,6 +76,7 @@
 #include <Monitoring/MonitoringFactory.h>
 #include <InfoLogger/InfoLogger.hxx>
 #include "ResourcesMonitoringHelper.h"
+#include "CriticalPathAnalyzer.h"
 
 #include "FairMQDevice.h"
 #include <fairmq/DeviceRunner.h>
@@ -761,6 +764,7 @@ void spawnDevice(DeviceRef ref,
                                  .c_str());
       putenv(formatted);
     }
+    DevicePlacementHelpers::bind(spec.resource);
     execvp(execution.args[0], execution.args.data());
   }
   close(childFds[ref.index].childstdin[0]);
@@ -1044,6 +1048,11 @@ int doChild(int argc, char** argv, ServiceRegistry& serviceRegistry,
       ("expected-region-callbacks", bpo::value<std::string>()->default_value("0"), "how many region callbacks we are expecting")                                                           //
       ("exit-transition-timeout", bpo::value<std::string>()->default_value(defaultExitTransitionTimeout), "how many second to wait before switching from RUN to READY")                    //
       ("timeframes-rate-limit", bpo::value<std::string>()->default_value("0"), "how many timeframe can be in fly at the same moment (0 disables)")                                         //
+      ("dpl-processing-threads", bpo::value<std::string>()->default_value("0"), "threads processing timeslices in parallel, needs reentrant callbacks (0 disables)")                       //
+      ("dpl-output-arena-size", bpo::value<std::string>()->default_value("0"), "MB of shared memory to carve the outputs from, split among the processing threads (0 disables)")           //
+      ("dpl-trace", bpo::value<std::string>()->default_value(""), "record the processing events and dump them in <dpl-trace>-<device>.json at the end and on SIGUSR2")                     //
+      ("dpl-critical-path", bpo::value<std::string>()->default_value(""), "report when each timeslice is processed and write the critical path analysis in the given file")                //
+      ("dpl-deserialization-cache", bpo::value<std::string>()->default_value("0"), "how many ROOT serialized inputs to keep deserialized across accesses (0 disables)")                    //
       ("configuration,cfg", bpo::value<std::string>()->default_value("command-line"), "configuration backend")                                                                             //
       ("infologger-mode", bpo::value<std::string>()->default_value(defaultInfologgerMode), "O2_INFOLOGGER_MODE override");
     r.fConfig.AddToCmdLineOptions(optsDesc, true);
@@ -1260,6 +1269,8 @@ int runStateMachine(DataProcessorSpecs const& workflow,
   // different versions of the service
   ServiceRegistry serviceRegistry;
   std::vector<ServiceMetricHandling> metricProcessingCallbacks;
+  // Where the timeslices spend their time, when dpl-critical-path is set.
+  std::unique_ptr<CriticalPathAnalyzer> criticalPath;
   std::vector<ServicePreSchedule> preScheduleCallbacks;
   std::vector<ServicePostSchedule> postScheduleCallbacks;
   std::vector<ServiceDriverInit> driverInitCallbacks;
@@ -1572,6 +1583,24 @@ int runStateMachine(DataProcessorSpecs const& workflow,
               }
             }
           }
+          if (varmap.count("dpl-critical-path") && varmap["dpl-critical-path"].as<std::string>().empty() == false) {
+            criticalPath = std::make_unique<CriticalPathAnalyzer>(CriticalPathAnalyzer::topologyFrom(runningWorkflow.devices));
+            metricProcessingCallbacks.push_back([&criticalPath](ServiceRegistry&, std::vector<DeviceMetricsInfo>& metrics, std::vector<DeviceSpec>&,
+                                                                std::vector<DeviceInfo>&, DeviceMetricsInfo&, size_t) {
+              criticalPath->update(metrics);
+            });
+          }
+          if (auto placement = varmap["placement"].as<std::string>(); placement != "none") {
+            if (placement != "numa" && placement != "dry-run") {
+              throw runtime_error_f("Unknown placement %s. Valid values are none, numa, dry-run", placement.c_str());
+            }
+            auto placements = DevicePlacementHelpers::place(runningWorkflow.devices, ComputingResourceHelpers::getLocalNumaNodes());
+            DevicePlacementHelpers::report(runningWorkflow.devices, placements);
+            for (size_t di = 0; placement == "numa" && di < runningWorkflow.devices.size(); ++di) {
+              runningWorkflow.devices[di].resource.numaNode = placements[di].numaNode;
+              runningWorkflow.devices[di].resource.cpus = placements[di].cpus;
+            }
+          }
           preScheduleCallbacks.clear();
           for (auto& device : runningWorkflow.devices) {
             for (auto& service : device.services) {
@@ -1924,6 +1953,32 @@ int runStateMachine(DataProcessorSpecs const& workflow,
         } else {
           LOGP(warning, "Could not write out final configuration file. Read only run folder?");
         }
+        // Put together the traces of the devices, if they were recorded,
+        // so that they can be inspected on a single timeline.
+        if (varmap.count("dpl-trace") && varmap["dpl-trace"].as<std::string>().empty() == false) {
+          auto prefix = varmap["dpl-trace"].as<std::string>();
+          std::vector<std::string> traces;
+          for (auto& device : runningWorkflow.devices) {
+            traces.push_back(fmt::format("{}-{}.json", prefix, device.id));
+          }
+          std::ofstream outTraceFile(prefix + ".json", std::ios::out);
+          if (outTraceFile.is_open()) {
+            TraceRecorder::mergeChromeTraces(traces, outTraceFile);
+            LOGP(info, "Merged the traces of the devices in {}.json", prefix);
+          } else {
+            LOGP(warning, "Could not write the merged trace {}.json", prefix);
+          }
+        }
+        if (criticalPath) {
+          auto filename = varmap["dpl-critical-path"].as<std::string>();
+          std::ofstream outCriticalPathFile(filename, std::ios::out);
+          if (outCriticalPathFile.is_open()) {
+            criticalPath->writeReport(outCriticalPathFile);
+            LOGP(info, "Critical path analysis written in {}", filename);
+          } else {
+            LOGP(warning, "Could not write the critical path analysis in {}", filename);
+          }
+        }
         if (driverInfo.noSHMCleanup) {
           LOGP(warning, "Not cleaning up shared memory.");
         } else {
@@ -2405,6 +2460,7 @@ int doMain(int argc, char** argv, o2::framework::WorkflowSpec const& workflow,
     ("no-cleanup", bpo::value<bool>()->zero_tokens()->default_value(false), "do not cleanup the shm segment")                                                          //                                                                                                               //
     ("hostname", bpo::value<std::string>()->default_value("localhost"), "hostname to deploy")                                                                          //                                                                                                                 //
     ("resources", bpo::value<std::string>()->default_value(""), "resources allocated for the workflow")                                                                //                                                                                                                   //
+    ("placement", bpo::value<std::string>()->default_value("none"), "bind the devices to the NUMA nodes and cores of this machine: none, numa, dry-run")               //                                                                                                                   //
     ("start-port,p", bpo::value<unsigned short>()->default_value(22000), "start port to allocate")                                                                     //                                                                                                                     //
     ("port-range,pr", bpo::value<unsigned short>()->default_value(1000), "ports in range")                                                                             //                                                                                                                       //
     ("completion-policy,c", bpo::value<TerminationPolicy>(&processingPolicies.termination)->default_value(TerminationPolicy::QUIT),                                    //                                                                                                                       //
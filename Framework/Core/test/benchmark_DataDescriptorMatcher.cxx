@@ -11,8 +11,12 @@
 #include <benchmark/benchmark.h>
 #include "Headers/DataHeader.h"
 #include "Framework/DataDescriptorMatcher.h"
+#include "Framework/DataDescriptorLookup.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Headers/Stack.h"
 
 using namespace o2::header;
+using namespace o2::framework;
 using namespace o2::framework::data_matcher;
 
 static void BM_MatchedSingleQuery(benchmark::State& state)
@@ -179,4 +183,77 @@ static void BM_OneVariableMatchUnmatch(benchmark::State& state)
 // Register the function as a benchmark
 BENCHMARK(BM_OneVariableMatchUnmatch);
 
+/// One route per subspecification, like a device receiving the data of
+/// many links, plus a wildcard one which catches the rest.
+static std::vector<DataDescriptorMatcher> createManyRoutes(size_t n)
+{
+  std::vector<DataDescriptorMatcher> matchers;
+  for (size_t i = 0; i < n; ++i) {
+    matchers.emplace_back(
+      DataDescriptorMatcher::Op::And,
+      StartTimeValueMatcher{ContextRef{0}},
+      std::make_unique<DataDescriptorMatcher>(
+        DataDescriptorMatcher::Op::And,
+        OriginValueMatcher{"TPC"},
+        std::make_unique<DataDescriptorMatcher>(
+          DataDescriptorMatcher::Op::And,
+          DescriptionValueMatcher{"RAWDATA"},
+          SubSpecificationTypeValueMatcher{(DataHeader::SubSpecificationType)i})));
+  }
+  matchers.emplace_back(
+    DataDescriptorMatcher::Op::And,
+    StartTimeValueMatcher{ContextRef{0}},
+    OriginValueMatcher{ContextRef{1}});
+  return matchers;
+}
+
+static Stack createLastRouteHeader(size_t n)
+{
+  DataHeader header;
+  header.dataOrigin = "TPC";
+  header.dataDescription = "RAWDATA";
+  header.subSpecification = n - 1;
+  DataProcessingHeader dph{0, 1};
+  return Stack{header, dph};
+}
+
+static void BM_LinearManyRoutes(benchmark::State& state)
+{
+  auto matchers = createManyRoutes(state.range(0));
+  auto stack = createLastRouteHeader(state.range(0));
+  auto data = reinterpret_cast<char const*>(stack.data());
+
+  VariableContext context;
+
+  for (auto _ : state) {
+    for (auto& matcher : matchers) {
+      if (matcher.match(data, context)) {
+        context.commit();
+        break;
+      }
+      context.discard();
+    }
+  }
+}
+BENCHMARK(BM_LinearManyRoutes)->Arg(8)->Arg(64)->Arg(512);
+
+static void BM_LookupManyRoutes(benchmark::State& state)
+{
+  auto matchers = createManyRoutes(state.range(0));
+  std::vector<size_t> index(matchers.size());
+  for (size_t i = 0; i < index.size(); ++i) {
+    index[i] = i;
+  }
+  DataDescriptorLookup lookup{matchers, index};
+  auto stack = createLastRouteHeader(state.range(0));
+  auto data = reinterpret_cast<char const*>(stack.data());
+
+  VariableContext context;
+
+  for (auto _ : state) {
+    lookup.match(data, context);
+  }
+}
+BENCHMARK(BM_LookupManyRoutes)->Arg(8)->Arg(64)->Arg(512);
+
 BENCHMARK_MAIN();
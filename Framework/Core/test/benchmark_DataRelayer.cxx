@@ -155,6 +155,55 @@ static void BM_RelayMultipleSlots(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultipleSlots);
 
+// Like the above, but with a long pipeline, so that most of the slots
+// are not touched by the incoming message and should not be checked
+// for completion.
+static void BM_RelayLongPipeline(benchmark::State& state)
+{
+  Monitoring metrics;
+  InputSpec spec{"clusters", "TPC", "CLUSTERS"};
+
+  std::vector<InputRoute> inputs = {
+    InputRoute{spec, 0, "Fake", 0}};
+
+  TimesliceIndex index{1, 1};
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(state.range(0));
+
+  DataHeader dh;
+  dh.dataDescription = "CLUSTERS";
+  dh.dataOrigin = "TPC";
+  dh.subSpecification = 0;
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t timeslice = 0;
+
+  DataProcessingHeader dph{timeslice, 1};
+  Stack placeholder{dh, dph};
+
+  std::vector<FairMQMessagePtr> inflightMessages;
+  inflightMessages.emplace_back(transport->CreateMessage(placeholder.size()));
+  inflightMessages.emplace_back(transport->CreateMessage(1000));
+  std::vector<RecordAction> ready;
+
+  for (auto _ : state) {
+    Stack stack{dh, DataProcessingHeader{timeslice++, 1}};
+    memcpy(inflightMessages[0]->GetData(), stack.data(), stack.size());
+
+    relayer.relay(inflightMessages[0]->GetData(), inflightMessages.data(), inflightMessages.size());
+    ready.clear();
+    relayer.getReadyToProcess(ready);
+    assert(ready.size() == 1);
+    assert(ready[0].op == CompletionPolicy::CompletionOp::Consume);
+    auto result = relayer.consumeAllInputsForTimeslice(ready[0].slot);
+    inflightMessages = std::move(result[0].messages);
+  }
+}
+
+BENCHMARK(BM_RelayLongPipeline)->Arg(4)->Arg(64)->Arg(1024);
+
 /// In this case we have a record with two entries
 static void BM_RelayMultipleRoutes(benchmark::State& state)
 {
@@ -67,7 +67,43 @@ static void BM_GandivaExpression(benchmark::State& state)
   benchmark::DoNotOptimize(tt);
 }
 
+static std::shared_ptr<arrow::Table> createFilterTable(size_t nrows)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
+  for (auto i = 0u; i < nrows; ++i) {
+    rowWriter(0, G(e), G(e), G(e));
+  }
+  return builder.finalize();
+}
+
+static void BM_GandivaFilter(benchmark::State& state)
+{
+  auto table = createFilterTable(state.range(0));
+  expressions::Filter f = test::x > 0.5f && nabs(test::y) < 0.8f;
+  auto gfilter = expressions::createFilter(table->schema(), expressions::createOperations(f));
+  for (auto _ : state) {
+    auto selection = expressions::createSelection(table, gfilter);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_NativeFilter(benchmark::State& state)
+{
+  auto table = createFilterTable(state.range(0));
+  expressions::Filter f = test::x > 0.5f && nabs(test::y) < 0.8f;
+  auto native = expressions::createNativeFilter(expressions::createOperations(f));
+  for (auto _ : state) {
+    auto selection = expressions::createSelection(table, *native);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 BENCHMARK(BM_DirectCalculation)->Arg(maxrows);
 BENCHMARK(BM_GandivaExpression)->Arg(maxrows);
+BENCHMARK(BM_GandivaFilter)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_NativeFilter)->Range(1 << 10, 1 << 20);
 
 BENCHMARK_MAIN();
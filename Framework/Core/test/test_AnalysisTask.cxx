@@ -184,6 +184,17 @@ BOOST_AUTO_TEST_CASE(AdaptorCompilation)
   auto task5 = adaptAnalysisTask<ETask>(*cfgc, TaskName{"test5"});
   BOOST_CHECK_EQUAL(task5.inputs.size(), 1);
   BOOST_CHECK_EQUAL(task5.inputs[0].binding, "FooBars");
+  std::vector<std::string> columns;
+  for (auto& param : task5.inputs[0].metadata) {
+    if (param.name.rfind("column:", 0) == 0) {
+      columns.push_back(param.name);
+    }
+  }
+  std::sort(columns.begin(), columns.end());
+  // Only the persistent columns are read
+  BOOST_REQUIRE_EQUAL(columns.size(), 2);
+  BOOST_CHECK_EQUAL(columns[0], "column:fBar");
+  BOOST_CHECK_EQUAL(columns[1], "column:fFoo");
 
   auto task6 = adaptAnalysisTask<FTask>(*cfgc, TaskName{"test6"});
   BOOST_CHECK_EQUAL(task6.inputs.size(), 1);
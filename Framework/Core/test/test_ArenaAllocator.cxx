@@ -0,0 +1,61 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework ArenaAllocator
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/ArenaAllocator.h"
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestArenaAllocation)
+{
+  ArenaAllocator arena{1024, 2};
+  BOOST_CHECK_EQUAL(arena.size(), 2048);
+  // Allocations are aligned and carved from the same block
+  BOOST_CHECK_EQUAL(arena.allocate(10), 0);
+  BOOST_CHECK_EQUAL(arena.allocate(64), 64);
+  BOOST_CHECK_EQUAL(arena.allocate(65), 128);
+  BOOST_CHECK_EQUAL(arena.usedBlocks(), 1);
+  // Does not fit in what is left of the first block
+  BOOST_CHECK_EQUAL(arena.allocate(1000), 1024);
+  BOOST_CHECK_EQUAL(arena.usedBlocks(), 2);
+  // Larger than a block, empty, or no space left
+  BOOST_CHECK_EQUAL(arena.allocate(2000), -1);
+  BOOST_CHECK_EQUAL(arena.allocate(0), -1);
+  BOOST_CHECK_EQUAL(arena.allocate(1000), -1);
+  // Once all the allocations of the first block are released, it can be reused
+  arena.release(0);
+  arena.release(64);
+  BOOST_CHECK_EQUAL(arena.allocate(1000), -1);
+  arena.release(128);
+  BOOST_CHECK_EQUAL(arena.usedBlocks(), 1);
+  BOOST_CHECK_EQUAL(arena.allocate(1000), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestArenaRotation)
+{
+  ArenaAllocator arena{1024, 4};
+  BOOST_CHECK_EQUAL(arena.allocate(10), 0);
+  // A new timeslice starts from a new block
+  arena.rotate();
+  BOOST_CHECK_EQUAL(arena.allocate(10), 1024);
+  arena.rotate();
+  BOOST_CHECK_EQUAL(arena.allocate(10), 2048);
+  // The first block is free again once released
+  arena.release(0);
+  arena.rotate();
+  BOOST_CHECK_EQUAL(arena.allocate(10), 3072);
+  arena.rotate();
+  BOOST_CHECK_EQUAL(arena.allocate(10), 0);
+  BOOST_CHECK_EQUAL(arena.usedBlocks(), 4);
+}
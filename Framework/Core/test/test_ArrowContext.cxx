@@ -0,0 +1,132 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework ArrowContext
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "Headers/DataHeader.h"
+#include "Framework/ArrowContext.h"
+#include "Framework/CommonServices.h"
+#include "Framework/DataAllocator.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Framework/DeviceSpec.h"
+#include "Framework/DeviceState.h"
+#include "Framework/FairMQDeviceProxy.h"
+#include "Framework/InputRecord.h"
+#include "Framework/InputSpan.h"
+#include "Framework/MessageContext.h"
+#include "Framework/ProcessingContext.h"
+#include "Framework/ServiceRegistry.h"
+#include "Framework/TableBuilder.h"
+#include "Framework/TimingInfo.h"
+#include "../src/ArrowSupport.h"
+#include <fairmq/Device.h>
+#include <fairmq/FairMQTransportFactory.h>
+#include <options/FairMQProgOptions.h>
+#include <array>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace o2::framework;
+
+namespace
+{
+/// A device with the arrow backend and the stream registries of two
+/// processing streams, created as DataProcessingDevice does.
+struct StreamsSetup {
+  StreamsSetup()
+  {
+    transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+    device.fChannels["out"].emplace_back("out", "push", transport);
+    spec.outputs = {OutputRoute{0, 1, OutputSpec{{"table"}, "TST", "TABLE"}, "out"}};
+    proxy.bind(spec.outputs, {}, device);
+    // Registered for the thread 0, so that they are found by all the threads
+    registry.registerService(TypeIdHelpers::uniqueId<FairMQDeviceProxy>(), &proxy, ServiceKind::Serial, 0);
+    registry.registerService(TypeIdHelpers::uniqueId<MessageContext>(), &messageContext, ServiceKind::Serial, 0);
+    registry.declareService(CommonServices::timingInfoSpec(), state, options);
+    registry.declareService(ArrowSupport::arrowBackendSpec(), state, options);
+    for (auto& stream : streams) {
+      stream = std::make_unique<ServiceRegistry>(registry);
+      stream->declareStreamServices(registry, state, options);
+    }
+  }
+
+  std::shared_ptr<FairMQTransportFactory> transport;
+  fair::mq::Device device;
+  DeviceSpec spec{};
+  FairMQDeviceProxy proxy;
+  MessageContext messageContext{proxy};
+  DeviceState state;
+  FairMQProgOptions options;
+  ServiceRegistry registry;
+  std::array<std::unique_ptr<ServiceRegistry>, 2> streams;
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestStreamsAdoptTables)
+{
+  StreamsSetup setup;
+  auto& registry = setup.registry;
+  auto& stream0 = *setup.streams[0];
+  auto& stream1 = *setup.streams[1];
+
+  // Each stream has its own context, the accounting is the one of the device
+  auto& context0 = stream0.get<ArrowContext>();
+  auto& context1 = stream1.get<ArrowContext>();
+  auto& deviceContext = registry.get<ArrowContext>();
+  BOOST_CHECK(&context0 != &context1);
+  BOOST_CHECK(&context0 != &deviceContext);
+  BOOST_CHECK(context0.accounting() == deviceContext.accounting());
+  BOOST_CHECK(context1.accounting() == deviceContext.accounting());
+
+  TableBuilder builder;
+  auto rowWriter = builder.persist<int>({"x"});
+  for (auto i = 0; i < 10; ++i) {
+    rowWriter(0, i);
+  }
+  auto table = builder.finalize();
+
+  // Both streams adopt tables for their own timeslice at the same time
+  constexpr size_t nTables = 1000;
+  auto adopt = [&setup, &table](ServiceRegistry& stream, size_t timeslice) {
+    stream.get<TimingInfo>().timeslice = timeslice;
+    DataAllocator allocator{&stream, setup.spec.outputs};
+    for (size_t i = 0; i < nTables; ++i) {
+      allocator.adopt(Output{"TST", "TABLE"}, table);
+    }
+  };
+  std::thread t0{adopt, std::ref(stream0), 1};
+  std::thread t1{adopt, std::ref(stream1), 2};
+  t0.join();
+  t1.join();
+
+  BOOST_CHECK_EQUAL(deviceContext.size(), 0);
+  for (auto [context, timeslice] : {std::pair{&context0, size_t{1}}, std::pair{&context1, size_t{2}}}) {
+    BOOST_REQUIRE_EQUAL(context->size(), nTables);
+    for (auto& ref : *context) {
+      auto* dph = o2::header::get<DataProcessingHeader*>(ref.header->GetData());
+      BOOST_REQUIRE(dph != nullptr);
+      BOOST_CHECK_EQUAL(dph->startTime, timeslice);
+    }
+  }
+
+  // The preprocessing of a stream clears only its own tables
+  InputSpan span{[](size_t, size_t) { return DataRef{}; }, 0};
+  InputRecord record{{}, span, stream0};
+  DataAllocator allocator{&stream0, setup.spec.outputs};
+  ProcessingContext processingContext{record, stream0, allocator};
+  stream0.preProcessingCallbacks(processingContext);
+  BOOST_CHECK_EQUAL(context0.size(), 0);
+  BOOST_CHECK_EQUAL(context1.size(), nTables);
+}
@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "../src/ComputingResourceHelpers.h"
+#include "Framework/RuntimeError.h"
 #include <string>
 #include <vector>
 
@@ -46,3 +47,16 @@ BOOST_AUTO_TEST_CASE(TestResourceParsing)
   BOOST_CHECK_EQUAL(resources[1].startPort, 22000);
   BOOST_CHECK_EQUAL(resources[1].lastPort, 23000);
 }
+
+BOOST_AUTO_TEST_CASE(TestCpuListParsing)
+{
+  BOOST_CHECK(ComputingResourceHelpers::parseCpuList("") == std::vector<int>{});
+  BOOST_CHECK(ComputingResourceHelpers::parseCpuList("3\n") == std::vector<int>{3});
+  BOOST_CHECK((ComputingResourceHelpers::parseCpuList("0-3,8,10-11\n") == std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+  BOOST_CHECK_THROW(ComputingResourceHelpers::parseCpuList("3-1"), o2::framework::RuntimeErrorRef);
+  BOOST_CHECK_THROW(ComputingResourceHelpers::parseCpuList("a"), o2::framework::RuntimeErrorRef);
+
+  auto nodes = ComputingResourceHelpers::getLocalNumaNodes();
+  BOOST_REQUIRE(nodes.empty() == false);
+  BOOST_CHECK(nodes[0].cpus.empty() == false);
+}
@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework CriticalPathAnalyzer
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "../src/CriticalPathAnalyzer.h"
+#include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsInfo.h"
+#include <boost/test/unit_test.hpp>
+#include <fmt/format.h>
+#include <sstream>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestSampleFormat)
+{
+  TimeslicePathSample sample{3, 1000, 2500};
+  auto s = CriticalPathAnalyzer::formatSample(sample);
+  BOOST_CHECK_EQUAL(s, "3:1000:2500");
+  TimeslicePathSample parsed;
+  BOOST_REQUIRE(CriticalPathAnalyzer::parseSample(s.c_str(), parsed));
+  BOOST_CHECK_EQUAL(parsed.timeslice, 3);
+  BOOST_CHECK_EQUAL(parsed.start, 1000);
+  BOOST_CHECK_EQUAL(parsed.end, 2500);
+  BOOST_CHECK(CriticalPathAnalyzer::parseSample("3:1000", parsed) == false);
+  BOOST_CHECK(CriticalPathAnalyzer::parseSample("3:1000:2500:1", parsed) == false);
+}
+
+BOOST_AUTO_TEST_CASE(TestCriticalPath)
+{
+  // reader -> fast -> sink
+  //        -> slow ->
+  CriticalPathAnalyzer analyzer{{{"reader", 1, {}},
+                                 {"fast", 1, {0}},
+                                 {"slow", 1, {0}},
+                                 {"sink", 1, {1, 2}}}};
+  for (uint64_t ts = 0; ts < 10; ++ts) {
+    uint64_t t0 = ts * 100;
+    analyzer.addSample(0, {ts, t0, t0 + 10});
+    analyzer.addSample(1, {ts, t0 + 20, t0 + 30});
+    analyzer.addSample(2, {ts, t0 + 15, t0 + 165});
+    analyzer.addSample(3, {ts, t0 + 170, t0 + 180});
+  }
+  std::ostringstream out;
+  analyzer.writeReport(out);
+  auto report = out.str();
+  BOOST_TEST_MESSAGE(report);
+  BOOST_CHECK(report.find(R"("timeslices": 10,)") != std::string::npos);
+  BOOST_CHECK(report.find(R"("periodUs": 100.0,)") != std::string::npos);
+  BOOST_CHECK(report.find(R"("averageLatencyUs": 180.0,)") != std::string::npos);
+  BOOST_CHECK(report.find(R"("criticalPath": ["reader", "slow", "sink"],)") != std::string::npos);
+  BOOST_CHECK(report.find(R"({"from": "slow", "to": "sink", "timeslices": 10, "averageQueueingUs": 5.0, "maxQueueingUs": 5, "onCriticalPath": 10})") != std::string::npos);
+  BOOST_CHECK(report.find(R"({"from": "fast", "to": "sink", "timeslices": 10, "averageQueueingUs": 140.0, "maxQueueingUs": 140, "onCriticalPath": 0})") != std::string::npos);
+  // The slow processor needs 150us per timeslice, one every 100us.
+  BOOST_CHECK(report.find(R"("suggestedPipeline": "slow:2")") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(TestSamplesFromMetrics)
+{
+  CriticalPathAnalyzer analyzer{{{"reader", 1, {}}, {"sink", 1, {0}}}};
+  std::vector<DeviceMetricsInfo> metrics(2);
+  auto addMetric = [&metrics](size_t device, TimeslicePathSample const& sample) {
+    auto metric = fmt::format("[METRIC] {},1 {} 1789372894 hostname=test.cern.ch", CriticalPathAnalyzer::MetricName, CriticalPathAnalyzer::formatSample(sample));
+    ParsedMetricMatch match;
+    BOOST_REQUIRE(DeviceMetricsHelper::parseMetric(metric, match));
+    BOOST_REQUIRE(DeviceMetricsHelper::processMetric(match, metrics[device]));
+  };
+  addMetric(0, {0, 0, 10});
+  addMetric(1, {0, 20, 50});
+  analyzer.update(metrics);
+  // Samples are picked up only once.
+  analyzer.update(metrics);
+  addMetric(0, {1, 100, 110});
+  addMetric(1, {1, 120, 150});
+  analyzer.update(metrics);
+
+  std::ostringstream out;
+  analyzer.writeReport(out);
+  auto report = out.str();
+  BOOST_CHECK(report.find(R"("timeslices": 2,)") != std::string::npos);
+  BOOST_CHECK(report.find(R"("averageLatencyUs": 50.0,)") != std::string::npos);
+  BOOST_CHECK(report.find(R"({"name": "sink", "multiplicity": 1, "suggestedMultiplicity": 1, "timeslices": 2, "averageProcessingUs": 30.0)") != std::string::npos);
+}
@@ -14,6 +14,7 @@
 #define BOOST_TEST_DYN_LINK
 
 #include "Framework/DataDescriptorMatcher.h"
+#include "Framework/DataDescriptorLookup.h"
 #include "Framework/DataDescriptorQueryBuilder.h"
 #include "Framework/InputSpec.h"
 #include "Headers/Stack.h"
@@ -420,6 +421,67 @@ BOOST_AUTO_TEST_CASE(TestStartTimeMatching)
   BOOST_CHECK_EQUAL(*vPtr, 123);
 }
 
+BOOST_AUTO_TEST_CASE(TestLookup)
+{
+  auto header = [](char const* origin, char const* description, uint32_t subSpec) {
+    DataHeader dh;
+    dh.dataOrigin.runtimeInit(origin);
+    dh.dataDescription.runtimeInit(description);
+    dh.subSpecification = subSpec;
+    DataProcessingHeader dph;
+    dph.startTime = 123;
+    return Stack{dh, dph};
+  };
+
+  std::vector<DataDescriptorMatcher> matchers;
+  matchers.emplace_back(
+    DataDescriptorMatcher::Op::Or,
+    OriginValueMatcher{"ITS"},
+    OriginValueMatcher{"TRD"});
+  matchers.emplace_back(
+    DataDescriptorMatcher::Op::And,
+    StartTimeValueMatcher{ContextRef{0}},
+    std::make_unique<DataDescriptorMatcher>(
+      DataDescriptorMatcher::Op::And,
+      OriginValueMatcher{"TPC"},
+      std::make_unique<DataDescriptorMatcher>(
+        DataDescriptorMatcher::Op::And,
+        DescriptionValueMatcher{"CLUSTERS"},
+        SubSpecificationTypeValueMatcher{ContextRef{1}})));
+  for (auto [description, subSpec] : {std::pair{"CLUSTERS", 2}, std::pair{"TRACKS", 0}}) {
+    matchers.emplace_back(
+      DataDescriptorMatcher::Op::And,
+      OriginValueMatcher{"TPC"},
+      std::make_unique<DataDescriptorMatcher>(
+        DataDescriptorMatcher::Op::And,
+        DescriptionValueMatcher{description},
+        SubSpecificationTypeValueMatcher{(uint32_t)subSpec}));
+  }
+
+  // The order of the index decides which matcher wins.
+  DataDescriptorLookup lookup{matchers, {2, 1, 3, 0}};
+  BOOST_CHECK_EQUAL(lookup.fallbacks(), 1);
+  auto match = [&lookup](Stack const& s, VariableContext& context) {
+    return lookup.match(reinterpret_cast<char const*>(s.data()), context);
+  };
+
+  VariableContext context;
+  BOOST_CHECK_EQUAL(match(header("TPC", "CLUSTERS", 2), context), 0);
+  BOOST_CHECK_EQUAL(match(header("TPC", "CLUSTERS", 5), context), 1);
+  auto startTime = std::get_if<uint64_t>(&context.get(0));
+  BOOST_REQUIRE(startTime != nullptr);
+  BOOST_CHECK_EQUAL(*startTime, 123);
+  auto subSpec = std::get_if<uint32_t>(&context.get(1));
+  BOOST_REQUIRE(subSpec != nullptr);
+  BOOST_CHECK_EQUAL(*subSpec, 5);
+
+  VariableContext context2;
+  BOOST_CHECK_EQUAL(match(header("TPC", "TRACKS", 0), context2), 2);
+  BOOST_CHECK_EQUAL(match(header("TRD", "TRACKLETS", 0), context2), 3);
+  BOOST_CHECK_EQUAL(match(header("TPC", "TRACKS", 1), context2), DataDescriptorLookup::INVALID);
+  BOOST_CHECK_EQUAL(match(header("TOF", "CLUSTERS", 2), context2), DataDescriptorLookup::INVALID);
+}
+
 /// If a query matches only partially, we do not want
 /// to pollute the context with partial results.
 BOOST_AUTO_TEST_CASE(TestAtomicUpdatesOfContext)
@@ -0,0 +1,188 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DataSender
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "Headers/DataHeader.h"
+#include "Headers/Stack.h"
+#include "MemoryResources/MemoryResources.h"
+#include "Framework/DataSender.h"
+#include "Framework/DataProcessingHeader.h"
+#include "Framework/DeviceSpec.h"
+#include "Framework/FairMQDeviceProxy.h"
+#include "Framework/Monitoring.h"
+#include "Framework/ServiceRegistry.h"
+#include "Framework/ServiceRegistryHelpers.h"
+#include "Framework/TimesliceIndex.h"
+#include <fairmq/Device.h>
+#include <fairmq/FairMQTransportFactory.h>
+#include <vector>
+
+using namespace o2::framework;
+using Monitoring = o2::monitoring::Monitoring;
+
+namespace
+{
+/// A device with the output channels used by the routes, whose sends are recorded
+/// rather than done.
+struct SenderSetup {
+  struct Sent {
+    int channel;
+    size_t parts;
+  };
+
+  SenderSetup(std::vector<OutputRoute> const& routes, SendingPolicy::CoalescingCallback coalescing)
+  {
+    transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+    for (auto& route : routes) {
+      device.fChannels[route.channel].emplace_back(route.channel, "push", transport);
+    }
+    spec.outputs = routes;
+    proxy.bind(spec.outputs, {}, device);
+    // No oldest possible timeslice to propagate after the sends.
+    (void)index.setOldestPossibleInput({(size_t)-1}, {0});
+    registry.registerService(ServiceRegistryHelpers::handleForService<FairMQDeviceProxy>(&proxy));
+    registry.registerService(ServiceRegistryHelpers::handleForService<DeviceSpec const>(&spec));
+    registry.registerService(ServiceRegistryHelpers::handleForService<TimesliceIndex>(&index));
+    registry.registerService(ServiceRegistryHelpers::handleForService<Monitoring>(&monitoring));
+    SendingPolicy policy{
+      .name = "test",
+      .send = [this](FairMQDeviceProxy&, FairMQParts& parts, ChannelIndex channelIndex) {
+        sent.push_back({channelIndex.value, (size_t)parts.Size()});
+      },
+      .coalescing = coalescing};
+    sender = std::make_unique<DataSender>(registry, policy);
+  }
+
+  /// Send a header / payload pair for @a route
+  void send(int route)
+  {
+    o2::header::DataHeader dh;
+    dh.dataOrigin = "TST";
+    dh.dataDescription = "DATA";
+    DataProcessingHeader dph{0, 1};
+    auto alloc = o2::pmr::getTransportAllocator(transport.get());
+    FairMQParts parts;
+    parts.AddPart(o2::pmr::getMessage(o2::header::Stack{alloc, dh, dph}));
+    parts.AddPart(transport->CreateMessage(10));
+    sender->send(parts, proxy.getOutputChannelIndex(RouteIndex{route}));
+  }
+
+  std::shared_ptr<FairMQTransportFactory> transport;
+  fair::mq::Device device;
+  DeviceSpec spec{};
+  FairMQDeviceProxy proxy;
+  TimesliceIndex index{1, 1};
+  Monitoring monitoring;
+  ServiceRegistry registry;
+  std::vector<Sent> sent;
+  std::unique_ptr<DataSender> sender;
+};
+
+OutputRoute makeRoute(char const* channel, o2::header::DataDescription description, Lifetime lifetime)
+{
+  return OutputRoute{0, 1, OutputSpec{{"out"}, "TST", description, 0, lifetime}, channel};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestCoalescing)
+{
+  std::vector<OutputRoute> routes{makeRoute("immediate", "A", Lifetime::Sporadic),
+                                  makeRoute("timeframe", "B", Lifetime::Timeframe),
+                                  makeRoute("sporadic", "C", Lifetime::Sporadic)};
+  SenderSetup setup{routes, [](std::string const& channel) { return channel == "immediate" ? 0 : 3; }};
+  auto& sent = setup.sent;
+
+  // Not coalesced: sent as soon as produced
+  setup.send(0);
+  BOOST_REQUIRE_EQUAL(sent.size(), 1);
+  BOOST_CHECK_EQUAL(sent[0].channel, 0);
+  BOOST_CHECK_EQUAL(sent[0].parts, 2);
+
+  // Timeframe data is capped to the current timeslice, whatever the policy
+  setup.send(1);
+  setup.send(1);
+  setup.send(2);
+  BOOST_CHECK_EQUAL(sent.size(), 1);
+  setup.sender->endOfTimeslice();
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_CHECK_EQUAL(sent[1].channel, 1);
+  BOOST_CHECK_EQUAL(sent[1].parts, 4);
+
+  // The other channels are kept for the number of timeslices of the policy
+  setup.send(2);
+  setup.sender->endOfTimeslice();
+  BOOST_CHECK_EQUAL(sent.size(), 2);
+  setup.send(2);
+  setup.sender->endOfTimeslice();
+  BOOST_REQUIRE_EQUAL(sent.size(), 3);
+  BOOST_CHECK_EQUAL(sent[2].channel, 2);
+  BOOST_CHECK_EQUAL(sent[2].parts, 6);
+
+  // Nothing is sent for an empty timeslice, flushing sends what is kept
+  setup.sender->endOfTimeslice();
+  BOOST_CHECK_EQUAL(sent.size(), 3);
+  setup.send(2);
+  setup.sender->flush();
+  BOOST_REQUIRE_EQUAL(sent.size(), 4);
+  BOOST_CHECK_EQUAL(sent[3].channel, 2);
+  BOOST_CHECK_EQUAL(sent[3].parts, 2);
+  setup.sender->flush();
+  setup.sender->endOfTimeslice();
+  BOOST_CHECK_EQUAL(sent.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestDefaultCoalescing)
+{
+  // Without a coalescing callback, all the channels send once per timeslice
+  std::vector<OutputRoute> routes{makeRoute("a", "A", Lifetime::Timeframe),
+                                  makeRoute("b", "B", Lifetime::Sporadic),
+                                  makeRoute("b", "C", Lifetime::Timeframe)};
+  SenderSetup setup{routes, nullptr};
+  auto& sent = setup.sent;
+  BOOST_CHECK_EQUAL(setup.proxy.getNumOutputChannels(), 2);
+
+  setup.send(0);
+  setup.send(1);
+  setup.send(2);
+  setup.send(0);
+  BOOST_CHECK(sent.empty());
+  setup.sender->endOfTimeslice();
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_CHECK_EQUAL(sent[0].channel, 0);
+  BOOST_CHECK_EQUAL(sent[0].parts, 4);
+  BOOST_CHECK_EQUAL(sent[1].channel, 1);
+  BOOST_CHECK_EQUAL(sent[1].parts, 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestCoalescingPerChannel)
+{
+  // A channel with a Timeframe route is capped, even if it carries
+  // other routes too, the other channels are not.
+  std::vector<OutputRoute> routes{makeRoute("mixed", "A", Lifetime::Sporadic),
+                                  makeRoute("mixed", "B", Lifetime::Timeframe),
+                                  makeRoute("sporadic", "C", Lifetime::Sporadic)};
+  SenderSetup setup{routes, [](std::string const&) { return 2; }};
+  auto& sent = setup.sent;
+
+  setup.send(0);
+  setup.send(2);
+  setup.sender->endOfTimeslice();
+  BOOST_REQUIRE_EQUAL(sent.size(), 1);
+  BOOST_CHECK_EQUAL(sent[0].channel, 0);
+  setup.send(2);
+  setup.sender->endOfTimeslice();
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_CHECK_EQUAL(sent[1].channel, 1);
+  BOOST_CHECK_EQUAL(sent[1].parts, 4);
+}
@@ -0,0 +1,122 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DeserializationCache
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/DeserializationCache.h"
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace o2::framework;
+
+namespace
+{
+struct Counted {
+  static int alive;
+  std::string value;
+  Counted(std::string v) : value{std::move(v)} { alive++; }
+  ~Counted() { alive--; }
+};
+int Counted::alive = 0;
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestChecksum)
+{
+  std::string a(1000, 'a');
+  std::string b = a;
+  BOOST_CHECK_EQUAL(DeserializationCache::checksum(a.data(), a.size()), DeserializationCache::checksum(b.data(), b.size()));
+  b[997] = 'b';
+  BOOST_CHECK_NE(DeserializationCache::checksum(a.data(), a.size()), DeserializationCache::checksum(b.data(), b.size()));
+  b = a;
+  b[3] = 'b';
+  BOOST_CHECK_NE(DeserializationCache::checksum(a.data(), a.size()), DeserializationCache::checksum(b.data(), b.size()));
+  BOOST_CHECK_NE(DeserializationCache::checksum(a.data(), 999), DeserializationCache::checksum(a.data(), 1000));
+}
+
+BOOST_AUTO_TEST_CASE(TestCache)
+{
+  DeserializationCache cache;
+  cache.capacity = 2;
+  int deserialized = 0;
+  auto get = [&cache, &deserialized](std::string const& key, std::string const& payload) {
+    return cache.get<Counted>(key, 0, payload.data(), payload.size(), [&payload, &deserialized]() {
+      deserialized++;
+      return std::make_unique<Counted>(payload);
+    });
+  };
+
+  std::string first = "first payload";
+  auto* a = get("a", first);
+  BOOST_CHECK_EQUAL(a->value, first);
+  // Same content in a different buffer, e.g. in the next timeslice.
+  std::string copy = first;
+  BOOST_CHECK_EQUAL(get("a", copy), a);
+  BOOST_CHECK_EQUAL(deserialized, 1);
+  BOOST_CHECK_EQUAL(cache.hits, 1);
+
+  // The payload changed, the old object is kept alive until released.
+  auto* changed = get("a", "second payload");
+  BOOST_CHECK_EQUAL(changed->value, "second payload");
+  BOOST_CHECK_EQUAL(deserialized, 2);
+  BOOST_CHECK_EQUAL(a->value, first);
+  BOOST_CHECK_EQUAL(Counted::alive, 2);
+  cache.release(0);
+  BOOST_CHECK_EQUAL(Counted::alive, 1);
+
+  // The least recently used input is evicted.
+  get("b", first);
+  get("a", "second payload");
+  get("c", first);
+  cache.release(0);
+  BOOST_CHECK_EQUAL(Counted::alive, 2);
+  get("a", "second payload");
+  get("b", first);
+  BOOST_CHECK_EQUAL(deserialized, 5);
+  BOOST_CHECK_EQUAL(cache.misses, 5);
+}
+
+BOOST_AUTO_TEST_CASE(TestInterleavedTimeslices)
+{
+  Counted::alive = 0;
+  DeserializationCache cache;
+  cache.capacity = 2;
+  auto get = [&cache](std::string const& key, size_t timeslice, std::string const& payload) {
+    return cache.get<Counted>(key, timeslice, payload.data(), payload.size(), [&payload]() {
+      return std::make_unique<Counted>(payload);
+    });
+  };
+
+  // Timeslice 1 gets the object, then timeslice 2 replaces it while 1 is
+  // still being processed.
+  auto* first = get("a", 1, "first");
+  auto* second = get("a", 2, "second");
+  BOOST_CHECK_EQUAL(Counted::alive, 2);
+  // The end of timeslice 2 must not destroy what timeslice 1 uses.
+  cache.release(2);
+  BOOST_CHECK_EQUAL(Counted::alive, 2);
+  BOOST_CHECK_EQUAL(first->value, "first");
+  cache.release(1);
+  BOOST_CHECK_EQUAL(Counted::alive, 1);
+  BOOST_CHECK_EQUAL(second->value, "second");
+
+  // An object shared by both timeslices is kept until both are done,
+  // whichever finishes first.
+  auto* shared = get("b", 3, "shared");
+  BOOST_CHECK_EQUAL(get("b", 4, "shared"), shared);
+  get("b", 5, "replaced");
+  cache.release(3);
+  cache.release(5);
+  BOOST_CHECK_EQUAL(shared->value, "shared");
+  BOOST_CHECK_EQUAL(Counted::alive, 3);
+  cache.release(4);
+  BOOST_CHECK_EQUAL(Counted::alive, 2);
+}
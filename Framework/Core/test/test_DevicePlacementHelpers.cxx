@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework DevicePlacementHelpers
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "../src/DevicePlacementHelpers.h"
+#include "Framework/DeviceSpec.h"
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestPartitionChains)
+{
+  // Two chains, 0 -> 2 -> 4 and 1 -> 3 -> 5, on two nodes of three cores.
+  DevicePlacementHelpers::Weights weights{{{0, 2}, 1}, {{2, 4}, 1}, {{1, 3}, 1}, {{3, 5}, 1}};
+  auto result = DevicePlacementHelpers::partition({1, 1, 1, 1, 1, 1}, weights, {3, 3});
+  BOOST_REQUIRE_EQUAL(result.size(), 6);
+  BOOST_CHECK_EQUAL(result[0], result[2]);
+  BOOST_CHECK_EQUAL(result[2], result[4]);
+  BOOST_CHECK_EQUAL(result[1], result[3]);
+  BOOST_CHECK_EQUAL(result[3], result[5]);
+  BOOST_CHECK_NE(result[0], result[1]);
+}
+
+BOOST_AUTO_TEST_CASE(TestPartitionCapacity)
+{
+  // A fully connected topology which does not fit a single node.
+  DevicePlacementHelpers::Weights weights{{{0, 1}, 4}, {{0, 2}, 1}, {{1, 2}, 1}};
+  auto result = DevicePlacementHelpers::partition({1, 1, 1}, weights, {2, 2});
+  BOOST_CHECK_EQUAL(result[0], result[1]);
+  BOOST_CHECK_NE(result[0], result[2]);
+
+  // Oversubscribed nodes get the same load.
+  result = DevicePlacementHelpers::partition({1, 1, 1, 1}, {}, {1, 1});
+  std::vector<size_t> load(2, 0);
+  for (auto node : result) {
+    load[node]++;
+  }
+  BOOST_CHECK_EQUAL(load[0], 2);
+  BOOST_CHECK_EQUAL(load[1], 2);
+}
+
+namespace
+{
+DeviceSpec makeDevice(std::string const& name, std::vector<std::string> const& outputs, std::vector<DataProcessorLabel> labels = {})
+{
+  DeviceSpec device{};
+  device.id = name;
+  device.inputChannels.push_back(InputChannelSpec{.name = name});
+  for (auto& output : outputs) {
+    device.outputs.push_back(OutputRoute{0, 1, OutputSpec{"TST", "A"}, output});
+  }
+  device.labels = labels;
+  return device;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestCommunicationWeights)
+{
+  std::vector<DeviceSpec> devices{makeDevice("a", {"b", "c"}), makeDevice("b", {}), makeDevice("c", {})};
+  devices[0].outputs.push_back(OutputRoute{0, 1, OutputSpec{"TST", "B", 0, Lifetime::Sporadic}, "c"});
+  // Time pipelined receivers get a share of the data each
+  devices[0].outputs[0].maxTimeslices = 2;
+  auto weights = DevicePlacementHelpers::communicationWeights(devices);
+  BOOST_REQUIRE_EQUAL(weights.size(), 2);
+  BOOST_CHECK_EQUAL((weights[{0, 2}]), (2 * weights[{0, 1}] + 1));
+}
+
+BOOST_AUTO_TEST_CASE(TestPlaceWholeNode)
+{
+  // Two chains on two nodes: every device can use all the cores of its node.
+  std::vector<DeviceSpec> devices{makeDevice("a0", {"b0"}), makeDevice("a1", {"b1"}),
+                                  makeDevice("b0", {}), makeDevice("b1", {})};
+  std::vector<NumaNodeInfo> nodes{{0, {0, 1, 2, 3}}, {1, {4, 5, 6, 7}}};
+  auto placements = DevicePlacementHelpers::place(devices, nodes);
+  BOOST_REQUIRE_EQUAL(placements.size(), 4);
+  BOOST_CHECK_EQUAL(placements[0].numaNode, placements[2].numaNode);
+  BOOST_CHECK_EQUAL(placements[1].numaNode, placements[3].numaNode);
+  BOOST_CHECK_NE(placements[0].numaNode, placements[1].numaNode);
+  for (auto& placement : placements) {
+    BOOST_CHECK(placement.cpus == nodes[placement.numaNode].cpus);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestPlaceExplicitDemand)
+{
+  std::string label = std::string(DevicePlacementHelpers::CpuDemandLabelPrefix) + "3";
+  std::vector<DeviceSpec> devices{makeDevice("a", {"b"}, {{label}}), makeDevice("b", {"c"}), makeDevice("c", {})};
+  BOOST_CHECK_EQUAL(DevicePlacementHelpers::cpuDemand(devices[0]), 3);
+  BOOST_CHECK_EQUAL(DevicePlacementHelpers::cpuDemand(devices[1]), 0);
+
+  // The device with a demand gets its own cores, the others share the rest.
+  std::vector<NumaNodeInfo> nodes{{0, {0, 1, 2, 3, 4, 5}}};
+  auto placements = DevicePlacementHelpers::place(devices, nodes);
+  BOOST_CHECK(placements[0].cpus == (std::vector<int>{0, 1, 2}));
+  BOOST_CHECK(placements[1].cpus == (std::vector<int>{3, 4, 5}));
+  BOOST_CHECK(placements[2].cpus == (std::vector<int>{3, 4, 5}));
+
+  // Demands which do not fit the node are not honoured.
+  nodes = {{0, {0, 1}}};
+  placements = DevicePlacementHelpers::place(devices, nodes);
+  for (auto& placement : placements) {
+    BOOST_CHECK(placement.cpus == nodes[0].cpus);
+  }
+
+  devices[1].labels.push_back({std::string(DevicePlacementHelpers::CpuDemandLabelPrefix) + "many"});
+  BOOST_CHECK_THROW(DevicePlacementHelpers::cpuDemand(devices[1]), std::exception);
+}
@@ -17,8 +17,10 @@
 #include "Framework/ExpressionHelpers.h"
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AODReaderHelpers.h"
+#include "Framework/TableBuilder.h"
 #include <boost/test/unit_test.hpp>
 #include <arrow/util/config.h>
+#include <limits>
 
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -258,3 +260,98 @@ BOOST_AUTO_TEST_CASE(TestConditionalExpressions)
   BOOST_REQUIRE_EQUAL(gandiva_tree2->ToString(),
                       "bool greater_than((float) fSigned1Pt, (const float) 0 raw(0)) && if (bool less_than(float absf((float) fEta), (const float) 1 raw(3f800000)) && if (bool less_than((float) fPt, (const float) 1 raw(3f800000))) { bool greater_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) } else { bool less_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) }) { bool greater_than(float absf((float) fX), (const float) 1 raw(3f800000)) } else { bool greater_than(float absf((float) fY), (const float) 1 raw(3f800000)) }");
 }
+
+BOOST_AUTO_TEST_CASE(TestCompilationTime)
+{
+  auto schema = std::make_shared<arrow::Schema>(std::vector{o2::aod::track::Pt::asArrowField(), o2::aod::track::Eta::asArrowField()});
+  // An expression compiled nowhere else, so that gandiva does not find it in its cache
+  Filter f = o2::aod::track::pt > 0.123f && o2::aod::track::eta < 0.456f;
+  auto before = getCompilationTimeUs();
+  auto filter = createFilter(schema, createOperations(f));
+  BOOST_CHECK(filter != nullptr);
+  BOOST_CHECK_GT(getCompilationTimeUs(), before);
+
+  // Creating it again, as the spawners do every timeframe, is not compiling it
+  before = getCompilationTimeUs();
+  filter = createFilter(schema, createOperations(f));
+  BOOST_CHECK(filter != nullptr);
+  BOOST_CHECK_EQUAL(getCompilationTimeUs(), before);
+}
+
+BOOST_AUTO_TEST_CASE(TestNativeFilters)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float>({"fPt", "fEta"});
+  for (auto i = 0; i < 3000; ++i) {
+    rowWriter(0, 0.001f * i, -1.5f + 0.001f * i);
+  }
+  auto table = builder.finalize();
+
+  auto checkSameSelection = [](std::shared_ptr<arrow::Table> const& table, Filter const& f) {
+    auto ops = createOperations(f);
+    auto native = createNativeFilter(ops);
+    BOOST_REQUIRE(native != nullptr);
+    auto s1 = createSelection(table, *native);
+    auto s2 = createSelection(table, createFilter(table->schema(), ops));
+    BOOST_REQUIRE(s1 != nullptr);
+    BOOST_REQUIRE_EQUAL(s1->GetNumSlots(), s2->GetNumSlots());
+    for (auto i = 0; i < s1->GetNumSlots(); ++i) {
+      BOOST_CHECK_EQUAL(s1->GetIndex(i), s2->GetIndex(i));
+    }
+  };
+  Filter f1 = o2::aod::track::pt > 0.5f && nabs(o2::aod::track::eta) < 0.8f;
+  Filter f2 = (o2::aod::track::pt * 2.f) - 1.f >= o2::aod::track::eta || o2::aod::track::eta == 0.f;
+  checkSameSelection(table, f1);
+  checkSameSelection(table, f2);
+
+  // Infinities compare the same way natively and in gandiva
+  constexpr auto inf = std::numeric_limits<float>::infinity();
+  constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+  TableBuilder infBuilder;
+  auto infWriter = infBuilder.persist<float, float>({"fPt", "fEta"});
+  for (auto [pt, eta] : {std::pair{inf, 0.f}, std::pair{0.7f, -inf}, std::pair{0.7f, inf}, std::pair{inf, inf}, std::pair{-inf, 0.5f}, std::pair{0.7f, 0.5f}}) {
+    infWriter(0, pt, eta);
+  }
+  auto infTable = infBuilder.finalize();
+  checkSameSelection(infTable, f1);
+  checkSameSelection(infTable, f2);
+
+  // NaN comparisons are left to gandiva
+  TableBuilder nanBuilder;
+  auto nanWriter = nanBuilder.persist<float, float>({"fPt", "fEta"});
+  for (auto [pt, eta] : {std::pair{nan, 0.f}, std::pair{0.7f, nan}, std::pair{nan, nan}, std::pair{0.7f, 0.5f}}) {
+    nanWriter(0, pt, eta);
+  }
+  auto nanTable = nanBuilder.finalize();
+  for (auto* f : {&f1, &f2}) {
+    auto ops = createOperations(*f);
+    auto native = createNativeFilter(ops);
+    BOOST_REQUIRE(native != nullptr);
+    BOOST_CHECK(createSelection(nanTable, *native) == nullptr);
+    auto s1 = createSelection(nanTable, *f);
+    auto s2 = createSelection(nanTable, createFilter(nanTable->schema(), ops));
+    BOOST_REQUIRE_EQUAL(s1->GetNumSlots(), s2->GetNumSlots());
+    for (auto i = 0; i < s1->GetNumSlots(); ++i) {
+      BOOST_CHECK_EQUAL(s1->GetIndex(i), s2->GetIndex(i));
+    }
+  }
+
+  // So are divisions by zero, for which gandiva reports an error
+  Filter f3 = o2::aod::track::pt / o2::aod::track::eta > 1.f;
+  auto divOps = createOperations(f3);
+  auto divNative = createNativeFilter(divOps);
+  BOOST_REQUIRE(divNative != nullptr);
+  BOOST_CHECK(createSelection(infTable, *divNative) == nullptr);
+  BOOST_CHECK_THROW(createSelection(infTable, f3), o2::framework::RuntimeErrorRef);
+  BOOST_CHECK_THROW(createSelection(infTable, createFilter(infTable->schema(), divOps)), o2::framework::RuntimeErrorRef);
+
+  // Filters with conditionals need gandiva
+  Filter cf = ifnode(o2::aod::track::pt < 1.0f, o2::aod::track::eta > 0.f, o2::aod::track::eta < 0.f);
+  BOOST_CHECK(createNativeFilter(createOperations(cf)) == nullptr);
+
+  // So do tables lacking the columns
+  Filter yf = o2::aod::track::y > 1.0f;
+  auto native = createNativeFilter(createOperations(yf));
+  BOOST_REQUIRE(native != nullptr);
+  BOOST_CHECK(createSelection(table, *native) == nullptr);
+}
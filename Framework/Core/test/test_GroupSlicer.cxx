@@ -416,6 +416,78 @@ BOOST_AUTO_TEST_CASE(GroupSlicerMismatchedUnsortedFilteredGroups)
   }
 }
 
+BOOST_AUTO_TEST_CASE(GroupSlicerSharedSlices)
+{
+  TableBuilder builderE;
+  auto evtsWriter = builderE.cursor<aod::Events>();
+  for (auto i = 0; i < 20; ++i) {
+    evtsWriter(0, i, 0.5f * i, 2.f * i, 3.f * i);
+  }
+  auto evtTable = builderE.finalize();
+
+  TableBuilder builderT;
+  auto trksWriter = builderT.cursor<aod::TrksX>();
+  for (auto i = 0; i < 20; ++i) {
+    for (auto j = 0; j < i % 3; ++j) {
+      trksWriter(0, i, 0.5f * j);
+    }
+  }
+  auto trkTable = builderT.finalize();
+
+  aod::Events e{evtTable};
+  ArrowTableSlicingCache cache;
+  for (auto pass = 0; pass < 2; ++pass) {
+    // A different table object on the same data, as for each process function
+    aod::TrksX t{arrow::Table::Make(trkTable->schema(), trkTable->columns())};
+    auto tt = std::make_tuple(t);
+    o2::framework::GroupSlicer g(e, tt, &cache);
+    unsigned int count = 0;
+    for (auto& slice : g) {
+      auto trks = std::get<aod::TrksX>(slice.associatedTables());
+      BOOST_CHECK_EQUAL(trks.size(), count % 3);
+      for (auto& trk : trks) {
+        BOOST_CHECK_EQUAL(trk.eventId(), count);
+      }
+      ++count;
+    }
+  }
+  BOOST_CHECK_EQUAL(cache.misses, 1);
+  BOOST_CHECK_EQUAL(cache.hits, 1);
+
+  // The same values under another index name are split again
+  auto renamed = arrow::Table::Make(arrow::schema({arrow::field("fIndexOthers", arrow::int32())}), {trkTable->GetColumnByName("fIndexEvents")});
+  cache.getCacheFor("fIndexOthers", "Others", renamed, 20);
+  BOOST_CHECK_EQUAL(cache.misses, 2);
+  renamed.reset();
+
+  // The index values are kept until the cache is reset, so that their
+  // memory is not reused by another table of the same timeframe
+  std::weak_ptr<arrow::Buffer> values = trkTable->GetColumnByName("fIndexEvents")->chunk(0)->data()->buffers[1];
+  trkTable.reset();
+  BOOST_CHECK(!values.expired());
+  cache.reset();
+  BOOST_CHECK(values.expired());
+}
+
+BOOST_AUTO_TEST_CASE(UnsortedSlices)
+{
+  TableBuilder builderT;
+  auto trksWriter = builderT.cursor<aod::TrksXU>();
+  std::vector<int> events{3, 1, -1, 3, 0, 1, 3};
+  for (auto event : events) {
+    trksWriter(0, event, 0.f);
+  }
+  auto trkTable = builderT.finalize();
+
+  auto info = ArrowTableSlicingCache::computeSlices("fIndexEvents", "TrksXU", trkTable, 5);
+  BOOST_CHECK(info->sorted == false);
+  BOOST_CHECK(info->getRowsFor(0) == (std::vector<int64_t>{4}));
+  BOOST_CHECK(info->getRowsFor(1) == (std::vector<int64_t>{1, 5}));
+  BOOST_CHECK(info->getRowsFor(2).empty());
+  BOOST_CHECK(info->getRowsFor(3) == (std::vector<int64_t>{0, 3, 6}));
+  BOOST_CHECK(info->getRowsFor(4).empty());
+}
+
 BOOST_AUTO_TEST_CASE(EmptySliceables)
 {
   TableBuilder builderE;
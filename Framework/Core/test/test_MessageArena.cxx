@@ -0,0 +1,142 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework MessageArena
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/MessageArena.h"
+#include "Framework/DataProcessingStats.h"
+#include <fairmq/FairMQTransportFactory.h>
+#include <boost/test/unit_test.hpp>
+#include <chrono>
+#include <thread>
+
+using namespace o2::framework;
+
+namespace
+{
+bool inArena(char const* base, size_t size, FairMQMessagePtr const& message)
+{
+  auto* p = static_cast<char const*>(message->GetData());
+  return p >= base && p < base + size;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestSizePerContext)
+{
+  constexpr size_t granularity = MessageArena::DefaultBlocks * ArenaAllocator::Alignment;
+  // The device and its processing streams share the configured size.
+  BOOST_CHECK_EQUAL(MessageArena::sizePerContext(64 * 1024 * 1024, 1), 64 * 1024 * 1024);
+  BOOST_CHECK_EQUAL(MessageArena::sizePerContext(64 * 1024 * 1024, 4), 16 * 1024 * 1024);
+  for (size_t n = 1; n < 10; ++n) {
+    auto size = MessageArena::sizePerContext(100 * 1024 * 1024, n);
+    BOOST_CHECK(size * n <= 100 * 1024 * 1024);
+    BOOST_CHECK_EQUAL(size % granularity, 0);
+  }
+  BOOST_CHECK_EQUAL(MessageArena::sizePerContext(granularity - 1, 1), 0);
+  BOOST_CHECK_EQUAL(MessageArena::sizePerContext(1024, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestArenaMessages)
+{
+  auto transport = FairMQTransportFactory::CreateTransportFactory("shmem");
+  BOOST_REQUIRE(transport != nullptr);
+  DataProcessingStats stats;
+  constexpr size_t size = 16 * 4096;
+  MessageArena arena{transport.get(), size, 16, &stats};
+
+  auto first = arena.createMessage(100);
+  BOOST_REQUIRE(first != nullptr);
+  BOOST_CHECK_EQUAL(first->GetSize(), 100);
+  auto* base = static_cast<char*>(first->GetData());
+  auto second = arena.createMessage(100);
+  // Carved one after the other from the same block
+  BOOST_CHECK_EQUAL(static_cast<char*>(second->GetData()) - base, ArenaAllocator::Alignment);
+  BOOST_CHECK_EQUAL(stats.arenaMessages.load(), 2);
+  BOOST_CHECK_EQUAL(stats.arenaAllocatedBytes.load(), 200);
+
+  // Larger than a block, allocated from the transport as usual
+  auto large = arena.createMessage(2 * size);
+  BOOST_REQUIRE(large != nullptr);
+  BOOST_CHECK_EQUAL(large->GetSize(), 2 * size);
+  BOOST_CHECK(inArena(base, size, large) == false);
+  BOOST_CHECK_EQUAL(stats.arenaFallbacks.load(), 1);
+
+  // A new timeslice starts from a new block
+  arena.rotate();
+  auto third = arena.createMessage(10);
+  BOOST_CHECK_EQUAL(static_cast<char*>(third->GetData()) - base, 4096);
+}
+
+BOOST_AUTO_TEST_CASE(TestArenaMemoryResource)
+{
+  auto transport = FairMQTransportFactory::CreateTransportFactory("shmem");
+  BOOST_REQUIRE(transport != nullptr);
+  constexpr size_t size = 16 * 4096;
+  MessageArena arena{transport.get(), size, 16, nullptr};
+
+  // Memory allocated via the resource is adopted by a message
+  // without copying it.
+  void* p = arena.allocate(256, 64);
+  BOOST_CHECK_EQUAL(arena.getNumberOfMessages(), 1);
+  auto message = arena.getMessage(p);
+  BOOST_REQUIRE(message != nullptr);
+  BOOST_CHECK_EQUAL(message->GetData(), p);
+  BOOST_CHECK_EQUAL(message->GetSize(), 256);
+  BOOST_CHECK_EQUAL(arena.getNumberOfMessages(), 0);
+  // Once adopted, the deallocation is up to the message.
+  arena.deallocate(p, 256, 64);
+
+  // Memory which is never sent is released right away, so the block
+  // can be reused.
+  void* q = arena.allocate(4096, 64);
+  BOOST_CHECK(q != nullptr);
+  arena.deallocate(q, 4096, 64);
+  BOOST_CHECK_EQUAL(arena.getNumberOfMessages(), 0);
+
+  // Alignments the arena does not provide go to the transport.
+  void* r = arena.allocate(256, 4096);
+  BOOST_REQUIRE(r != nullptr);
+  BOOST_CHECK_EQUAL(arena.getNumberOfMessages(), 0);
+  arena.deallocate(r, 256, 4096);
+}
+
+BOOST_AUTO_TEST_CASE(TestArenaRelease)
+{
+  auto transport = FairMQTransportFactory::CreateTransportFactory("shmem");
+  BOOST_REQUIRE(transport != nullptr);
+  DataProcessingStats stats;
+  MessageArena arena{transport.get(), 2 * 4096, 2, &stats};
+
+  // Fill both blocks
+  auto first = arena.createMessage(4096);
+  arena.rotate();
+  auto second = arena.createMessage(4096);
+  arena.rotate();
+  BOOST_CHECK_EQUAL(stats.arenaFallbacks.load(), 0);
+  auto full = arena.createMessage(4096);
+  BOOST_CHECK_EQUAL(stats.arenaFallbacks.load(), 1);
+  auto* base = static_cast<char*>(first->GetData());
+
+  // Once the messages of a block are destroyed, the region callback
+  // gives the block back to the arena.
+  first.reset();
+  FairMQMessagePtr reused;
+  for (int i = 0; i < 100; ++i) {
+    auto message = arena.createMessage(4096);
+    if (static_cast<char*>(message->GetData()) == base) {
+      reused = std::move(message);
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_CHECK(reused != nullptr);
+}
@@ -0,0 +1,55 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework RateLimiter
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/RateLimiter.h"
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestFootprintLearning)
+{
+  RateLimiterModel model;
+  model.observeMemory(1000, 0);
+  BOOST_CHECK_EQUAL(model.baseline, 1000);
+  BOOST_CHECK_EQUAL(model.footprint, 0);
+  // Nothing learned yet, only the threshold matters
+  BOOST_CHECK(model.canInject(501, 500, 2));
+  BOOST_CHECK(!model.canInject(500, 500, 2));
+
+  model.observeMemory(800, 2);
+  BOOST_CHECK_CLOSE(model.footprint, 100, 1e-6);
+  model.observeMemory(600, 2);
+  BOOST_CHECK_CLOSE(model.footprint, 100 + RateLimiterModel::Smoothing * 100, 1e-6);
+  // The next timeframe would go below the threshold
+  BOOST_CHECK(!model.canInject(600, 500, 2));
+  BOOST_CHECK(model.canInject(700, 500, 2));
+  // With nothing in flight there is nothing to wait for
+  BOOST_CHECK(model.canInject(600, 500, 0));
+
+  // More free memory than we thought we had
+  model.observeMemory(1200, 1);
+  BOOST_CHECK_EQUAL(model.baseline, 1200);
+}
+
+BOOST_AUTO_TEST_CASE(TestPacing)
+{
+  RateLimiterModel model;
+  BOOST_CHECK_EQUAL(model.pacing(4).count(), 0);
+  model.observeLatency(2.);
+  BOOST_CHECK_CLOSE(model.latency, 2., 1e-6);
+  model.observeLatency(1.);
+  BOOST_CHECK_CLOSE(model.latency, 2. - RateLimiterModel::Smoothing, 1e-6);
+  BOOST_CHECK_CLOSE(model.pacing(4).count(), model.latency / 4, 1e-6);
+  BOOST_CHECK_EQUAL(model.pacing(0).count(), 0);
+}
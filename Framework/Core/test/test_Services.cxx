@@ -16,6 +16,7 @@
 #include "Framework/ServiceRegistry.h"
 #include "Framework/CallbackService.h"
 #include "Framework/CommonServices.h"
+#include "Framework/TimingInfo.h"
 #include <Framework/DeviceState.h>
 #include <boost/test/unit_test.hpp>
 #include <options/FairMQProgOptions.h>
@@ -184,3 +185,23 @@ BOOST_AUTO_TEST_CASE(TestServiceDeclaration)
   BOOST_CHECK(registry.active<CallbackService>() == true);
   BOOST_CHECK(registry.active<DummyService>() == false);
 }
+
+BOOST_AUTO_TEST_CASE(TestStreamServiceDeclaration)
+{
+  using namespace o2::framework;
+  ServiceRegistry registry;
+  DeviceState state;
+  FairMQProgOptions options;
+
+  registry.declareService(CommonServices::callbacksSpec(), state, options);
+  registry.declareService(CommonServices::timingInfoSpec(), state, options);
+  registry.get<TimingInfo>().timeslice = 1;
+
+  // Stream services get a new instance, the others are shared.
+  ServiceRegistry stream{registry};
+  stream.declareStreamServices(registry, state, options);
+  stream.get<TimingInfo>().timeslice = 2;
+  BOOST_CHECK_EQUAL(registry.get<TimingInfo>().timeslice, 1);
+  BOOST_CHECK_EQUAL(stream.get<TimingInfo>().timeslice, 2);
+  BOOST_CHECK_EQUAL(&registry.get<CallbackService>(), &stream.get<CallbackService>());
+}
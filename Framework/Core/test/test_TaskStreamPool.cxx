@@ -0,0 +1,83 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework TaskStreamPool
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "Framework/TaskStreamPool.h"
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestAllTasksAreExecuted)
+{
+  TaskStreamPool pool{4};
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+  std::atomic<int> sum = 0;
+  std::array<std::atomic<int>, 4> perStream{};
+  for (int i = 1; i <= 1000; ++i) {
+    pool.push([&sum, &perStream, i](TaskStreamRef ref) {
+      sum += i;
+      perStream.at(ref.index)++;
+    });
+  }
+  pool.waitIdle();
+  BOOST_CHECK_EQUAL(pool.pending(), 0);
+  BOOST_CHECK_EQUAL(sum.load(), 500500);
+  int total = 0;
+  for (auto& n : perStream) {
+    total += n;
+  }
+  BOOST_CHECK_EQUAL(total, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(TestWorkStealing)
+{
+  // The first stream gets stuck on a long task, its other tasks
+  // must be picked up by the remaining streams.
+  TaskStreamPool pool{2};
+  std::atomic<bool> release = false;
+  std::atomic<int> done = 0;
+  pool.push([&release](TaskStreamRef) {
+    while (release == false) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  for (int i = 0; i < 10; ++i) {
+    pool.push([&done](TaskStreamRef) { done++; });
+  }
+  auto start = std::chrono::steady_clock::now();
+  while (done < 10 && std::chrono::steady_clock::now() - start < std::chrono::seconds(10)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(done.load(), 10);
+  BOOST_CHECK_EQUAL(pool.pending(), 1);
+  release = true;
+  pool.waitIdle();
+  BOOST_CHECK_EQUAL(pool.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestErrorPropagation)
+{
+  TaskStreamPool pool{2};
+  pool.push([](TaskStreamRef) { throw std::runtime_error("failure in task"); });
+  BOOST_CHECK_THROW(pool.waitIdle(), std::runtime_error);
+  // The error is reported only once and the pool is still usable
+  std::atomic<int> done = 0;
+  pool.push([&done](TaskStreamRef) { done++; });
+  pool.waitIdle();
+  BOOST_CHECK_EQUAL(done.load(), 1);
+}
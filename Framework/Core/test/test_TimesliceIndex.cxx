@@ -161,3 +161,63 @@ BOOST_AUTO_TEST_CASE(TestOldestPossibleTimeslice)
   index.updateOldestPossibleOutput();
   BOOST_CHECK_EQUAL(index.getOldestPossibleOutput().timeslice.value, 10);
 }
+
+BOOST_AUTO_TEST_CASE(TestDirtySlots)
+{
+  using namespace o2::framework;
+  TimesliceIndex index{1, 1};
+  index.resize(10);
+  std::vector<TimesliceSlot> slots;
+
+  index.collectDirtySlots(slots);
+  BOOST_CHECK(slots.empty());
+  index.markAsDirty({3}, true);
+  index.associate(TimesliceId{10}, TimesliceSlot{7});
+  index.markAsDirty({3}, false);
+  index.markAsDirty({3}, true);
+  index.markAsDirty({5}, true);
+  index.markAsDirty({5}, false);
+  index.collectDirtySlots(slots);
+  BOOST_REQUIRE_EQUAL(slots.size(), 2);
+  BOOST_CHECK_EQUAL(slots[0].index, 7);
+  BOOST_CHECK_EQUAL(slots[1].index, 3);
+  // Slots which are still dirty are not reported twice, unless they
+  // are marked again after being processed.
+  index.collectDirtySlots(slots);
+  BOOST_CHECK(slots.empty());
+  index.markAsDirty({7}, false);
+  index.markAsDirty({3}, false);
+  index.rescan();
+  index.collectDirtySlots(slots);
+  BOOST_CHECK_EQUAL(slots.size(), 10);
+  BOOST_CHECK_EQUAL(slots[0].index, 9);
+  BOOST_CHECK_EQUAL(slots[9].index, 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestInFlightTimeslices)
+{
+  using namespace o2::framework;
+  TimesliceIndex index{1, 1};
+  index.resize(2);
+  index.associate(TimesliceId{5}, TimesliceSlot{0});
+  index.associate(TimesliceId{6}, TimesliceSlot{1});
+  (void)index.setOldestPossibleInput({10}, {0});
+  index.updateOldestPossibleOutput();
+  BOOST_CHECK_EQUAL(index.getOldestPossibleOutput().timeslice.value, 5);
+
+  // The inputs of both slots are consumed, but the processing is not done.
+  index.markAsInFlight(TimesliceId{5});
+  index.markAsInFlight(TimesliceId{6});
+  index.markAsInvalid({0});
+  index.markAsInvalid({1});
+  index.updateOldestPossibleOutput();
+  BOOST_CHECK_EQUAL(index.getOldestPossibleOutput().timeslice.value, 5);
+
+  // Processing can complete out of order.
+  index.markAsProcessed(TimesliceId{6});
+  index.updateOldestPossibleOutput();
+  BOOST_CHECK_EQUAL(index.getOldestPossibleOutput().timeslice.value, 5);
+  index.markAsProcessed(TimesliceId{5});
+  index.updateOldestPossibleOutput();
+  BOOST_CHECK_EQUAL(index.getOldestPossibleOutput().timeslice.value, 10);
+}
@@ -22,6 +22,7 @@
 
 #include <TTree.h>
 #include <TRandom.h>
+#include <TROOT.h>
 #include <arrow/table.h>
 
 using namespace o2::framework;
@@ -239,3 +240,36 @@ BOOST_AUTO_TEST_CASE(VariableLists)
     ++i;
   }
 }
+
+BOOST_AUTO_TEST_CASE(TreeToTableCachedParallel)
+{
+  // Reuses the file written by TreeToTableConversion
+  auto* f = TFile::Open("tree2table.root", "READ");
+  BOOST_REQUIRE(f != nullptr);
+  auto* tree = static_cast<TTree*>(f->Get("t1"));
+  TreeToTable serial;
+  serial.addAllColumns(tree);
+  serial.fill(tree);
+  auto expected = serial.finalize();
+  delete tree;
+
+#ifdef R__USE_IMT
+  ROOT::EnableImplicitMT(2);
+#endif
+  tree = static_cast<TTree*>(f->Get("t1"));
+  TreeToTable parallel;
+  parallel.setCacheSize(10000000);
+  parallel.setParallel(true);
+  parallel.addAllColumns(tree, {"px", "ij", "tests", "ev"});
+  parallel.fill(tree);
+  auto table = parallel.finalize();
+  delete tree;
+  f->Close();
+
+  BOOST_REQUIRE_EQUAL(table->Validate().ok(), true);
+  BOOST_REQUIRE_EQUAL(table->num_columns(), 4);
+  BOOST_REQUIRE_EQUAL(table->num_rows(), expected->num_rows());
+  for (auto& name : {"px", "ij", "tests", "ev"}) {
+    BOOST_CHECK(table->GetColumnByName(name)->Equals(expected->GetColumnByName(name)));
+  }
+}
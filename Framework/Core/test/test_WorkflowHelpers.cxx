@@ -652,3 +652,38 @@ BOOST_AUTO_TEST_CASE(TestOriginWildcard)
     }
   }
 }
+
+BOOST_AUTO_TEST_CASE(TestReaderColumns)
+{
+  auto column = [](std::string const& name) {
+    return ConfigParamSpec{"column:" + name, VariantType::Bool, true, {"\"\""}};
+  };
+  auto columnsOf = [](OutputSpec const& output) {
+    std::vector<std::string> names;
+    for (auto& param : output.metadata) {
+      if (param.name.rfind("column:", 0) == 0) {
+        names.push_back(param.name.substr(7));
+      }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+  };
+
+  // The same table requested under different bindings, with different
+  // columns: the reader reads their union.
+  std::vector<InputSpec> requested{
+    InputSpec{"Tracks", "AOD", "TRACK", 0, Lifetime::Timeframe, {column("fX"), column("fY")}},
+    InputSpec{"TracksXZ", "AOD", "TRACK", 0, Lifetime::Timeframe, {column("fX"), column("fZ")}},
+    InputSpec{"Collisions", "AOD", "COLLISION", 0, Lifetime::Timeframe, {column("fPosX")}},
+    InputSpec{"CollisionsAll", "AOD", "COLLISION", 0, Lifetime::Timeframe, {column("*")}},
+    InputSpec{"Provided", "AOD", "PROVIDED", 0, Lifetime::Timeframe, {column("fA")}}};
+  DataProcessorSpec reader{"internal-dpl-aod-reader", {}, {}};
+  WorkflowHelpers::addMissingOutputsToReader({OutputSpec{"AOD", "PROVIDED"}}, requested, reader);
+
+  BOOST_REQUIRE_EQUAL(reader.outputs.size(), 2);
+  BOOST_CHECK(DataSpecUtils::match(reader.outputs[0], ConcreteDataMatcher{"AOD", "TRACK", 0}));
+  BOOST_CHECK(columnsOf(reader.outputs[0]) == (std::vector<std::string>{"fX", "fY", "fZ"}));
+  // A consumer which needs the whole table overrides the listed columns.
+  BOOST_CHECK(DataSpecUtils::match(reader.outputs[1], ConcreteDataMatcher{"AOD", "COLLISION", 0}));
+  BOOST_CHECK(columnsOf(reader.outputs[1]) == (std::vector<std::string>{"*", "fPosX"}));
+}
@@ -0,0 +1,139 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_TRACERECORDER_H_
+#define O2_FRAMEWORK_TRACERECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// The kind of activity a trace event refers to.
+enum struct TraceCategory : uint8_t {
+  Relay,
+  Dispatch,
+  Processing,
+  Sending,
+  Allocation,
+  Count
+};
+
+struct TraceEvent {
+  /// What happened. Must point to a string with static storage.
+  char const* name = nullptr;
+  /// When it started, in ns of the monotonic clock, which is shared by all
+  /// the processes of the machine.
+  uint64_t start = 0;
+  /// How long it took in ns, 0 for instantaneous events.
+  uint64_t duration = 0;
+  /// The timeslice being handled, -1 if unknown.
+  uint64_t timeslice = -1;
+  /// Event specific payload, e.g. the size of an allocation.
+  uint64_t value = 0;
+  TraceCategory category = TraceCategory::Count;
+};
+
+/// Records a timeline of events in a ring buffer per thread, so that the
+/// last N events of each thread can be dumped at any moment in the Chrome /
+/// Perfetto trace format. Recording does not take any lock: each buffer has a
+/// single writer and readers use a sequence number per slot to skip the
+/// entries being overwritten while they copy them.
+class TraceRecorder
+{
+ public:
+  /// Events kept by each thread.
+  static constexpr size_t DefaultCapacity = 1 << 16;
+
+  TraceRecorder();
+  ~TraceRecorder();
+  TraceRecorder(TraceRecorder const&) = delete;
+  TraceRecorder& operator=(TraceRecorder const&) = delete;
+
+  /// The recorder used by the framework.
+  static TraceRecorder& instance();
+
+  /// Start recording, keeping the last @a capacity events of each thread.
+  /// The capacity only applies to threads which did not record anything yet.
+  void enable(size_t capacity = DefaultCapacity);
+  /// Stop recording. What was recorded is kept.
+  void disable();
+  bool enabled() const { return mCapacity.load(std::memory_order_relaxed) != 0; }
+
+  /// Current time, in the units used by TraceEvent.
+  static uint64_t now();
+
+  /// Add @a event to the buffer of the calling thread.
+  void record(TraceEvent const& event);
+
+  /// A copy of the events currently held, with the id of the thread which
+  /// recorded them.
+  std::vector<std::pair<int, TraceEvent>> snapshot() const;
+
+  /// Write the recorded events in the Chrome trace JSON format, as
+  /// belonging to process @a pid, labelled @a processName.
+  void dumpChromeTrace(std::ostream& out, int pid, std::string_view processName) const;
+
+  /// Concatenate traces written by dumpChromeTrace, e.g. by different
+  /// devices, in a single one. Files which cannot be read are skipped.
+  static void mergeChromeTraces(std::vector<std::string> const& filenames, std::ostream& out);
+
+ private:
+  struct Buffer;
+  Buffer* threadBuffer(size_t capacity);
+
+  /// Unique id of the recorder, used to invalidate the per thread caches.
+  uint64_t mId;
+  std::atomic<size_t> mCapacity = 0;
+  /// Guards the list of buffers, i.e. the first record of each thread.
+  mutable std::mutex mMutex;
+  std::vector<std::unique_ptr<Buffer>> mBuffers;
+};
+
+/// Records an event for the lifetime of the object, if the framework
+/// recorder is enabled.
+class TraceScope
+{
+ public:
+  TraceScope(TraceCategory category, char const* name, uint64_t timeslice = -1, uint64_t value = 0)
+  {
+    if (TraceRecorder::instance().enabled()) {
+      mEvent = {name, TraceRecorder::now(), 0, timeslice, value, category};
+    }
+  }
+
+  ~TraceScope()
+  {
+    if (mEvent.name) {
+      mEvent.duration = TraceRecorder::now() - mEvent.start;
+      TraceRecorder::instance().record(mEvent);
+    }
+  }
+
+  /// Update the timeslice, when it is known only after the event started.
+  void setTimeslice(uint64_t timeslice) { mEvent.timeslice = timeslice; }
+
+  TraceScope(TraceScope const&) = delete;
+  TraceScope& operator=(TraceScope const&) = delete;
+
+ private:
+  TraceEvent mEvent;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_TRACERECORDER_H_
@@ -0,0 +1,188 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#include "Framework/TraceRecorder.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+namespace o2::framework
+{
+
+namespace
+{
+constexpr char const* CategoryNames[] = {"relay", "dispatch", "processing", "sending", "allocation"};
+static_assert(sizeof(CategoryNames) / sizeof(CategoryNames[0]) == (size_t)TraceCategory::Count);
+
+std::atomic<uint64_t> gNextRecorderId = 1;
+
+struct ThreadCache {
+  uint64_t recorderId = 0;
+  void* buffer = nullptr;
+};
+thread_local ThreadCache gThreadCache;
+
+void writeEscaped(std::ostream& out, std::string_view s)
+{
+  for (auto c : s) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+}
+} // namespace
+
+struct TraceRecorder::Buffer {
+  struct Slot {
+    /// 2 * (index + 1) when the slot holds the event with the given index,
+    /// odd while it is being written.
+    std::atomic<uint64_t> sequence = 0;
+    TraceEvent event;
+  };
+
+  Buffer(size_t capacity, int tid) : slots(capacity), tid{tid} {}
+
+  std::vector<Slot> slots;
+  std::atomic<uint64_t> head = 0;
+  int tid;
+};
+
+TraceRecorder::TraceRecorder()
+  : mId{gNextRecorderId++}
+{
+}
+
+TraceRecorder::~TraceRecorder() = default;
+
+TraceRecorder& TraceRecorder::instance()
+{
+  static TraceRecorder recorder;
+  return recorder;
+}
+
+void TraceRecorder::enable(size_t capacity)
+{
+  mCapacity.store(capacity, std::memory_order_relaxed);
+}
+
+void TraceRecorder::disable()
+{
+  mCapacity.store(0, std::memory_order_relaxed);
+}
+
+uint64_t TraceRecorder::now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TraceRecorder::Buffer* TraceRecorder::threadBuffer(size_t capacity)
+{
+  if (gThreadCache.recorderId == mId) {
+    return static_cast<Buffer*>(gThreadCache.buffer);
+  }
+  std::scoped_lock<std::mutex> lock(mMutex);
+  mBuffers.emplace_back(std::make_unique<Buffer>(capacity, (int)mBuffers.size()));
+  gThreadCache = {mId, mBuffers.back().get()};
+  return mBuffers.back().get();
+}
+
+void TraceRecorder::record(TraceEvent const& event)
+{
+  auto capacity = mCapacity.load(std::memory_order_relaxed);
+  if (capacity == 0) {
+    return;
+  }
+  auto* buffer = threadBuffer(capacity);
+  auto index = buffer->head.load(std::memory_order_relaxed);
+  auto& slot = buffer->slots[index % buffer->slots.size()];
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event = event;
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  buffer->head.store(index + 1, std::memory_order_release);
+}
+
+std::vector<std::pair<int, TraceEvent>> TraceRecorder::snapshot() const
+{
+  std::vector<std::pair<int, TraceEvent>> result;
+  std::scoped_lock<std::mutex> lock(mMutex);
+  for (auto& buffer : mBuffers) {
+    auto head = buffer->head.load(std::memory_order_acquire);
+    auto size = buffer->slots.size();
+    for (auto index = head > size ? head - size : 0; index < head; ++index) {
+      auto& slot = buffer->slots[index % size];
+      auto before = slot.sequence.load(std::memory_order_acquire);
+      if (before != 2 * index + 2) {
+        continue;
+      }
+      TraceEvent event = slot.event;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != before) {
+        continue;
+      }
+      result.emplace_back(buffer->tid, event);
+    }
+  }
+  return result;
+}
+
+void TraceRecorder::dumpChromeTrace(std::ostream& out, int pid, std::string_view processName) const
+{
+  // One event per line, so that traces can be merged without parsing them.
+  // Timestamps are in us, keeping the ns precision.
+  auto flags = out.flags();
+  auto precision = out.precision();
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\":[\n";
+  out << R"({"name":"process_name","ph":"M","pid":)" << pid << R"(,"tid":0,"args":{"name":")";
+  writeEscaped(out, processName);
+  out << "\"}}";
+  for (auto& [tid, event] : snapshot()) {
+    out << ",\n{\"name\":\"";
+    writeEscaped(out, event.name);
+    out << R"(","cat":")" << CategoryNames[(int)event.category] << "\",";
+    if (event.duration) {
+      out << R"("ph":"X","dur":)" << event.duration / 1000. << ",";
+    } else {
+      out << R"("ph":"i","s":"t",)";
+    }
+    out << "\"ts\":" << event.start / 1000. << ",\"pid\":" << pid << ",\"tid\":" << tid
+        << ",\"args\":{\"timeslice\":" << (int64_t)event.timeslice << ",\"value\":" << event.value << "}}";
+  }
+  out << "\n]}\n";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void TraceRecorder::mergeChromeTraces(std::vector<std::string> const& filenames, std::ostream& out)
+{
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (auto& filename : filenames) {
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line)) {
+      if (line.rfind("{\"name\"", 0) != 0) {
+        continue;
+      }
+      if (line.back() == ',') {
+        line.pop_back();
+      }
+      out << (first ? "\n" : ",\n") << line;
+      first = false;
+    }
+  }
+  out << "\n]}\n";
+}
+
+} // namespace o2::framework
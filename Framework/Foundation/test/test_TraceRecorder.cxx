@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#define BOOST_TEST_MODULE Test Framework TraceRecorder
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "Framework/TraceRecorder.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestRingBuffer)
+{
+  TraceRecorder recorder;
+  recorder.record({"ignored", 1, 1, 0, 0, TraceCategory::Relay});
+  BOOST_CHECK_EQUAL(recorder.snapshot().size(), 0);
+
+  recorder.enable(4);
+  for (uint64_t i = 0; i < 10; ++i) {
+    recorder.record({"event", i, 1, i, 0, TraceCategory::Processing});
+  }
+  auto events = recorder.snapshot();
+  // Only the last 4 are kept
+  BOOST_REQUIRE_EQUAL(events.size(), 4);
+  for (size_t i = 0; i < 4; ++i) {
+    BOOST_CHECK_EQUAL(events[i].first, 0);
+    BOOST_CHECK_EQUAL(events[i].second.timeslice, 6 + i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TestConcurrentRecording)
+{
+  TraceRecorder recorder;
+  recorder.enable(128);
+  std::vector<std::thread> threads;
+  for (int ti = 0; ti < 4; ++ti) {
+    threads.emplace_back([&recorder]() {
+      for (uint64_t i = 0; i < 100000; ++i) {
+        recorder.record({"event", i, 1, i, 0, TraceCategory::Sending});
+      }
+    });
+  }
+  // Reading while the others are writing must only return consistent events
+  for (int i = 0; i < 100; ++i) {
+    for (auto& [tid, event] : recorder.snapshot()) {
+      BOOST_CHECK_EQUAL(event.start, event.timeslice);
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto events = recorder.snapshot();
+  BOOST_CHECK_EQUAL(events.size(), 4 * 128);
+}
+
+BOOST_AUTO_TEST_CASE(TestChromeTrace)
+{
+  TraceRecorder recorder;
+  recorder.enable();
+  recorder.record({"process", 2000000000123, 2000, 3, 0, TraceCategory::Processing});
+  recorder.record({"alloc", 2000000001000, 0, 3, 1024, TraceCategory::Allocation});
+  std::ostringstream out;
+  recorder.dumpChromeTrace(out, 42, "device \"a\"");
+  auto expected = R"({"traceEvents":[
+{"name":"process_name","ph":"M","pid":42,"tid":0,"args":{"name":"device \"a\""}},
+{"name":"process","cat":"processing","ph":"X","dur":2.000,"ts":2000000000.123,"pid":42,"tid":0,"args":{"timeslice":3,"value":0}},
+{"name":"alloc","cat":"allocation","ph":"i","s":"t","ts":2000000001.000,"pid":42,"tid":0,"args":{"timeslice":3,"value":1024}}
+]}
+)";
+  BOOST_CHECK_EQUAL(out.str(), expected);
+
+  std::string files[2] = {"test_TraceRecorder_0.json", "test_TraceRecorder_1.json"};
+  for (int i = 0; i < 2; ++i) {
+    std::ofstream file(files[i]);
+    recorder.dumpChromeTrace(file, i, "device");
+  }
+  std::ostringstream merged;
+  TraceRecorder::mergeChromeTraces({files[0], files[1], "missing.json"}, merged);
+  std::istringstream in(merged.str());
+  std::string line;
+  int events = 0;
+  while (std::getline(in, line)) {
+    events += line.rfind("{\"name\"", 0) == 0;
+  }
+  BOOST_CHECK_EQUAL(events, 6);
+  BOOST_CHECK(merged.str().find("\"pid\":1,") != std::string::npos);
+  for (auto& file : files) {
+    std::remove(file.c_str());
+  }
+}
@@ -18,12 +18,15 @@
 #define INCLUDE_RANS_FREQUENCYTABLE_H_
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <numeric>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <fairlogger/Logger.h>
@@ -37,6 +40,34 @@ namespace o2
 namespace rans
 {
 
+namespace internal
+{
+// samples of the iterator are stored contiguously and can be accessed via pointer
+template <typename IT>
+inline constexpr bool isContiguousIter_v = !std::is_same_v<typename std::iterator_traits<IT>::value_type, bool> &&
+                                           (std::is_pointer_v<IT> ||
+                                            std::is_same_v<IT, typename std::vector<typename std::iterator_traits<IT>::value_type>::iterator> ||
+                                            std::is_same_v<IT, typename std::vector<typename std::iterator_traits<IT>::value_type>::const_iterator>);
+
+// histogramming strategies, see addSamples
+inline constexpr size_t NSubHistograms = 4;                // number of interleaved sub-histograms for messages much longer than the alphabet range
+inline constexpr size_t MaxSubHistogramRange = 1ul << 16;  // max alphabet range for which the sub-histograms are used
+inline constexpr size_t MinSparseHistogramRange = 1ul << 20; // min alphabet range for which the sorting of sparse samples is considered
+
+template <typename Source_IT>
+std::pair<symbol_t, symbol_t> minmaxContiguous(Source_IT begin, Source_IT end);
+
+template <bool checkRange, typename Source_IT>
+size_t histogramDense(Source_IT begin, Source_IT end, symbol_t min, count_t* table, size_t tableSize);
+
+template <bool checkRange, typename Source_IT>
+size_t histogramSparse(Source_IT begin, Source_IT end, symbol_t min, count_t* table, size_t tableSize);
+} // namespace internal
+
+/// min and max symbols of the source message, a single pass vectorizable for the contiguous messages
+template <typename Source_IT, std::enable_if_t<internal::isIntegralIter_v<Source_IT>, bool> = true>
+std::pair<symbol_t, symbol_t> computeMinMax(Source_IT begin, Source_IT end);
+
 class FrequencyTable
 {
  public:
@@ -92,6 +123,7 @@ class FrequencyTable
   template <typename Source_IT, std::enable_if_t<internal::isIntegralIter_v<Source_IT>, bool> = true>
   FrequencyTable& addSamples(Source_IT begin, Source_IT end, bool extendTable = true);
 
+  // min and max must cover all samples if extendTable is true, the caller who knows them saves the extra pass over the message
   template <typename Source_IT, std::enable_if_t<internal::isIntegralIter_v<Source_IT>, bool> = true>
   FrequencyTable& addSamples(Source_IT begin, Source_IT end, symbol_t min, symbol_t max, bool extendTable = true);
 
@@ -144,6 +176,119 @@ namespace o2
 namespace rans
 {
 
+namespace internal
+{
+template <typename Source_IT>
+std::pair<symbol_t, symbol_t> minmaxContiguous(Source_IT begin, Source_IT end)
+{
+  // independent min/max lanes w/o data dependencies between them are mapped by the compiler to SIMD registers
+  using source_t = typename std::iterator_traits<Source_IT>::value_type;
+  constexpr size_t NLanes = 32 / sizeof(source_t);
+  const source_t* ptr = &(*begin);
+  const size_t nSamples = std::distance(begin, end);
+  source_t mins[NLanes], maxs[NLanes];
+  std::fill(std::begin(mins), std::end(mins), ptr[0]);
+  std::fill(std::begin(maxs), std::end(maxs), ptr[0]);
+  size_t i = 0;
+  for (; i + NLanes <= nSamples; i += NLanes) {
+    for (size_t l = 0; l < NLanes; l++) {
+      mins[l] = std::min(mins[l], ptr[i + l]);
+      maxs[l] = std::max(maxs[l], ptr[i + l]);
+    }
+  }
+  for (; i < nSamples; i++) {
+    mins[0] = std::min(mins[0], ptr[i]);
+    maxs[0] = std::max(maxs[0], ptr[i]);
+  }
+  return {static_cast<symbol_t>(*std::min_element(std::begin(mins), std::end(mins))),
+          static_cast<symbol_t>(*std::max_element(std::begin(maxs), std::end(maxs)))};
+}
+
+template <bool checkRange, typename Source_IT>
+size_t histogramDense(Source_IT begin, Source_IT end, symbol_t min, count_t* table, size_t tableSize)
+{
+  // count samples to the table, returns the number of counted samples. For long messages with small alphabet range the
+  // consecutive samples are counted to different sub-histograms, so that the repeated symbols do not stall on the same counter
+  const size_t nSamples = std::distance(begin, end);
+  size_t nOutOfRange = 0;
+  auto count = [&nOutOfRange, min, tableSize](count_t* histogram, symbol_t symbol) {
+    // negative numbers cause overflow thus we get away with one comparison only
+    const size_t index = static_cast<size_t>(symbol - min);
+    if constexpr (checkRange) {
+      if (index >= tableSize) {
+        ++nOutOfRange;
+        return;
+      }
+    }
+    assert(index < tableSize);
+    ++histogram[index];
+  };
+  if (tableSize > MaxSubHistogramRange || nSamples < NSubHistograms * tableSize) {
+    for (auto it = begin; it != end; ++it) {
+      count(table, static_cast<symbol_t>(*it));
+    }
+    return nSamples - nOutOfRange;
+  }
+  histogram_t subHistograms((NSubHistograms - 1) * tableSize, 0);
+  std::array<count_t*, NSubHistograms> histograms{table};
+  for (size_t ih = 1; ih < NSubHistograms; ih++) {
+    histograms[ih] = subHistograms.data() + (ih - 1) * tableSize;
+  }
+  auto it = begin;
+  for (size_t i = nSamples / NSubHistograms; i--;) {
+    for (size_t ih = 0; ih < NSubHistograms; ih++) {
+      count(histograms[ih], static_cast<symbol_t>(*it++));
+    }
+  }
+  for (; it != end; ++it) {
+    count(table, static_cast<symbol_t>(*it));
+  }
+  for (size_t ih = 1; ih < NSubHistograms; ih++) {
+    std::transform(histograms[ih], histograms[ih] + tableSize, table, table, std::plus<count_t>());
+  }
+  return nSamples - nOutOfRange;
+}
+
+template <bool checkRange, typename Source_IT>
+size_t histogramSparse(Source_IT begin, Source_IT end, symbol_t min, count_t* table, size_t tableSize)
+{
+  // for the alphabet range much larger than the message the random access to the table is dominated by cache misses,
+  // the sorted samples are counted in a single ordered pass instead
+  std::vector<symbol_t> samples(begin, end);
+  std::sort(samples.begin(), samples.end());
+  size_t nCounted = 0;
+  for (auto it = samples.begin(); it != samples.end();) {
+    const auto runEnd = std::find_if(it, samples.end(), [symbol = *it](symbol_t s) { return s != symbol; });
+    const size_t index = static_cast<size_t>(*it - min);
+    if constexpr (checkRange) {
+      if (index >= tableSize) {
+        it = runEnd;
+        continue;
+      }
+    }
+    assert(index < tableSize);
+    table[index] += std::distance(it, runEnd);
+    nCounted += std::distance(it, runEnd);
+    it = runEnd;
+  }
+  return nCounted;
+}
+} // namespace internal
+
+template <typename Source_IT, std::enable_if_t<internal::isIntegralIter_v<Source_IT>, bool>>
+std::pair<symbol_t, symbol_t> computeMinMax(Source_IT begin, Source_IT end)
+{
+  if (begin == end) {
+    return {0, 0};
+  }
+  if constexpr (internal::isContiguousIter_v<Source_IT>) {
+    return internal::minmaxContiguous(begin, end);
+  } else {
+    const auto [minIter, maxIter] = std::minmax_element(begin, end);
+    return {static_cast<symbol_t>(*minIter), static_cast<symbol_t>(*maxIter)};
+  }
+}
+
 template <typename Freq_IT, std::enable_if_t<internal::isIntegralIter_v<Freq_IT>, bool>>
 FrequencyTable::FrequencyTable(Freq_IT begin, Freq_IT end, symbol_t min, count_t incompressibleSymbolFrequency)
 {
@@ -156,8 +301,8 @@ template <typename Source_IT, std::enable_if_t<internal::isIntegralIter_v<Source
 inline FrequencyTable& FrequencyTable::addSamples(Source_IT begin, Source_IT end, bool extendTable)
 {
   if (begin != end) {
-    const auto& [minIter, maxIter] = std::minmax_element(begin, end);
-    addSamples(begin, end, *minIter, *maxIter, extendTable);
+    const auto [min, max] = computeMinMax(begin, end);
+    addSamples(begin, end, min, max, extendTable);
   } else {
     LOG(warning) << "Passed empty message to " << __func__; // RS this is ok for empty columns
   }
@@ -174,19 +319,27 @@ FrequencyTable& FrequencyTable::addSamples(Source_IT begin, Source_IT end, symbo
   if (begin == end) {
     LOG(warning) << "Passed empty message to " << __func__; // RS this is ok for empty columns
   } else {
+    const size_t nSamples = std::distance(begin, end);
     if (extendTable) {
-      this->resize(min, max);
-      // add new symbols
-      std::for_each(begin, end, [this](symbol_t symbol) { ++this->getSymbol(this->sampleCountingDecorator(symbol)); });
+      if (this->empty() || min < this->getMinSymbol() || max > this->getMaxSymbol()) {
+        this->resize(std::min(min, this->empty() ? min : this->getMinSymbol()), std::max(max, this->empty() ? max : this->getMaxSymbol()));
+      }
+    }
+    if (this->empty()) {
+      mIncompressibleSymbolFrequency += nSamples;
     } else {
-      // add new symbols but all that are out of range are set to incompressible
-      std::for_each(begin, end, [this](symbol_t symbol) {
-        if (this->empty() || symbol < this->getMinSymbol() || symbol > this->getMaxSymbol()) {
-          ++this->mIncompressibleSymbolFrequency;
-        } else {
-          ++this->getSymbol(this->sampleCountingDecorator(symbol));
-        }
-      });
+      // sort the samples if they are too sparse to be counted efficiently in the table, otherwise count them directly
+      const bool sparse = size() >= internal::MinSparseHistogramRange && size() > 16 * nSamples;
+      size_t nCounted = 0;
+      if (extendTable) {
+        nCounted = sparse ? internal::histogramSparse<false>(begin, end, mOffset, mFrequencyTable.data(), size())
+                          : internal::histogramDense<false>(begin, end, mOffset, mFrequencyTable.data(), size());
+      } else { // all samples out of range are set to incompressible
+        nCounted = sparse ? internal::histogramSparse<true>(begin, end, mOffset, mFrequencyTable.data(), size())
+                          : internal::histogramDense<true>(begin, end, mOffset, mFrequencyTable.data(), size());
+      }
+      mNumSamples += nCounted;
+      mIncompressibleSymbolFrequency += nSamples - nCounted;
     }
   }
 
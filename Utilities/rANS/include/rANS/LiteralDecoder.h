@@ -32,6 +32,7 @@
 #include "rANS/internal/SymbolTable.h"
 #include "rANS/internal/Decoder.h"
 #include "rANS/internal/DecoderBase.h"
+#include "rANS/internal/InterleavedDecoder.h"
 
 namespace o2
 {
@@ -47,6 +48,10 @@ class LiteralDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
   template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
 
+  // decode a message encoded with LiteralEncoder::processInterleaved<nStreams_V>
+  template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  void processInterleaved(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
+
  private:
   using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
 };
@@ -76,8 +81,9 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
   auto decode = [&, this](ransDecoder_t& decoder) {
     const auto cumul = decoder.get();
     const auto streamSymbol = (this->mReverseLUT)[cumul];
+    const auto& decoderSymbol = (this->mSymbolTable)[streamSymbol]; // single lookup serves the escape check and the decoding
     source_T symbol = streamSymbol;
-    if (this->mSymbolTable.isEscapeSymbol(streamSymbol)) {
+    if (&decoderSymbol == &this->mSymbolTable.getEscapeSymbol()) {
       symbol = literals.back();
       literals.pop_back();
     }
@@ -86,7 +92,7 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
     arrayLogger << symbol;
 #endif
 
-    return std::make_tuple(symbol, decoder.advanceSymbol(inputIter, (this->mSymbolTable)[streamSymbol]));
+    return std::make_tuple(symbol, decoder.advanceSymbol(inputIter, decoderSymbol));
   };
 
   // make Iter point to the last last element
@@ -119,6 +125,65 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
 
   LOG(trace) << "done decoding";
 }
+
+template <typename coder_T, typename stream_T, typename source_T>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+void LiteralDecoder<coder_T, stream_T, source_T>::processInterleaved(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const
+{
+  using namespace internal;
+  LOG(trace) << "start decoding";
+  RANSTimer t;
+  t.start();
+
+  if (messageLength == 0) {
+    LOG(warning) << "Empty message passed to decoder, skipping decode process";
+    return;
+  }
+
+  stream_IT inputIter = inputEnd;
+  source_IT it = outputBegin;
+
+  InterleavedDecoder<coder_T, stream_T, nStreams_V> rans{this->mSymbolTable.getPrecision()};
+
+  auto lookup = [&, this](size_t lane) -> const DecoderSymbol& {
+    const auto streamSymbol = (this->mReverseLUT)[rans.get(lane)];
+    const auto& decoderSymbol = (this->mSymbolTable)[streamSymbol];
+    if (&decoderSymbol == &this->mSymbolTable.getEscapeSymbol()) {
+      *it++ = literals.back();
+      literals.pop_back();
+    } else {
+      *it++ = streamSymbol;
+    }
+    return decoderSymbol;
+  };
+
+  // make Iter point to the last last element
+  --inputIter;
+  inputIter = rans.init(inputIter);
+
+  const size_t nFullGroups = messageLength / nStreams_V;
+  for (size_t i = 0; i < nFullGroups; ++i) {
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      rans.setSymbol(lane, lookup(lane));
+    }
+    inputIter = rans.advanceSymbols(inputIter);
+  }
+
+  // incomplete tail group
+  for (size_t lane = 0; lane < messageLength % nStreams_V; ++lane) {
+    inputIter = rans.advanceSymbol(inputIter, lookup(lane), lane);
+  }
+  t.stop();
+
+  LOG(debug1) << "Decoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
+              << "processedBytes: " << messageLength * sizeof(source_T) << ","
+              << " nStreams: " << nStreams_V << ","
+              << " inclusiveTimeMS: " << t.getDurationMS() << ","
+              << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (messageLength * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+
+  LOG(trace) << "done decoding";
+}
+
 } // namespace rans
 } // namespace o2
 
@@ -26,6 +26,7 @@
 
 #include "rANS/internal/EncoderBase.h"
 #include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/InterleavedEncoder.h"
 #include "rANS/internal/helper.h"
 #include "rANS/internal/SymbolTable.h"
 
@@ -45,6 +46,11 @@ class LiteralEncoder : public internal::EncoderBase<coder_T, stream_T, source_T>
   template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
   stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const;
 
+  // encode using nStreams_V interleaved rANS states, the result must be decoded with the same number of streams.
+  // For nStreams_V == 2 the output is identical to process().
+  template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  stream_IT processInterleaved(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const;
+
  private:
   using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::ransCoder_t;
 };
@@ -132,6 +138,63 @@ stream_IT LiteralEncoder<coder_T, stream_T, source_T>::process(source_IT inputBe
   return outputIter;
 };
 
+template <typename coder_T, typename stream_T, typename source_T>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
+stream_IT LiteralEncoder<coder_T, stream_T, source_T>::processInterleaved(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, std::vector<source_T>& literals) const
+{
+  using namespace internal;
+  using interleavedCoder_t = InterleavedEncoder<coder_T, stream_T, nStreams_V>;
+  LOG(trace) << "start encoding";
+  RANSTimer t;
+  t.start();
+
+  if (inputBegin == inputEnd) {
+    LOG(warning) << "passed empty message to encoder, skip encoding";
+    return outputBegin;
+  }
+
+  interleavedCoder_t rans{this->mSymbolTable.getPrecision()};
+
+  stream_IT outputIter = outputBegin;
+  source_IT inputIT = inputEnd;
+
+  const auto inputBufferSize = std::distance(inputBegin, inputEnd);
+
+  auto lookup = [&, this](source_IT symbolIter) -> const EncoderSymbol<coder_T>& {
+    const source_T symbol = *symbolIter;
+    if (this->mSymbolTable.isEscapeSymbol(symbol)) {
+      literals.push_back(symbol);
+    }
+    return (this->mSymbolTable)[symbol];
+  };
+
+  // incomplete tail group, symbol i always goes to lane i % nStreams_V
+  for (size_t lane = inputBufferSize % nStreams_V; lane-- > 0;) {
+    outputIter = rans.putSymbol(outputIter, lookup(--inputIT), lane);
+  }
+
+  typename interleavedCoder_t::symbolGroup_t symbols;
+  while (inputIT != inputBegin) { // NB: working in reverse!
+    for (size_t lane = nStreams_V; lane-- > 0;) {
+      symbols[lane] = &lookup(--inputIT);
+    }
+    outputIter = rans.putSymbols(outputIter, symbols);
+  }
+  outputIter = rans.flush(outputIter);
+  // first iterator past the range so that sizes, distances and iterators work correctly.
+  ++outputIter;
+
+  t.stop();
+  LOG(debug1) << "Encoder::" << __func__ << " {ProcessedBytes: " << inputBufferSize * sizeof(source_T) << ","
+              << " nStreams: " << nStreams_V << ","
+              << " inclusiveTimeMS: " << t.getDurationMS() << ","
+              << " BandwidthMiBPS: " << std::fixed << std::setprecision(2) << (inputBufferSize * sizeof(source_T) * 1.0) / (t.getDurationS() * 1.0 * (1 << 20)) << "}";
+
+  LOG(trace) << "done encoding";
+
+  return outputIter;
+};
+
 } // namespace rans
 } // namespace o2
 
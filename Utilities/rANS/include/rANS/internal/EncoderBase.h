@@ -58,6 +58,9 @@ class EncoderBase
   inline size_t getAlphabetRangeBits() const noexcept { return mSymbolTable.getAlphabetRangeBits(); };
   inline symbol_t getMinSymbol() const noexcept { return mSymbolTable.getMinSymbol(); };
   inline symbol_t getMaxSymbol() const noexcept { return mSymbolTable.getMaxSymbol(); };
+  // renormed frequency of the symbol, the escape symbol frequency for symbols not in the table
+  inline count_t getSymbolFrequency(symbol_t symbol) const noexcept { return mSymbolTable[symbol].getFrequency(); };
+  inline bool isEscapeSymbol(symbol_t symbol) const noexcept { return mSymbolTable.isEscapeSymbol(symbol); };
 
  protected:
   encoderSymbolTable_t mSymbolTable{};
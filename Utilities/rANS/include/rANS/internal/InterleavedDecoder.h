@@ -0,0 +1,245 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedDecoder.h
+/// @author agent
+/// @since  2026-10-16
+/// @brief  N-way interleaved rANS decoder kernel working on nStreams independent states
+
+#ifndef RANS_INTERNAL_INTERLEAVEDDECODER_H
+#define RANS_INTERNAL_INTERLEAVEDDECODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+namespace simd
+{
+
+// x' = frequency * (x >> precision) + (x & mask) - cumulative for all lanes.
+// scalar fallback, used for the 32 Bit coder and whenever no vector extension is available.
+template <typename state_T, size_t nStreams_V>
+inline void advanceStatesScalar(state_T* __restrict__ states, const state_T* __restrict__ frequencies, const state_T* __restrict__ cumulatives, size_t precision) noexcept
+{
+  const state_T mask = pow2(precision) - 1;
+  for (size_t lane = 0; lane < nStreams_V; ++lane) {
+    states[lane] = frequencies[lane] * (states[lane] >> precision) + (states[lane] & mask) - cumulatives[lane];
+  }
+}
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+// 8 x 64 Bit lanes per register, AVX512DQ provides the 64 Bit low multiply
+template <size_t nStreams_V, std::enable_if_t<(nStreams_V % 8 == 0), bool> = true>
+inline void advanceStatesAVX512(uint64_t* __restrict__ states, const uint64_t* __restrict__ frequencies, const uint64_t* __restrict__ cumulatives, size_t precision) noexcept
+{
+  const __m512i mask = _mm512_set1_epi64(pow2(precision) - 1);
+  const __m128i shift = _mm_cvtsi64_si128(precision);
+  for (size_t lane = 0; lane < nStreams_V; lane += 8) {
+    const __m512i x = _mm512_loadu_si512(states + lane);
+    const __m512i f = _mm512_loadu_si512(frequencies + lane);
+    const __m512i c = _mm512_loadu_si512(cumulatives + lane);
+    __m512i res = _mm512_mullo_epi64(f, _mm512_srl_epi64(x, shift));
+    res = _mm512_add_epi64(res, _mm512_and_si512(x, mask));
+    _mm512_storeu_si512(states + lane, _mm512_sub_epi64(res, c));
+  }
+}
+#endif
+
+#if defined(__AVX2__)
+// 4 x 64 Bit lanes per register. The frequency fits into 32 Bits, so the 64 Bit product is assembled
+// from two 32x32 Bit multiplies of the low and high halves of the shifted state.
+template <size_t nStreams_V, std::enable_if_t<(nStreams_V % 4 == 0), bool> = true>
+inline void advanceStatesAVX2(uint64_t* __restrict__ states, const uint64_t* __restrict__ frequencies, const uint64_t* __restrict__ cumulatives, size_t precision) noexcept
+{
+  const __m256i mask = _mm256_set1_epi64x(pow2(precision) - 1);
+  const __m128i shift = _mm_cvtsi64_si128(precision);
+  for (size_t lane = 0; lane < nStreams_V; lane += 4) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + lane));
+    const __m256i f = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(frequencies + lane));
+    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cumulatives + lane));
+    const __m256i y = _mm256_srl_epi64(x, shift);
+    const __m256i lo = _mm256_mul_epu32(y, f);
+    const __m256i hi = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(y, 32), f), 32);
+    __m256i res = _mm256_add_epi64(lo, hi);
+    res = _mm256_add_epi64(res, _mm256_and_si256(x, mask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + lane), _mm256_sub_epi64(res, c));
+  }
+}
+#endif
+
+// dispatch to the widest kernel available at compile time
+template <typename state_T, size_t nStreams_V>
+inline void advanceStates(state_T* __restrict__ states, const state_T* __restrict__ frequencies, const state_T* __restrict__ cumulatives, size_t precision) noexcept
+{
+  if constexpr (std::is_same_v<state_T, uint64_t>) {
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+    if constexpr (nStreams_V % 8 == 0) {
+      advanceStatesAVX512<nStreams_V>(states, frequencies, cumulatives, precision);
+      return;
+    }
+#endif
+#if defined(__AVX2__)
+    if constexpr (nStreams_V % 4 == 0) {
+      advanceStatesAVX2<nStreams_V>(states, frequencies, cumulatives, precision);
+      return;
+    }
+#endif
+  }
+  advanceStatesScalar<state_T, nStreams_V>(states, frequencies, cumulatives, precision);
+}
+
+} // namespace simd
+
+// Symbol i of a message is decoded from state i % nStreams. Within a group of nStreams symbols the
+// state updates of all lanes are independent and are computed with a vector kernel, the stream is consumed
+// afterwards in lane order, which reproduces exactly the order in which the encoder has written it.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedDecoder
+{
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 1 && isPow2(nStreams_V), "number of interleaved streams must be a power of 2");
+
+ public:
+  explicit InterleavedDecoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission{symbolTablePrecission} {};
+
+  static constexpr size_t getNStreams() noexcept { return nStreams_V; };
+
+  // Initializes all lanes, lane 0 is read first.
+  template <typename stream_IT>
+  stream_IT init(stream_IT inputIter);
+
+  // Returns the current cumulative frequency of the given lane
+  inline uint32_t get(size_t lane) const noexcept { return mStates[lane] & (pow2(mSymbolTablePrecission) - 1); };
+
+  // Register the decoded symbol of a lane before advancing the full group
+  inline void setSymbol(size_t lane, const DecoderSymbol& symbol) noexcept
+  {
+    mFrequencies[lane] = symbol.getFrequency();
+    mCumulatives[lane] = symbol.getCumulative();
+  };
+
+  // Advance all lanes with the symbols registered via setSymbol.
+  template <typename stream_IT>
+  stream_IT advanceSymbols(stream_IT inputIter);
+
+  // Advance a single lane, used for the incomplete tail group.
+  template <typename stream_IT>
+  stream_IT advanceSymbol(stream_IT inputIter, const DecoderSymbol& symbol, size_t lane);
+
+ private:
+  alignas(64) std::array<state_T, nStreams_V> mStates{};
+  alignas(64) std::array<state_T, nStreams_V> mFrequencies{};
+  alignas(64) std::array<state_T, nStreams_V> mCumulatives{};
+  size_t mSymbolTablePrecission{};
+
+  template <typename stream_IT>
+  stream_IT renorm(state_T& state, stream_IT inputIter) const;
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23); // lower bound of our normalization interval
+
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::init(stream_IT inputIter)
+{
+  for (size_t lane = 0; lane < nStreams_V; ++lane) {
+    state_T newState = 0;
+    if constexpr (needs64Bit<state_T>()) {
+      newState = static_cast<state_T>(*inputIter) << 0;
+      --inputIter;
+      newState |= static_cast<state_T>(*inputIter) << 32;
+      --inputIter;
+    } else {
+      newState = static_cast<state_T>(*inputIter) << 0;
+      --inputIter;
+      newState |= static_cast<state_T>(*inputIter) << 8;
+      --inputIter;
+      newState |= static_cast<state_T>(*inputIter) << 16;
+      --inputIter;
+      newState |= static_cast<state_T>(*inputIter) << 24;
+      --inputIter;
+    }
+    mStates[lane] = newState;
+  }
+  return inputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbols(stream_IT inputIter)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+
+  // s, x = D(x)
+  simd::advanceStates<state_T, nStreams_V>(mStates.data(), mFrequencies.data(), mCumulatives.data(), mSymbolTablePrecission);
+  // renormalize in lane order
+  for (size_t lane = 0; lane < nStreams_V; ++lane) {
+    inputIter = renorm(mStates[lane], inputIter);
+  }
+  return inputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbol(stream_IT inputIter, const DecoderSymbol& symbol, size_t lane)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+  assert(lane < nStreams_V);
+
+  const state_T mask = pow2(mSymbolTablePrecission) - 1;
+  state_T& state = mStates[lane];
+  state = symbol.getFrequency() * (state >> mSymbolTablePrecission) + (state & mask) - symbol.getCumulative();
+  return renorm(state, inputIter);
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::renorm(state_T& state, stream_IT inputIter) const
+{
+  if (state < LOWER_BOUND) {
+    if constexpr (needs64Bit<state_T>()) {
+      state = (state << STREAM_BITS) | *inputIter;
+      --inputIter;
+      assert(state >= LOWER_BOUND);
+    } else {
+      do {
+        state = (state << STREAM_BITS) | *inputIter;
+        --inputIter;
+      } while (state < LOWER_BOUND);
+    }
+  }
+  return inputIter;
+};
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDDECODER_H */
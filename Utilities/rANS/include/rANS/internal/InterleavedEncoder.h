@@ -0,0 +1,184 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedEncoder.h
+/// @author agent
+/// @since  2026-10-16
+/// @brief  N-way interleaved rANS encoder kernel working on nStreams independent states
+
+#ifndef RANS_INTERNAL_INTERLEAVEDENCODER_H
+#define RANS_INTERNAL_INTERLEAVEDENCODER_H
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <type_traits>
+
+#include "rANS/internal/EncoderSymbol.h"
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+// Symbol i of a message is always coded by state i % nStreams. Since the encoder works in reverse,
+// a group of nStreams symbols is coded from the highest to the lowest lane. The renormalization of a lane
+// only depends on its own state, so all stream writes of a group can be issued first (in lane order) and
+// the state updates, which carry the expensive multiplications, run afterwards without any dependency
+// between lanes. The produced stream is identical to coding the symbols one by one.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedEncoder
+{
+  __extension__ using uint128_t = unsigned __int128;
+
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 1 && isPow2(nStreams_V), "number of interleaved streams must be a power of 2");
+
+ public:
+  using symbol_t = EncoderSymbol<state_T>;
+  using symbolGroup_t = std::array<const symbol_t*, nStreams_V>;
+
+  explicit InterleavedEncoder(size_t symbolTablePrecission) noexcept;
+
+  static constexpr size_t getNStreams() noexcept { return nStreams_V; };
+
+  // Encodes a full group of nStreams symbols, symbols[i] is coded by lane i.
+  template <typename stream_IT>
+  stream_IT putSymbols(stream_IT outputIter, const symbolGroup_t& symbols);
+
+  // Encodes a single symbol by the given lane, used for the incomplete tail group.
+  template <typename stream_IT>
+  stream_IT putSymbol(stream_IT outputIter, const symbol_t& symbol, size_t lane);
+
+  // Flushes all states, the highest lane is flushed first so that the decoder can initialize lane 0 first.
+  template <typename stream_IT>
+  stream_IT flush(stream_IT outputIter);
+
+ private:
+  std::array<state_T, nStreams_V> mStates;
+  size_t mSymbolTablePrecission{};
+
+  template <typename stream_IT>
+  stream_IT renorm(state_T& state, stream_IT outputIter, uint32_t frequency) const;
+
+  static state_T updateState(state_T state, const symbol_t& symbol) noexcept;
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23); // lower bound of our normalization interval
+
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+InterleavedEncoder<state_T, stream_T, nStreams_V>::InterleavedEncoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission{symbolTablePrecission}
+{
+  mStates.fill(LOWER_BOUND);
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbols(stream_IT outputIter, const symbolGroup_t& symbols)
+{
+  // stream out in reverse lane order
+  for (size_t lane = nStreams_V; lane-- > 0;) {
+    assert(symbols[lane]->getFrequency() != 0); // can't encode symbol with freq=0
+    outputIter = renorm(mStates[lane], outputIter, symbols[lane]->getFrequency());
+  }
+  // independent state updates
+  for (size_t lane = 0; lane < nStreams_V; ++lane) {
+    mStates[lane] = updateState(mStates[lane], *symbols[lane]);
+  }
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::putSymbol(stream_IT outputIter, const symbol_t& symbol, size_t lane)
+{
+  assert(lane < nStreams_V);
+  assert(symbol.getFrequency() != 0); // can't encode symbol with freq=0
+  outputIter = renorm(mStates[lane], outputIter, symbol.getFrequency());
+  mStates[lane] = updateState(mStates[lane], symbol);
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::flush(stream_IT outputIter)
+{
+  for (size_t lane = nStreams_V; lane-- > 0;) {
+    const state_T state = mStates[lane];
+    if constexpr (needs64Bit<state_T>()) {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 32);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 0);
+    } else {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 24);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 16);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 8);
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state >> 0);
+    }
+    mStates[lane] = 0;
+  }
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedEncoder<state_T, stream_T, nStreams_V>::renorm(state_T& state, stream_IT outputIter, uint32_t frequency) const
+{
+  const state_T maxState = ((LOWER_BOUND >> mSymbolTablePrecission) << STREAM_BITS) * frequency; // this turns into a shift.
+  if (state >= maxState) {
+    if constexpr (needs64Bit<state_T>()) {
+      ++outputIter;
+      *outputIter = static_cast<stream_T>(state);
+      state >>= STREAM_BITS;
+      assert(state < maxState);
+    } else {
+      do {
+        ++outputIter;
+        //stream out 8 Bits
+        *outputIter = static_cast<stream_T>(state & 0xff);
+        state >>= STREAM_BITS;
+      } while (state >= maxState);
+    }
+  }
+  return outputIter;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+inline state_T InterleavedEncoder<state_T, stream_T, nStreams_V>::updateState(state_T state, const symbol_t& symbol) noexcept
+{
+  // x = C(s,x)
+  state_T quotient = 0;
+  if constexpr (needs64Bit<state_T>()) {
+    quotient = static_cast<state_T>((static_cast<uint128_t>(state) * symbol.getReciprocalFrequency()) >> 64);
+  } else {
+    quotient = static_cast<state_T>((static_cast<uint64_t>(state) * symbol.getReciprocalFrequency()) >> 32);
+  }
+  quotient = quotient >> symbol.getReciprocalShift();
+  return state + symbol.getBias() + quotient * symbol.getFrequencyComplement();
+};
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDENCODER_H */
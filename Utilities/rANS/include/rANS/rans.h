@@ -25,6 +25,8 @@
 #include "rANS/DedupDecoder.h"
 #include "rANS/LiteralEncoder.h"
 #include "rANS/LiteralDecoder.h"
+#include "rANS/internal/InterleavedEncoder.h"
+#include "rANS/internal/InterleavedDecoder.h"
 #include "rANS/internal/helper.h"
 
 namespace o2
@@ -61,6 +63,13 @@ using DedupDecoder32 = DedupDecoder<uint32_t, uint8_t, source_T>;
 template <typename source_T>
 using DedupDecoder64 = DedupDecoder<uint64_t, uint32_t, source_T>;
 
+/// number of interleaved rANS states which can be requested from LiteralEncoder::processInterleaved. The default
+/// LiteralEncoder::process corresponds to 2 interleaved states.
+inline constexpr bool isValidNInterleavedStreams(size_t nStreams) noexcept
+{
+  return nStreams == 2 || nStreams == 4 || nStreams == 8 || nStreams == 16;
+}
+
 inline size_t calculateMaxBufferSize(size_t num, size_t /*rangeBits*/, size_t sizeofStreamT)
 {
   //  // RS: w/o safety margin the o2-test-ctf-io produces an overflow in the Encoder::process
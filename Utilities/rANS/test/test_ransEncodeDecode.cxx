@@ -147,6 +147,21 @@ struct EncodeDecodeLiteral : public EncodeDecodeBase<o2::rans::LiteralEncoder, o
   std::vector<typename Params<coder_T>::source_t> literals;
 };
 
+template <typename coder_T, class dictString_T, class testString_T, size_t nStreams_V>
+struct EncodeDecodeInterleaved : public EncodeDecodeBase<o2::rans::LiteralEncoder, o2::rans::LiteralDecoder, coder_T, dictString_T, testString_T> {
+  void encode() override
+  {
+    BOOST_CHECK_NO_THROW(this->encoder.template processInterleaved<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), literals));
+  };
+  void decode() override
+  {
+    BOOST_CHECK_NO_THROW(this->decoder.template processInterleaved<nStreams_V>(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size(), literals));
+    BOOST_CHECK(literals.empty());
+  };
+
+  std::vector<typename Params<coder_T>::source_t> literals;
+};
+
 template <typename coder_T, class dictString_T, class testString_T>
 struct EncodeDecodeDedup : public EncodeDecodeBase<o2::rans::DedupEncoder, o2::rans::DedupDecoder, coder_T, dictString_T, testString_T> {
   void encode() override
@@ -177,7 +192,13 @@ using testCase_t = boost::mpl::vector<EncodeDecode<uint32_t, EmptyTestString, Em
                                       EncodeDecodeDedup<uint32_t, EmptyTestString, EmptyTestString>,
                                       EncodeDecodeDedup<uint64_t, EmptyTestString, EmptyTestString>,
                                       EncodeDecodeDedup<uint32_t, FullTestString, FullTestString>,
-                                      EncodeDecodeDedup<uint64_t, FullTestString, FullTestString>>;
+                                      EncodeDecodeDedup<uint64_t, FullTestString, FullTestString>,
+                                      EncodeDecodeInterleaved<uint32_t, FullTestString, FullTestString, 4>,
+                                      EncodeDecodeInterleaved<uint32_t, FullTestString, FullTestString, 8>,
+                                      EncodeDecodeInterleaved<uint64_t, FullTestString, FullTestString, 4>,
+                                      EncodeDecodeInterleaved<uint64_t, FullTestString, FullTestString, 8>,
+                                      EncodeDecodeInterleaved<uint64_t, FullTestString, FullTestString, 16>,
+                                      EncodeDecodeInterleaved<uint64_t, EmptyTestString, FullTestString, 8>>;
 
 BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, testCase_T, testCase_t)
 {
@@ -185,4 +206,19 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, testCase_T, testCase_t)
   testCase.encode();
   testCase.decode();
   testCase.check();
-};
\ No newline at end of file
+};
+BOOST_AUTO_TEST_CASE(test_interleavedCompatibility)
+{
+  // 2 interleaved streams must reproduce the default encoder bit by bit
+  FullTestString source;
+  const std::string& s = source.data;
+  const auto frequencyTable = o2::rans::renorm(o2::rans::makeFrequencyTableFromSamples(std::begin(s), std::end(s)), 16);
+  const o2::rans::LiteralEncoder64<char> encoder{frequencyTable};
+
+  std::vector<uint32_t> encodeBuffer, interleavedBuffer;
+  std::vector<char> literals, interleavedLiterals;
+  encoder.process(std::begin(s), std::end(s), std::back_inserter(encodeBuffer), literals);
+  encoder.processInterleaved<2>(std::begin(s), std::end(s), std::back_inserter(interleavedBuffer), interleavedLiterals);
+  BOOST_CHECK_EQUAL_COLLECTIONS(encodeBuffer.begin(), encodeBuffer.end(), interleavedBuffer.begin(), interleavedBuffer.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(literals.begin(), literals.end(), interleavedLiterals.begin(), interleavedLiterals.end());
+};
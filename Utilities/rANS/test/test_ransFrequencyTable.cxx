@@ -364,6 +364,45 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_addSamples, samples_T, samples_t)
   BOOST_CHECK_EQUAL_COLLECTIONS(std::begin(fA), std::end(fA), std::begin(s.histAandB), std::end(s.histAandB));
 }
 
+BOOST_AUTO_TEST_CASE(test_addSamplesHistogramModes)
+{
+  // long message w.r.t. the alphabet range (sub-histograms), wide alphabet range (sparse counting) and out of range samples
+  std::vector<int32_t> dense(10000), sparse(100);
+  for (size_t i = 0; i < dense.size(); i++) {
+    dense[i] = int32_t(i % 7) - 3;
+  }
+  for (size_t i = 0; i < sparse.size(); i++) {
+    sparse[i] = int32_t(i % 10) * (1 << 21) - (1 << 22);
+  }
+
+  const auto [min, max] = o2::rans::computeMinMax(dense.begin(), dense.end());
+  BOOST_CHECK_EQUAL(min, -3);
+  BOOST_CHECK_EQUAL(max, 3);
+
+  o2::rans::FrequencyTable fDense;
+  fDense.addSamples(dense.begin(), dense.end(), min, max);
+  BOOST_CHECK_EQUAL(fDense.size(), 7);
+  BOOST_CHECK_EQUAL(fDense.getNumSamples(), dense.size());
+  for (int32_t symbol = min; symbol <= max; symbol++) {
+    BOOST_CHECK_EQUAL(fDense[symbol], std::count(dense.begin(), dense.end(), symbol));
+  }
+
+  o2::rans::FrequencyTable fSparse;
+  fSparse.addSamples(sparse.begin(), sparse.end());
+  BOOST_CHECK_EQUAL(fSparse.getMinSymbol(), -(1 << 22));
+  BOOST_CHECK_EQUAL(fSparse.getMaxSymbol(), 9 * (1 << 21) - (1 << 22));
+  BOOST_CHECK_EQUAL(fSparse.getNumSamples(), sparse.size());
+  BOOST_CHECK_EQUAL(fSparse.getNUsedAlphabetSymbols(), 10);
+  BOOST_CHECK_EQUAL(fSparse[0], 10);
+
+  o2::rans::FrequencyTable fRange{-1, 1};
+  fRange.addSamples(dense.begin(), dense.end(), false);
+  BOOST_CHECK_EQUAL(fRange.size(), 3);
+  BOOST_CHECK_EQUAL(fRange.getNumSamples(), dense.size());
+  BOOST_CHECK_EQUAL(fRange.getIncompressibleSymbolFrequency(), std::count_if(dense.begin(), dense.end(), [](int32_t s) { return s < -1 || s > 1; }));
+  BOOST_CHECK_EQUAL(fRange[0], std::count(dense.begin(), dense.end(), 0));
+}
+
 BOOST_AUTO_TEST_CASE(test_renorm)
 {
   o2::rans::histogram_t frequencies{1, 1, 2, 2, 2, 2, 6, 8, 4, 10, 8, 14, 10, 19, 26, 30, 31, 35, 41, 45, 51, 44, 47, 39, 58, 52, 42, 53, 50, 34, 50, 30, 32, 24, 30, 20, 17, 12, 16, 6, 8, 5, 6, 4, 4, 2, 2, 2, 1};